@@ -15,5 +15,6 @@
 #include "lemlib/pose.hpp"
 #include "lemlib/chassis/trackingWheel.hpp"
 #include "lemlib/chassis/chassis.hpp"
+#include "lemlib/inputManager.hpp"
 
 #include "lemlib/logger/logger.hpp"
\ No newline at end of file
@@ -0,0 +1,143 @@
+/**
+ * @file include/lemlib/autotune.hpp
+ * @author LemLib Team
+ * @brief Relay feedback experiments, and PID gains from their results
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+namespace lemlib {
+/**
+ * @brief How to turn the ultimate gain and period of a relay experiment into PID gains
+ *
+ */
+enum class TuningRule {
+    /** @brief the classic Ziegler-Nichols rule. Fast, but overshoots by a lot */
+    ZIEGLER_NICHOLS,
+    /** @brief Tyreus-Luyben, which gives up some speed for much less overshoot */
+    TYREUS_LUYBEN,
+    /** @brief Astrom-Hagglund, placing the ultimate frequency at a 45 degree phase margin */
+    ASTROM_HAGGLUND
+};
+
+/**
+ * @brief Gains of a PID controller, in the units of the PID class: per update, not per second
+ *
+ */
+struct PIDGains {
+        float kP = 0;
+        float kI = 0;
+        float kD = 0;
+};
+
+/**
+ * @brief Settings for Chassis::autotuneLateral and Chassis::autotuneAngular
+ *
+ * @param relayPower motor power the relay switches between. It has to be enough to overcome friction
+ * @param hysteresis how far the error has to cross zero before the relay switches, in inches or degrees. Keeps
+ * sensor noise from switching it back and forth
+ * @param cycles oscillations to average the result over, after the first one, which is still settling
+ * @param timeout longest the experiment can take, in milliseconds
+ * @param rule how to turn the results into gains
+ * @param testDistance how far the step that checks the new gains moves, in inches or degrees. 0 skips it
+ */
+struct AutotuneSettings {
+        float relayPower = 40;
+        float hysteresis = 1;
+        int cycles = 4;
+        int timeout = 8000;
+        TuningRule rule = TuningRule::ASTROM_HAGGLUND;
+        float testDistance = 0;
+};
+
+/**
+ * @brief What an autotuner found
+ *
+ */
+struct AutotuneResult {
+        /** @brief whether the relay oscillated for long enough to find the gains */
+        bool success = false;
+        /** @brief gain at which the loop oscillates, in motor power per inch or per degree */
+        float ultimateGain = 0;
+        /** @brief period of that oscillation, in seconds */
+        float ultimatePeriod = 0;
+        PIDGains gains;
+        /** @brief time the test step took to stay within the small error range, in milliseconds. -1 if it didn't */
+        float settleTime = -1;
+        /** @brief how far the test step went past its target, in inches or degrees */
+        float overshoot = 0;
+};
+
+/**
+ * @brief Find PID gains from the ultimate gain and period of a loop
+ *
+ * @param ultimateGain gain at which the loop oscillates
+ * @param ultimatePeriod period of the oscillation, in seconds
+ * @param rule the tuning rule
+ * @param dt time between updates of the PID, in seconds
+ * @return PIDGains
+ */
+PIDGains tunePID(float ultimateGain, float ultimatePeriod, TuningRule rule, float dt);
+
+/**
+ * @brief A relay feedback experiment
+ *
+ * A relay drives the loop with full positive output whenever the error is positive, and full negative output
+ * whenever it is negative. Most loops settle into a steady oscillation under it, at the frequency where the loop lags
+ * half a turn behind. That is the ultimate period, and the amplitude of the oscillation gives the gain at which a
+ * proportional controller would oscillate there too, which is all the tuning rules need. Unlike raising kP until the
+ * robot oscillates, the relay keeps the oscillation small and bounded.
+ */
+class RelayExperiment {
+    public:
+        /**
+         * @brief Start an experiment
+         *
+         * @param amplitude output of the relay
+         * @param hysteresis how far the error has to cross zero before the relay switches
+         */
+        RelayExperiment(float amplitude, float hysteresis);
+        /**
+         * @brief Feed the experiment the latest error, and get the output of the relay
+         *
+         * @param error setpoint minus measurement
+         * @param time time of the measurement, in seconds
+         * @return float the output
+         */
+        float update(float error, float time);
+        /**
+         * @brief Get the number of complete oscillations, not counting the first one
+         *
+         * @return int
+         */
+        int getCycles() const;
+        /**
+         * @brief Get the ultimate gain, from the average amplitude of the oscillations
+         *
+         * @return float 0 before there are any
+         */
+        float getUltimateGain() const;
+        /**
+         * @brief Get the ultimate period, the average period of the oscillations
+         *
+         * @return float in seconds. 0 before there are any
+         */
+        float getUltimatePeriod() const;
+    private:
+        const float amplitude;
+        const float hysteresis;
+        float output;
+        /** @brief times the relay switched positive, which start each oscillation */
+        int rises = 0;
+        float cycleStart = 0;
+        float cycleMax = 0;
+        float cycleMin = 0;
+        float periodSum = 0;
+        float amplitudeSum = 0;
+};
+} // namespace lemlib
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <array>
 #include <functional>
 #include "pros/rtos.hpp"
 #include "pros/motors.hpp"
@@ -19,9 +20,24 @@
 #include "lemlib/chassis/trackingWheel.hpp"
 #include "lemlib/pose.hpp"
 #include "lemlib/pid.hpp"
+#include "lemlib/motionProfile.hpp"
+#include "lemlib/trajectory.hpp"
+#include "lemlib/sysId.hpp"
+#include "lemlib/autotune.hpp"
+#include "lemlib/snapshot.hpp"
 #include "lemlib/exitcondition.hpp"
+#include "lemlib/stallDetector.hpp"
+#include "lemlib/gainSchedule.hpp"
+#include "lemlib/driveCurve.hpp"
+#include "lemlib/pipeline.hpp"
 
 namespace lemlib {
+/**
+ * @brief Which way along the IMU's axes the front of the robot points. The IMU has to be mounted flat
+ *
+ */
+enum class ImuAxis { X, Y, NEGATIVE_X, NEGATIVE_Y };
+
 /**
  * @brief Struct containing all the sensors used for odometry
  *
@@ -37,14 +53,16 @@ struct OdomSensors {
          * @param horizontal1 pointer to the first horizontal tracking wheel
          * @param horizontal2 pointer to the second horizontal tracking wheel
          * @param imu pointer to the IMU
+         * @param imuForward axis of the IMU that points to the front of the robot. Y by default
          */
         OdomSensors(TrackingWheel* vertical1, TrackingWheel* vertical2, TrackingWheel* horizontal1,
-                    TrackingWheel* horizontal2, pros::Imu* imu);
+                    TrackingWheel* horizontal2, pros::Imu* imu, ImuAxis imuForward = ImuAxis::Y);
         TrackingWheel* vertical1;
         TrackingWheel* vertical2;
         TrackingWheel* horizontal1;
         TrackingWheel* horizontal2;
         pros::Imu* imu;
+        ImuAxis imuForward;
 };
 
 /**
@@ -65,9 +83,15 @@ struct ControllerSettings {
          * @param largeError the error at which the chassis controller will switch to a faster control loop
          * @param largeErrorTimeout the time the chassis controller will wait before switching to a faster control loop
          * @param slew the maximum acceleration of the chassis controller
+         * @param kV velocity feedforward, output per unit of velocity the motion profile asks for. 0 by default
+         * @param kA acceleration feedforward, output per unit of acceleration the motion profile asks for. 0 by
+         * default
+         * @param kS static feedforward, the output it takes to overcome friction and start moving. It is added in the
+         * direction of motion. 0 by default
          */
         ControllerSettings(float kP, float kI, float kD, float windupRange, float smallError, float smallErrorTimeout,
-                           float largeError, float largeErrorTimeout, float slew)
+                           float largeError, float largeErrorTimeout, float slew, float kV = 0, float kA = 0,
+                           float kS = 0)
             : kP(kP),
               kI(kI),
               kD(kD),
@@ -76,7 +100,10 @@ struct ControllerSettings {
               smallErrorTimeout(smallErrorTimeout),
               largeError(largeError),
               largeErrorTimeout(largeErrorTimeout),
-              slew(slew) {}
+              slew(slew),
+              kV(kV),
+              kA(kA),
+              kS(kS) {}
 
         float kP;
         float kI;
@@ -87,6 +114,9 @@ struct ControllerSettings {
         float largeError;
         float largeErrorTimeout;
         float slew;
+        float kV;
+        float kA;
+        float kS;
 };
 
 /**
@@ -145,6 +175,79 @@ struct MoveToPoseParams {
         float earlyExitRange = 0;
 };
 
+/**
+ * @brief How Chassis::follow drives along a path
+ *
+ */
+enum class PathFollower {
+    /** @brief steer towards a point a lookahead distance further along the path */
+    PURE_PURSUIT,
+    /** @brief track the planned trajectory in time with a RAMSETE controller. Needs Chassis::setPathConstraints */
+    RAMSETE
+};
+
+/**
+ * @brief Gains of the RAMSETE controller
+ *
+ * The usual values of b = 2 and zeta = 0.7 are for meters. b scales with 1 / length^2, so it is much smaller in
+ * inches
+ *
+ * @param b how aggressively to correct position errors, in rad^2 / in^2. Larger values converge faster
+ * @param zeta damping, between 0 and 1. Larger values correct more smoothly
+ * @param kP motor power per inch per second of error between the velocity a wheel should have and the velocity it
+ * has, which makes up for what the kV and kA feedforward miss
+ */
+struct RamseteSettings {
+        float b = 0.0013;
+        float zeta = 0.7;
+        float kP = 0;
+};
+
+/**
+ * @brief How moveToPose and moveToPoint chain into the next motion in the queue
+ *
+ * If the running motion and the next one in the queue are both moveToPose or moveToPoint in the same direction,
+ * the running motion looks ahead to the next target. It plans its profile to end at the speed the corner
+ * between them allows and bends its carrot towards the next target. Once it is within exitDistance of its own target
+ * it hands over without stopping, and the next motion starts its profile at that speed. Calling waitUntilDone before
+ * the next motion still stops at the target. Needs the lateral profile, whose max acceleration also limits how fast
+ * the robot takes the corner
+ *
+ * @param exitDistance how far before its target a motion hands over to the next one, in inches. 0 turns chaining
+ * off, which is the default
+ * @param maxTurn sharpest corner to chain through, in degrees. Motions stop before sharper ones
+ */
+struct ChainSettings {
+        float exitDistance = 0;
+        float maxTurn = 90;
+};
+
+/**
+ * @brief Everything about the chassis that other tasks commonly poll, captured at one instant
+ *
+ * Poses are in inches and radians, speeds in inches and radians per second. Theta uses the LemLib convention
+ */
+struct ChassisState {
+        /** @brief time the state was captured, in ms */
+        uint32_t time = 0;
+        Pose pose = Pose(0, 0, 0);
+        /** @brief speed in field coordinates */
+        Pose speed = Pose(0, 0, 0);
+        /** @brief speed relative to the robot, y forwards */
+        Pose localSpeed = Pose(0, 0, 0);
+        /** @brief forward speed from the IMU, which doesn't slip against a wall like the wheels. See getGroundSpeed */
+        float groundSpeed = 0;
+        bool inMotion = false;
+        /** @brief id of the running motion, 0 if none is. Motions are numbered from 1 in the order they are queued */
+        uint32_t motionId = 0;
+        /** @brief how many motions stall detection has ended so far */
+        uint32_t stalls = 0;
+        /** @brief how much time settle detection has saved motions so far, in ms */
+        uint32_t settleSaved = 0;
+        /** @brief distance travelled by the current motion, -1 once it has finished */
+        float distTravelled = -1;
+};
+
 /**
  * @brief Function pointer type for drive curve functions.
  * @param input The control input in the range [-127, 127].
@@ -210,9 +313,21 @@ class Chassis {
          * @return Pose
          */
         Pose getPose(bool radians = false, bool standardPos = false);
+        /**
+         * @brief Get the pose, speed and motion status of the chassis, all from the same odometry update
+         *
+         * Never blocks, so it's safe to call from any task as often as needed
+         *
+         * @return ChassisState
+         */
+        ChassisState getState() const;
         /**
          * @brief Wait until the robot has traveled a certain distance along the path
          *
+         * Waits on the last motion queued, which may not have started yet. Returns once it has finished, even if it
+         * never got that far. The motion wakes the calling task on the control cycle it gets there, rather than the
+         * calling task checking every so often
+         *
          * @note Units are in inches if current motion is moveTo or follow, degrees if using turnTo
          *
          * @param dist the distance the robot needs to travel before returning
@@ -221,8 +336,34 @@ class Chassis {
         /**
          * @brief Wait until the robot has completed the path
          *
+         * Waits for every motion queued so far to finish or be cancelled
          */
         void waitUntilDone();
+        /**
+         * @brief Run an action once the last motion queued has travelled a distance, without waiting for it
+         *
+         * The motion task runs the action on the control cycle the robot gets there, so keep it short, like setting
+         * a piston or a motor. If the motion finishes before it gets that far, the action runs
+         * when it finishes. It doesn't run if the motion is cancelled.
+         *
+         * @note Units are in inches if the motion is moveTo or follow, degrees if it is turnTo
+         *
+         * @param dist the distance
+         * @param action the action
+         * @return false if there is no motion to attach it to, or too many actions are waiting already
+         */
+        bool atDistance(float dist, std::function<void()> action);
+        /**
+         * @brief Run an action once the last motion queued is some way through, without waiting for it
+         *
+         * Works like atDistance, with the distance a percentage of how far the motion expects to travel when it
+         * starts
+         *
+         * @param percent how far through the motion, from 0 to 100
+         * @param action the action
+         * @return false if there is no motion to attach it to, or too many actions are waiting already
+         */
+        bool atProgress(float percent, std::function<void()> action);
         /**
          * @brief Turn the chassis so it is facing the target point
          *
@@ -237,6 +378,56 @@ class Chassis {
          * @param async whether the function should be run asynchronously. true by default
          */
         void turnTo(float x, float y, int timeout, bool forwards = true, float maxSpeed = 127, bool async = true);
+        /**
+         * @brief Limit the lateral motion of moveToPoint and moveToPose with a motion profile
+         *
+         * Each motion plans a profile from the distance to the target, drives the lateral velocity and acceleration
+         * it asks for through the kV and kA feedforward of the lateral settings, and uses the lateral PID to correct
+         * for falling behind or getting ahead of it. Once the profile ends the PID settles the robot as usual. The
+         * maxSpeed of a motion lowers the profile's max velocity to maxSpeed / kV
+         *
+         * @param constraints limits in inches and seconds. A max velocity of 0 turns profiling off, which is the
+         * default
+         */
+        void setLateralProfile(ProfileConstraints constraints);
+        /**
+         * @brief Chain moveToPose and moveToPoint into the next motion in the queue, carrying speed through the
+         * corner between them instead of stopping
+         *
+         * @param settings how to chain. An exit distance of 0 turns chaining off, which is the default
+         */
+        void setChainSettings(ChainSettings settings);
+        /**
+         * @brief End moveToPose, moveToPoint and follow early once the robot is stuck against something, instead of
+         * pushing until the timeout
+         *
+         * @param settings how to detect a stall. A time of 0 turns stall detection off, which is the default
+         */
+        void setStallSettings(StallSettings settings);
+        /**
+         * @brief End turns and moves as soon as the robot has stopped within the small error, instead of waiting out
+         * the exit countdowns in the controller settings
+         *
+         * @param lateral settle settings for moveToPoint and moveToPose, in inches
+         * @param angular settle settings for turnTo and moveToPose, in degrees
+         */
+        void setSettleSettings(SettleSettings lateral, SettleSettings angular);
+        /**
+         * @brief Set how the lateral and angular PIDs handle the time between updates: derivative filtering,
+         * derivative on measurement and output limits
+         *
+         * @param lateral settings for the lateral PID. Its measurement is how far the robot has driven forwards
+         * @param angular settings for the angular PID. Its measurement is the heading
+         */
+        void setPIDSettings(PIDSettings lateral, PIDSettings angular);
+        /**
+         * @brief Look the gains and static feedforward of the lateral and angular PIDs up from gain schedules every
+         * update, instead of using the ones in the controller settings
+         *
+         * @param lateral schedule for the lateral PID, in inches. An empty schedule goes back to the settings
+         * @param angular schedule for the angular PID, in degrees. An empty schedule goes back to the settings
+         */
+        void setGainSchedules(GainSchedule lateral, GainSchedule angular);
         /**
          * @brief Move the chassis towards the target pose
          *
@@ -260,6 +451,81 @@ class Chassis {
          * @param async whether the function should be run asynchronously. true by default
          */
         void moveToPoint(float x, float y, int timeout, bool forwards = true, float maxSpeed = 127, bool async = true);
+        /**
+         * @brief Plan the speed of follow from the drivetrain instead of the velocities in the path file
+         *
+         * Each call to follow plans a trajectory along the path before the robot moves, as fast as the constraints
+         * allow, and drives the velocity and acceleration it asks for through the kV and kA feedforward of the
+         * lateral settings. Without kV, 127 is taken to be the free speed of the drivetrain
+         *
+         * @param constraints limits in inches and seconds. A max acceleration of 0 turns planning off, which is the
+         * default
+         */
+        void setPathConstraints(TrajectoryConstraints constraints);
+        /**
+         * @brief Set the gains follow uses for RAMSETE
+         *
+         * @param settings the gains
+         */
+        void setRamseteSettings(RamseteSettings settings);
+        /**
+         * @brief Set the gains of the lateral PID, in place of the ones in its ControllerSettings and its gain schedule
+         *
+         * Don't call this while a motion is running
+         *
+         * @param gains the gains
+         */
+        void setLateralGains(PIDGains gains);
+        /**
+         * @brief Set the gains of the angular PID, in place of the ones in its ControllerSettings and its gain schedule
+         *
+         * Don't call this while a motion is running
+         *
+         * @param gains the gains
+         */
+        void setAngularGains(PIDGains gains);
+        /**
+         * @brief Save the lateral and angular PID gains, so a later run can load them without a recompile
+         *
+         * The file is text, one line per controller: its name, then kP, kI and kD
+         *
+         * @param path the file. Files on the SD card start with /usd/
+         * @return true if the gains were saved
+         */
+        bool saveGains(const char* path) const;
+        /**
+         * @brief Load gains saved with saveGains
+         *
+         * Call this in initialize. If there is no file, for example because there is no SD card, the gains in the
+         * ControllerSettings stay
+         *
+         * @param path the file. Files on the SD card start with /usd/
+         * @return true if both controllers were loaded
+         */
+        bool loadGains(const char* path);
+        /**
+         * @brief Tune the lateral PID with a relay feedback experiment, driving forwards and backwards
+         *
+         * The relay drives the robot back and forth about where it started, holding its heading with the angular
+         * PID, so tune the angular PID first. If the experiment works, the new gains are set, and if the settings
+         * have a test distance, the robot then drives that far to measure them. This function blocks until it is
+         * done.
+         *
+         * @param settings how to run the experiment
+         * @return AutotuneResult
+         */
+        AutotuneResult autotuneLateral(AutotuneSettings settings = {});
+        /**
+         * @brief Tune the angular PID with a relay feedback experiment, turning in place
+         *
+         * The relay turns the robot back and forth about the heading it started at. If the experiment works, the new
+         * gains are set, and if the settings have a test distance, the robot then turns that many degrees to measure
+         * them. This function blocks until it is done.
+         *
+         * @param settings how to run the experiment
+         * @return AutotuneResult
+         */
+        AutotuneResult autotuneAngular(AutotuneSettings settings = {});
         /**
          * @brief Move the chassis along a path
          *
@@ -269,8 +535,32 @@ class Chassis {
          * @param timeout the maximum time the robot can spend moving
          * @param forwards whether the robot should follow the path going forwards. true by default
          * @param async whether the function should be run asynchronously. true by default
+         * @param follower how to drive along the path. Pure pursuit by default. RAMSETE ignores the lookahead, and
+         * falls back to pure pursuit if the path can't be planned
+         */
+        void follow(const asset& path, float lookahead, int timeout, bool forwards = true, bool async = true,
+                    PathFollower follower = PathFollower::PURE_PURSUIT);
+        /**
+         * @brief Characterize the drivetrain, and save what the motors measured for fitting feedforward constants
+         *
+         * Runs each SysIdTest in order, driving the motors with raw voltages and recording their voltage, velocity
+         * and current every time they take a sample. The samples are kept in memory and saved once the tests are
+         * done, so the SD card doesn't slow down the tests. Fit the log on a computer with the sysid-fit tool of the
+         * simulator, or on the brain with fitLinear and fitAngular. This function blocks until the tests are done.
+         *
+         * @param path where to save the log. Files on the SD card start with /usd/
+         * @param settings how to run the tests
+         * @return true if the tests finished and the log was saved
+         */
+        bool characterize(const char* path, SysIdSettings settings = {});
+        /**
+         * @brief Drive tank, arcade and curvature through a drive curve table, instead of the drive curve function
+         *
+         * The table has its own curve baked in, so their curveGain is ignored
+         *
+         * @param table the table, which has to outlive the chassis, like a constexpr one at namespace scope
          */
-        void follow(const asset& path, float lookahead, int timeout, bool forwards = true, bool async = true);
+        void setDriveCurve(const DriveCurveTable& table);
         /**
          * @brief Control the robot during the driver control period using the tank drive control scheme. In
          * this control scheme one joystick axis controls one half of the robot, and another joystick axis
@@ -314,30 +604,316 @@ class Chassis {
          */
         void cancelAllMotions();
         /**
-         * @return whether a motion is currently running
+         * @return whether a motion is currently running or queued
          */
         bool isInMotion() const;
     protected:
         /**
-         * @brief Indicates that this motion is queued and blocks current task until this motion reaches front of queue
+         * @brief Start a motion that runs in the calling task instead of the motion task
+         *
+         * Waits for the queued motions to finish, then keeps the motion task from starting any more until endMotion.
+         * For motions that block and return a result, like characterize
          */
-        void requestMotionStart();
+        void beginMotion();
         /**
-         * @brief Dequeues this motion and permits queued task to run
+         * @brief Finish a motion started with beginMotion, and let the motion task carry on with the queue
          */
         void endMotion();
+        /**
+         * @brief Capture the current state for readers of getState()
+         */
+        void publishState();
     private:
+        /** @brief most motions that can wait in the queue. Queueing another waits for room */
+        static constexpr std::size_t MOTION_QUEUE_SIZE = 16;
+        /** @brief most tasks that can wait on motions at once. Any more poll instead */
+        static constexpr std::size_t MAX_MOTION_WAITERS = 4;
+        /** @brief most actions that can wait on motions at once */
+        static constexpr std::size_t MAX_MOTION_ACTIONS = 16;
+
+        enum class MotionType { TURN_TO, MOVE_TO_POINT, MOVE_TO_POSE, FOLLOW };
+        /**
+         * @brief A motion waiting in the queue, with the arguments it was called with
+         *
+         */
+        struct MotionCommand {
+                MotionType type = MotionType::TURN_TO;
+                uint32_t id = 0;
+                float x = 0;
+                float y = 0;
+                /** @brief target heading of moveToPose, in degrees */
+                float theta = 0;
+                int timeout = 0;
+                bool forwards = true;
+                float maxSpeed = 127;
+                MoveToPoseParams params;
+                /** @brief path of follow. The asset has to outlive the motion */
+                const asset* path = nullptr;
+                float lookahead = 0;
+                PathFollower follower = PathFollower::PURE_PURSUIT;
+        };
+
+        /**
+         * @brief Add a motion to the back of the queue, for the motion task to run
+         *
+         * @param command the motion
+         * @param async false to wait for the motion to finish
+         */
+        void queueMotion(MotionCommand command, bool async);
+        /**
+         * @brief Start the task that runs the motions, if it isn't running yet. The mutex has to be held
+         *
+         */
+        void startMotionTask();
+        /**
+         * @brief Body of the motion task, which runs the queued motions one at a time
+         *
+         */
+        void runMotions();
+        /**
+         * @brief Block the calling task until a motion has finished or been cancelled, woken by task notifications
+         *
+         * @param id the motion
+         */
+        void waitForMotion(uint32_t id);
+        /**
+         * @brief Wake the tasks waiting in waitForMotion or for room in the queue, so they check again
+         *
+         */
+        void notifyWaiters();
+        /**
+         * @brief Give the mutex back until notifyWaiters is called, then take it again. Call with the mutex held
+         *
+         * Registers the calling task before giving the mutex back, so it can't miss the notification. Polls if too
+         * many tasks are waiting already
+         *
+         * @param id also wake once this motion has travelled further than distance. 0 for only notifyWaiters
+         * @param distance the distance, in the units of distTravelled
+         */
+        void sleepUntilNotified(uint32_t id = 0, float distance = 0);
+        /**
+         * @brief Wake the tasks waiting for the running motion to travel as far as it has. Called by the motions
+         * every time they update distTravelled
+         *
+         */
+        void notifyProgress();
+        /**
+         * @brief Attach an action to the last motion queued
+         *
+         * @param at distance at which to run it, or percentage of the motion if progress is true
+         * @param progress whether at is a percentage
+         * @param action the action
+         * @return false if there is no motion to attach it to, or too many actions are waiting already
+         */
+        bool addAction(float at, bool progress, std::function<void()> action);
+        /**
+         * @brief Take the actions left on a motion once it has ended, and run them unless it was cancelled
+         *
+         * @param id the motion
+         * @param run whether to run them
+         */
+        void finishActions(uint32_t id, bool run);
+        /**
+         * @return whether a motion is waiting in the queue
+         */
+        bool hasQueuedMotion() const;
+        /**
+         * @brief Run a turnTo motion, in the motion task
+         *
+         * @param x x location
+         * @param y y location
+         * @param timeout longest time the robot can spend moving
+         * @param forwards whether the robot should turn to face the point with the front of the robot
+         * @param maxSpeed the maximum speed the robot can turn at
+         */
+        void runTurnTo(float x, float y, int timeout, bool forwards, float maxSpeed);
+        /**
+         * @brief Run a moveToPoint motion, in the motion task
+         *
+         * @param x x location
+         * @param y y location
+         * @param timeout longest time the robot can spend moving
+         * @param forwards whether the robot should move forwards or backwards
+         * @param maxSpeed the maximum speed the robot can move at
+         */
+        void runMoveToPoint(float x, float y, int timeout, bool forwards, float maxSpeed);
+        /**
+         * @brief Run a moveToPose motion, in the motion task
+         *
+         * @param x x location
+         * @param y y location
+         * @param theta target heading in degrees.
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         */
+        void runMoveToPose(float x, float y, float theta, int timeout, MoveToPoseParams params);
+        /**
+         * @brief Run a follow motion, in the motion task
+         *
+         * @param path the path asset to follow
+         * @param lookahead the lookahead distance. Units in inches
+         * @param timeout the maximum time the robot can spend moving
+         * @param forwards whether the robot should follow the path going forwards
+         * @param follower how to drive along the path
+         */
+        void runFollow(const asset& path, float lookahead, int timeout, bool forwards, PathFollower follower);
+        /**
+         * @brief Track a planned trajectory in time with RAMSETE, for follow
+         *
+         * Runs the rest of the follow motion
+         *
+         * @param trajectory the trajectory
+         * @param timeout the maximum time the robot can spend moving
+         * @param forwards whether the robot should follow the path going forwards
+         * @param kV motor power per inch per second
+         */
+        void ramsete(const Trajectory& trajectory, int timeout, bool forwards, float kV);
+        /**
+         * @brief Drive each side of the drivetrain at a voltage, made up for the battery sagging
+         *
+         * Motions output power out of 127 of the nominal 12 V. The motors apply that share of whatever the battery
+         * has, so the voltage is scaled by 12 V over the battery voltage, and the gains work the same on a full
+         * battery as on a flat one.
+         *
+         * @param leftPower power of the left side, from -127 to 127
+         * @param rightPower power of the right side, from -127 to 127
+         */
+        void moveVoltage(float leftPower, float rightPower);
+        /**
+         * @brief Drive each side of the drivetrain at a power from a driver control scheme, through the drive curve
+         *
+         * @param leftPower power of the left side, before the drive curve
+         * @param rightPower power of the right side, before the drive curve
+         * @param curveGain the scale inputted into the drive curve function
+         */
+        void driveSides(float leftPower, float rightPower, float curveGain);
+        /**
+         * @brief How a motion chains into the next one in the queue
+         *
+         */
+        struct ChainPlan {
+                bool chain = false;
+                /** @brief speed to hand over at, in inches per second */
+                float exitVelocity = 0;
+                /** @brief direction the next motion heads off in, in radians in standard form */
+                float direction = 0;
+        };
+        /**
+         * @brief Look ahead to the next motion in the queue, to see if the running motion can chain into it
+         *
+         * @param target target of the running motion in standard form, with theta the direction of travel at it
+         * @param forwards whether the running motion drives forwards
+         * @return ChainPlan
+         */
+        ChainPlan planChain(const Pose& target, bool forwards);
+        /**
+         * @brief Update a motion's stall detector from the drivetrain motors and the IMU
+         *
+         * @param detector the motion's stall detector
+         * @return true if the robot has stalled, and the motion should end
+         */
+        bool checkStall(StallDetector& detector);
+        /**
+         * @brief Count how much sooner settle detection ended a motion than the exit countdowns would have
+         *
+         * @param countdownEnd when the countdowns would have ended the motion, in ms. -1 if they wouldn't have
+         */
+        void recordSettle(int countdownEnd);
+        /**
+         * @brief Set the gains of the PIDs from the gain schedules, if there are any, for this update
+         *
+         * @param lateralError error of the lateral PID, in inches
+         * @param angularError error of the angular PID, in degrees
+         */
+        void scheduleGains(float lateralError, float angularError);
+
+        /** @brief false once the running motion has been cancelled */
         bool motionRunning = false;
-        bool motionQueued = false;
+        /** @brief speed the last motion handed over to the next one at, in inches per second. 0 if it stopped */
+        float chainVelocity = 0;
+
+        /** @brief ring buffer of the motions waiting to run */
+        std::array<MotionCommand, MOTION_QUEUE_SIZE> motionQueue;
+        std::size_t queueHead = 0;
+        std::size_t queueSize = 0;
+        /** @brief id of the last motion queued */
+        uint32_t lastQueuedId = 0;
+        /** @brief every motion with an id up to this one has finished or been cancelled */
+        uint32_t lastDoneId = 0;
+        /** @brief id of the running motion, 0 if none is */
+        uint32_t runningId = 0;
+        /** @brief cancelAllMotions dropped every motion up to this one from the queue */
+        uint32_t droppedId = 0;
+        /**
+         * @brief A task blocked in sleepUntilNotified
+         *
+         */
+        struct MotionWaiter {
+                pros::task_t task = nullptr;
+                /** @brief motion whose progress it waits on, 0 if none */
+                uint32_t id = 0;
+                float distance = 0;
+        };
 
+        std::array<MotionWaiter, MAX_MOTION_WAITERS> waiters {};
+        pros::Task* motionTask = nullptr;
+        /** @brief guards the queue, the ids, the waiters and the actions */
         pros::Mutex mutex;
         float distTravelled = 0;
+        /** @brief how far the running motion expects to travel, for atProgress. 0 if it doesn't know */
+        float motionLength = 0;
+
+        /**
+         * @brief An action waiting for a motion to get far enough
+         *
+         */
+        struct MotionAction {
+                uint32_t id = 0;
+                /** @brief distance, or percentage of the motion if progress is true */
+                float at = 0;
+                bool progress = false;
+                /** @brief empty once it has run */
+                std::function<void()> action;
+        };
+
+        std::array<MotionAction, MAX_MOTION_ACTIONS> motionActions;
+
+        Snapshot<ChassisState> state;
+        /** @brief held while publishing the state, since the tracking task and setPose can both publish */
+        pros::Mutex stateMutex;
 
         ControllerSettings lateralSettings;
         ControllerSettings angularSettings;
+        ProfileConstraints lateralProfile;
+        ChainSettings chainSettings;
+        StallSettings stallSettings;
+        /** @brief how many motions stall detection has ended so far */
+        uint32_t stalls = 0;
+        /** @brief how much time settle detection has saved motions so far, in ms */
+        uint32_t settleSaved = 0;
+        GainSchedule lateralSchedule;
+        GainSchedule angularSchedule;
+        /** @brief static feedforward for this update, from the gain schedules or the settings */
+        float lateralKS = 0;
+        float angularKS = 0;
+        /** @brief power moveVoltage last drove each side with */
+        float leftPower = 0;
+        float rightPower = 0;
+        TrajectoryConstraints pathConstraints;
+        RamseteSettings ramseteSettings;
         Drivetrain drivetrain;
         OdomSensors sensors;
         DriveCurveFunction_t driveCurve;
+        /** @brief whether driveCurve is defaultDriveCurve, which driver control then bakes into defaultCurveTable */
+        bool defaultCurve;
+        /** @brief table from setDriveCurve, which driver control uses in place of driveCurve */
+        const DriveCurveTable* curveTable = nullptr;
+        /** @brief defaultDriveCurve baked at the gain driver control last asked for */
+        DriveCurveTable defaultCurveTable;
+        float defaultCurveGain = 0;
+        ControlPipeline<CurveLookup, Passthrough, NoLimit, PowerOutput> drivePipeline;
+        MotorPorts leftPorts;
+        MotorPorts rightPorts;
 
         PID lateralPID;
         PID angularPID;
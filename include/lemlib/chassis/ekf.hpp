@@ -0,0 +1,147 @@
+/**
+ * @file include/lemlib/chassis/ekf.hpp
+ * @author LemLib Team
+ * @brief Extended Kalman filter for estimating the pose of a differential drive
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include "lemlib/matrix.hpp"
+#include "lemlib/pose.hpp"
+
+namespace lemlib {
+/**
+ * @brief Tuning for the pose estimator
+ *
+ * Noises are standard deviations. The defaults suit a 15" robot on foam tiles
+ */
+struct EkfSettings {
+        /** @brief unpredictable forward acceleration, in inches per second squared */
+        float forwardAccelNoise = 150;
+        /** @brief unpredictable sideways acceleration, from scrubbing and collisions, in inches per second squared */
+        float sidewaysAccelNoise = 20;
+        /** @brief unpredictable angular acceleration, in radians per second squared */
+        float angularAccelNoise = 15;
+        /** @brief velocity measured by an unpowered tracking wheel, in inches per second */
+        float trackingWheelNoise = 0.5;
+        /** @brief velocity measured by drive motor encoders, which slip with the wheels, in inches per second */
+        float motorEncoderNoise = 4;
+        /** @brief IMU heading, in radians */
+        float imuHeadingNoise = 0.005;
+        /** @brief IMU yaw rate, in radians per second */
+        float gyroNoise = 0.05;
+        /** @brief GPS fixes with a reported error larger than this are ignored, in inches */
+        float gpsMaxError = 2;
+};
+
+/**
+ * @brief Extended Kalman filter tracking the pose and velocity of the robot
+ *
+ * The state is x, y, theta, forward velocity, sideways velocity and angular velocity, using the LemLib conventions
+ * (inches, radians, 0 facing +y, clockwise positive). Velocities are predicted to stay constant, and every sensor is
+ * folded in one scalar measurement at a time, so no matrix ever needs inverting.
+ */
+class Ekf {
+    public:
+        /** @brief number of states */
+        static constexpr std::size_t STATES = 6;
+
+        /**
+         * @brief Construct a new Ekf at the origin, at rest
+         *
+         * @param settings the tuning
+         */
+        explicit Ekf(EkfSettings settings = EkfSettings());
+        /**
+         * @brief Get the tuning
+         *
+         * @return const EkfSettings&
+         */
+        const EkfSettings& getSettings() const;
+        /**
+         * @brief Move the estimate without changing the velocity or its uncertainty
+         *
+         * @param pose the new pose, theta in radians
+         */
+        void setPose(Pose pose);
+        /**
+         * @brief Advance the estimate in time
+         *
+         * @param dt time since the last prediction, in seconds
+         */
+        void predict(float dt);
+        /**
+         * @brief Fold in the velocity measured by a wheel
+         *
+         * @param velocity velocity of the wheel tread, in inches per second
+         * @param offset offset of the wheel from the tracking center, using the TrackingWheel convention
+         * @param horizontal whether the wheel measures sideways motion
+         * @param noise standard deviation of the measurement, in inches per second
+         */
+        void updateWheel(float velocity, float offset, bool horizontal, float noise);
+        /**
+         * @brief Fold in a heading measurement
+         *
+         * @param heading the heading, in radians. Wrapped to the nearest turn of the estimate
+         * @param noise standard deviation of the measurement, in radians
+         */
+        void updateHeading(float heading, float noise);
+        /**
+         * @brief Fold in an angular velocity measurement
+         *
+         * @param angularVelocity clockwise positive, in radians per second
+         * @param noise standard deviation of the measurement, in radians per second
+         */
+        void updateAngularVelocity(float angularVelocity, float noise);
+        /**
+         * @brief Fold in a position measurement
+         *
+         * @param x x position, in inches
+         * @param y y position, in inches
+         * @param noise standard deviation of the measurement on each axis, in inches
+         */
+        void updatePosition(float x, float y, float noise);
+        /**
+         * @brief Get the estimated pose
+         *
+         * @return Pose theta in radians
+         */
+        Pose getPose() const;
+        /**
+         * @brief Get the estimated speed in field coordinates
+         *
+         * @return Pose in inches and radians per second
+         */
+        Pose getSpeed() const;
+        /**
+         * @brief Get the estimated speed relative to the robot
+         *
+         * @return Pose x sideways, y forwards, in inches and radians per second
+         */
+        Pose getLocalSpeed() const;
+        /**
+         * @brief Get the covariance of the state
+         *
+         * @return const Matrix<STATES, STATES>&
+         */
+        const Matrix<STATES, STATES>& getCovariance() const;
+    private:
+        /**
+         * @brief Fold in a scalar measurement that depends linearly on the state
+         *
+         * @param h how the measurement depends on each state
+         * @param residual measurement minus its prediction
+         * @param noise standard deviation of the measurement
+         */
+        void correct(const Matrix<1, STATES>& h, float residual, float noise);
+
+        EkfSettings settings;
+        Matrix<STATES, 1> state;
+        Matrix<STATES, STATES> covariance;
+};
+} // namespace lemlib
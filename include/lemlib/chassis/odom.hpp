@@ -12,10 +12,35 @@
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include "pros/gps.hpp"
 #include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/ekf.hpp"
 #include "lemlib/pose.hpp"
 
 namespace lemlib {
+/**
+ * @brief Timing of the odometry loop since it started or since the stats were last reset
+ *
+ */
+struct OdomStats {
+        /** @brief time between updates the loop is scheduled for, in ms */
+        std::uint32_t period = 10;
+        /** @brief number of updates */
+        std::uint32_t updates = 0;
+        /** @brief number of updates that took longer than the period */
+        std::uint32_t overruns = 0;
+        /** @brief how late the loop woke up compared to its schedule, in microseconds */
+        std::uint32_t maxJitter = 0;
+        float meanJitter = 0;
+        /** @brief longest time a single update took, in microseconds */
+        std::uint32_t maxUpdateTime = 0;
+        /** @brief shortest and longest time between the sensor samples integrated by an update, in seconds */
+        float minDt = 0;
+        float maxDt = 0;
+};
+
 /**
  * @brief Set the sensors to be used for odometry
  *
@@ -37,6 +62,29 @@ Pose getPose(bool radians = false);
  * @param radians true if theta is in radians, false if in degrees. False by default
  */
 void setPose(Pose pose, bool radians = false);
+/**
+ * @brief Get the pose the robot was at at a given time
+ *
+ * Useful for data that took a while to arrive, like a vision detection, which should be compared against where the
+ * robot was when it was captured rather than where it is now. The last second or so of poses is kept
+ *
+ * @param time the time, in ms since the program started
+ * @param radians true for theta in radians, false for degrees. False by default
+ * @return Pose interpolated between the nearest updates. The oldest or current pose if the time is out of range
+ */
+Pose getPoseAt(std::uint32_t time, bool radians = false);
+/**
+ * @brief Correct the pose of the robot with a measurement taken in the past
+ *
+ * The difference between the measurement and the pose at the time it was taken is added to the current pose, so
+ * motion since then is kept. Corrections are applied by the odometry task on its next update. Measurements taken
+ * before the last call to setPose are dropped
+ *
+ * @param time the time the measurement was taken, in ms since the program started
+ * @param pose the measured pose
+ * @param radians true if theta is in radians, false if in degrees. False by default
+ */
+void correctPose(std::uint32_t time, Pose pose, bool radians = false);
 /**
  * @brief Get the speed of the robot
  *
@@ -51,6 +99,16 @@ Pose getSpeed(bool radians = false);
  * @return lemlib::Pose
  */
 Pose getLocalSpeed(bool radians = false);
+/**
+ * @brief Get the forward speed of the robot from the IMU's acceleration, pulled back to the wheels over a second
+ *
+ * Unlike the wheels, it drops to nothing when the robot hits a wall, however fast the wheels keep slipping. The IMU
+ * is read along OdomSensors::imuForward, less the acceleration it reads while the wheels are standing still, which
+ * is from it being tilted or biased
+ *
+ * @return float speed in inches per second. The wheels' speed without an IMU
+ */
+float getGroundSpeed();
 /**
  * @brief Estimate the pose of the robot after a certain amount of time
  *
@@ -59,6 +117,38 @@ Pose getLocalSpeed(bool radians = false);
  * @return lemlib::Pose
  */
 Pose estimatePose(float time, bool radians = false);
+/**
+ * @brief Estimate the pose with an extended Kalman filter instead of dead reckoning
+ *
+ * The filter weighs every sensor by how much it can be trusted rather than picking one per axis: tracking wheels,
+ * drive motor encoders, the IMU heading and yaw rate, and optionally a GPS, which keeps wheel slip from adding up
+ * over a long run. Call before the chassis is calibrated
+ *
+ * @param settings tuning for the filter
+ * @param gps GPS sensor to correct the position with, mounted so it reports the tracking center. nullptr if there
+ * isn't one
+ */
+void useEkf(EkfSettings settings = EkfSettings(), pros::Gps* gps = nullptr);
+/**
+ * @brief Set how often odometry updates
+ *
+ * The rotation sensors and IMU are set to sample at the same rate. Motors always sample every 10 ms, so updates
+ * between motor samples only integrate the other sensors.
+ *
+ * @param period time between updates, in ms. 5 (200 Hz) is the fastest the sensors can go. 10 by default
+ */
+void setUpdatePeriod(std::uint32_t period);
+/**
+ * @brief Get the timing of the odometry loop
+ *
+ * @return OdomStats
+ */
+OdomStats getStats();
+/**
+ * @brief Reset the timing stats of the odometry loop
+ *
+ */
+void resetStats();
 /**
  * @brief Update the pose of the robot
  *
@@ -67,6 +157,7 @@ void update();
 /**
  * @brief Initialize the odometry system
  *
+ * @param onUpdate called by the tracking task after every update. Only the first call to init sets it
  */
-void init();
+void init(std::function<void()> onUpdate = nullptr);
 } // namespace lemlib
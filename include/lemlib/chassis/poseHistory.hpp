@@ -0,0 +1,145 @@
+/**
+ * @file include/lemlib/chassis/poseHistory.hpp
+ * @author LemLib Team
+ * @brief Fixed size history of timestamped poses
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "lemlib/pose.hpp"
+
+namespace lemlib {
+/**
+ * @brief Ring buffer of the last N poses, looked up by time
+ *
+ * One task writes poses in time order while any number of tasks look them up. Neither side ever blocks or
+ * allocates: a reader that was overtaken by the writer while searching just searches again. It gives up after a few
+ * tries, since a reader of higher priority spinning would never let the writer finish what it was doing.
+ *
+ * @tparam N number of poses kept
+ */
+template <std::size_t N> class PoseHistory {
+        static_assert(N >= 2, "a pose history needs at least 2 poses to interpolate between");
+    public:
+        /**
+         * @brief Add a pose. Only one task may add poses
+         *
+         * @param time time the pose was measured, in ms. Must not be older than the last pose added
+         * @param pose the pose
+         */
+        void push(std::uint32_t time, const Pose& pose) {
+            const std::uint32_t index = count.load(std::memory_order_relaxed);
+            entries[index % N] = {time, pose.x, pose.y, pose.theta};
+            count.store(index + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Get the pose at a given time, interpolated between the poses on either side
+         *
+         * Times older than the oldest pose or newer than the newest pose are clamped to those poses. O(log N)
+         *
+         * @param time the time, in ms
+         * @param pose where to store the pose
+         * @return true if the history has a pose
+         * @return false if the history is empty, or the writer kept changing it
+         */
+        bool poseAt(std::uint32_t time, Pose& pose) const {
+            for (int attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+                // an odd sequence means the writer is shifting the poses, so try again once it may have finished
+                const std::uint32_t sequence = shifts.load(std::memory_order_acquire);
+                if (sequence % 2 != 0) continue;
+                const std::uint32_t end = count.load(std::memory_order_acquire);
+                if (end == 0) return false;
+                // one slot is kept free, since the writer may be overwriting it
+                const std::uint32_t begin = end > N - 1 ? end - (N - 1) : 0;
+                // find the first pose at or after the time
+                std::uint32_t low = begin, high = end;
+                while (low < high) {
+                    const std::uint32_t mid = low + (high - low) / 2;
+                    if (entries[mid % N].time < time) low = mid + 1;
+                    else high = mid;
+                }
+                const std::uint32_t next = low == end ? end - 1 : low;
+                const std::uint32_t previous = low == begin || low == end ? next : low - 1;
+                const Entry before = entries[previous % N];
+                const Entry after = entries[next % N];
+                // the writer wrapped around onto what was read, or shifted some of it
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (count.load(std::memory_order_relaxed) - begin >= N) continue;
+                if (shifts.load(std::memory_order_relaxed) != sequence) continue;
+
+                float t = 0;
+                if (after.time != before.time) t = float(time - before.time) / (after.time - before.time);
+                pose.x = before.x + (after.x - before.x) * t;
+                pose.y = before.y + (after.y - before.y) * t;
+                pose.theta = before.theta + (after.theta - before.theta) * t;
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief Move every pose at or after a given time. Only the task adding poses may do this
+         *
+         * Readers looking poses up meanwhile search again, so none of them mixes shifted and unshifted poses
+         *
+         * @param time the time, in ms
+         * @param delta amount to move the poses by
+         */
+        void shift(std::uint32_t time, const Pose& delta) {
+            const std::uint32_t sequence = shifts.load(std::memory_order_relaxed);
+            shifts.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            const std::uint32_t end = count.load(std::memory_order_relaxed);
+            const std::uint32_t begin = end > N - 1 ? end - (N - 1) : 0;
+            for (std::uint32_t i = end; i > begin && entries[(i - 1) % N].time >= time; i--) {
+                Entry& entry = entries[(i - 1) % N];
+                entry.x += delta.x;
+                entry.y += delta.y;
+                entry.theta += delta.theta;
+            }
+            shifts.store(sequence + 2, std::memory_order_release);
+        }
+
+        /**
+         * @brief Forget every pose. Only the task adding poses may do this
+         *
+         */
+        void clear() { count.store(0, std::memory_order_release); }
+
+        /**
+         * @brief Get the number of poses that can be looked up
+         *
+         * @return std::size_t
+         */
+        std::size_t size() const {
+            const std::uint32_t end = count.load(std::memory_order_acquire);
+            return end > N - 1 ? N - 1 : end;
+        }
+    private:
+        /** @brief number of times a lookup searches before giving up */
+        static constexpr int MAX_ATTEMPTS = 8;
+
+        struct Entry {
+                std::uint32_t time;
+                float x;
+                float y;
+                float theta;
+        };
+
+        std::array<Entry, N> entries {};
+        /** @brief number of poses ever added */
+        std::atomic<std::uint32_t> count {0};
+        /** @brief sequence of shifts, odd while one is under way */
+        std::atomic<std::uint32_t> shifts {0};
+};
+} // namespace lemlib
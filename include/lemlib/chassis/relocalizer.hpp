@@ -0,0 +1,286 @@
+/**
+ * @file include/lemlib/chassis/relocalizer.hpp
+ * @author LemLib Team
+ * @brief Monte Carlo relocalization against the field walls with distance sensors
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "pros/distance.hpp"
+#include "pros/rtos.hpp"
+#include "lemlib/pose.hpp"
+
+namespace lemlib {
+/**
+ * @brief Static geometry of the field, as the line segments a distance sensor can see
+ *
+ * Coordinates are in inches, with the same origin as the pose passed to setPose. The segments are stored as arrays
+ * of start points and directions, so a batch of rays can be cast against all of them in one vectorized pass.
+ */
+class FieldModel {
+    public:
+        /**
+         * @brief Construct an empty field
+         *
+         */
+        FieldModel() = default;
+        /**
+         * @brief Get the inside of the field perimeter
+         *
+         * @param size distance between opposite walls, in inches. 140.4 for a standard VRC field
+         * @param centerX x coordinate of the center of the field, in inches
+         * @param centerY y coordinate of the center of the field, in inches
+         * @return FieldModel
+         */
+        static FieldModel perimeter(float size = 140.4, float centerX = 0, float centerY = 0);
+        /**
+         * @brief Add a wall, or any other flat surface tall enough for the sensors to see
+         *
+         * @param x1 x coordinate of one end, in inches
+         * @param y1 y coordinate of one end, in inches
+         * @param x2 x coordinate of the other end, in inches
+         * @param y2 y coordinate of the other end, in inches
+         */
+        void addWall(float x1, float y1, float x2, float y2);
+        /**
+         * @brief Get the number of walls
+         *
+         * @return std::size_t
+         */
+        std::size_t size() const;
+        /**
+         * @brief Find how far a ray travels before hitting a wall
+         *
+         * @param x x coordinate of the start of the ray, in inches
+         * @param y y coordinate of the start of the ray, in inches
+         * @param theta direction of the ray, in radians. 0 is +y and positive is clockwise
+         * @return float distance to the nearest wall, infinity if the ray misses every wall
+         */
+        float castRay(float x, float y, float theta) const;
+        /**
+         * @brief Cast a batch of rays
+         *
+         * The rays are given as arrays so they can be processed several at a time. Directions are passed as the sine
+         * and cosine of the LemLib heading, which is a unit vector along the ray
+         *
+         * @param count number of rays
+         * @param x x coordinate of the start of each ray
+         * @param y y coordinate of the start of each ray
+         * @param sin sine of the direction of each ray
+         * @param cos cosine of the direction of each ray
+         * @param out distance to the nearest wall along each ray, infinity on a miss
+         */
+        void castRays(std::size_t count, const float* x, const float* y, const float* sin, const float* cos,
+                      float* out) const;
+    private:
+        /** @brief start of each wall */
+        std::vector<float> startX;
+        std::vector<float> startY;
+        /** @brief vector from the start to the end of each wall */
+        std::vector<float> deltaX;
+        std::vector<float> deltaY;
+};
+
+/**
+ * @brief A distance sensor used for relocalization, and where it is mounted
+ *
+ */
+struct RelocalizerSensor {
+        /** @brief the sensor */
+        pros::Distance* sensor;
+        /** @brief offset of the sensor from the tracking center, right positive, in inches */
+        float x;
+        /** @brief offset of the sensor from the tracking center, forwards positive, in inches */
+        float y;
+        /** @brief direction the sensor faces relative to the front of the robot, clockwise positive, in degrees */
+        float angle;
+};
+
+/**
+ * @brief Tuning for the relocalizer
+ *
+ */
+struct RelocalizerSettings {
+        /** @brief number of particles. Each costs one ray per sensor per update */
+        std::size_t particles = 300;
+        /** @brief time between updates, in ms. The distance sensor reports about every 33 ms */
+        std::uint32_t period = 50;
+        /** @brief spread of the particles around the pose they are reset to, in inches */
+        float initialSpread = 2;
+        /** @brief standard deviation of odometry error, as a fraction of the distance driven */
+        float translationNoise = 0.05;
+        /** @brief standard deviation of odometry error, as a fraction of the angle turned */
+        float rotationNoise = 0.02;
+        /** @brief standard deviation of position error from wheels scrubbing in turns, in inches per radian turned */
+        float turnNoise = 0.5;
+        /** @brief random drift added to every particle on every update, in inches, so the cloud never collapses */
+        float jitter = 0.1;
+        /** @brief standard deviation of a distance reading, as a fraction of the distance */
+        float sensorNoise = 0.05;
+        /** @brief smallest standard deviation of a distance reading, in inches */
+        float minSensorNoise = 0.6;
+        /** @brief readings further than this are not trusted, in inches */
+        float maxRange = 75;
+        /** @brief readings with a confidence below this are ignored. Only readings past 200 mm report one, out of 63 */
+        std::int32_t minConfidence = 20;
+        /** @brief readings are ignored while turning faster than this, as the robot turns a lot between when the
+         * sensor takes a reading and when it is used, in degrees per second */
+        float maxAngularVelocity = 90;
+        /** @brief odometry is only corrected when the particles agree to within this, in inches */
+        float maxSpread = 3;
+        /** @brief the particles start over around odometry when it disagrees with them by more than this, in inches */
+        float resetDistance = 12;
+};
+
+/**
+ * @brief Statistics about the relocalizer
+ *
+ */
+struct RelocalizerStats {
+        /** @brief number of updates with at least one usable reading */
+        std::uint32_t updates;
+        /** @brief number of times odometry was corrected */
+        std::uint32_t corrections;
+        /** @brief number of times the particles were resampled */
+        std::uint32_t resamples;
+        /** @brief number of times the particles were reset around odometry */
+        std::uint32_t resets;
+        /** @brief time taken by the slowest and the average call to update, in microseconds */
+        std::uint32_t maxUpdateTime;
+        float meanUpdateTime;
+};
+
+/**
+ * @brief Particle filter that keeps odometry honest by comparing distance sensor readings against the field walls
+ *
+ * Every particle is a guess at the pose of the robot. Each update moves the particles by how far odometry says the
+ * robot moved, with some added noise, then weighs them by how well the distance each sensor reads matches the
+ * distance to the nearest wall from that particle. Particles that disagree with the sensors are replaced by copies
+ * of the ones that agree, and the weighted average of the particles is fed back into odometry through correctPose.
+ * Heading is left to the IMU.
+ *
+ * The particles are kept as separate arrays of x, y and heading, so ray casting works on several particles at once.
+ */
+class Relocalizer {
+    public:
+        /**
+         * @brief Construct a new Relocalizer
+         *
+         * @param field the walls the sensors can see
+         * @param sensors the distance sensors
+         * @param settings the tuning
+         */
+        Relocalizer(FieldModel field, std::vector<RelocalizerSensor> sensors,
+                    RelocalizerSettings settings = RelocalizerSettings());
+        /**
+         * @brief Start updating in a task of its own
+         *
+         * The particles are reset around the current pose. Odometry should already be running
+         */
+        void start();
+        /**
+         * @brief Stop the task started by start()
+         *
+         * Waits for the update under way to finish, so the task never dies holding odometry's locks
+         */
+        void stop();
+        /**
+         * @brief Spread the particles around a pose
+         *
+         * @param pose the pose
+         * @param radians true if theta is in radians, false if in degrees. False by default
+         */
+        void reset(Pose pose, bool radians = false);
+        /**
+         * @brief Move the particles with odometry, weigh them with the sensors, and correct odometry
+         *
+         * Called by the task started by start(), or by the user at a fixed rate
+         */
+        void update();
+        /**
+         * @brief Get the weighted average of the particles
+         *
+         * @param radians true for theta in radians, false for degrees. False by default
+         * @return Pose
+         */
+        Pose getEstimate(bool radians = false) const;
+        /**
+         * @brief Get the standard deviation of the particle positions
+         *
+         * @return float in inches
+         */
+        float getSpread() const;
+        /**
+         * @brief Get statistics about the updates so far
+         *
+         * @return RelocalizerStats
+         */
+        RelocalizerStats getStats() const;
+    private:
+        /**
+         * @brief Move every particle by a motion measured in the robot's frame
+         *
+         * @param delta motion since the last update, x sideways and y forwards, theta in radians
+         */
+        void predict(Pose delta);
+        /**
+         * @brief Weigh the particles with the latest distance readings
+         *
+         * @return true if at least one reading was usable
+         */
+        bool weigh();
+        /**
+         * @brief Replace the particles by drawing from them in proportion to their weights
+         *
+         */
+        void resample();
+        /**
+         * @brief Compute the weighted mean and spread of the particles
+         *
+         */
+        void estimate();
+
+        FieldModel field;
+        std::vector<RelocalizerSensor> sensors;
+        RelocalizerSettings settings;
+        std::minstd_rand rng;
+
+        /** @brief the particles */
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> theta;
+        std::vector<float> weight;
+        /** @brief log likelihood of the latest readings for each particle */
+        std::vector<float> likelihood;
+        /** @brief scratch space for resampling and ray casting, allocated once */
+        std::vector<float> scratchX;
+        std::vector<float> scratchY;
+        std::vector<float> scratchTheta;
+        std::vector<float> rayX;
+        std::vector<float> rayY;
+        std::vector<float> raySin;
+        std::vector<float> rayCos;
+        std::vector<float> rayDistance;
+
+        Pose mean = Pose(0, 0, 0);
+        float spread = 0;
+        /** @brief odometry as of the last update, including the correction made then */
+        Pose prevPose = Pose(0, 0, 0);
+        RelocalizerStats stats {};
+        std::uint64_t totalUpdateTime = 0;
+        std::uint32_t updateCalls = 0;
+        pros::Task* task = nullptr;
+        /** @brief set by stop, so the task leaves its loop after the update under way */
+        std::atomic<bool> stopping {false};
+};
+} // namespace lemlib
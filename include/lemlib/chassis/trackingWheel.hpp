@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <cstdint>
+#include <array>
 #include "pros/motors.hpp"
 #include "pros/adi.hpp"
 #include "pros/rotation.hpp"
@@ -72,9 +74,22 @@ class TrackingWheel {
         /**
          * @brief Get the distance traveled by the tracking wheel
          *
+         * Motor encoders are read with the average time the motors took their samples. Rotation sensors and ADI
+         * encoders don't report one, so they are timestamped with the time they were read.
+         *
+         * @param timestamp where to store the time the distance was measured, in ms. Ignored if nullptr
          * @return float distance traveled in inches
          */
-        float getDistanceTraveled();
+        float getDistanceTraveled(std::uint32_t* timestamp = nullptr);
+        /**
+         * @brief Set how often the sensor takes a new sample
+         *
+         * Only rotation sensors can change their rate. Motors always sample every 10 ms and ADI encoders are
+         * counted continuously
+         *
+         * @param rate time between samples, in ms. The minimum is 5
+         */
+        void setDataRate(std::uint32_t rate);
         /**
          * @brief Get the offset of the tracking wheel from the center of rotation
          *
@@ -88,12 +103,17 @@ class TrackingWheel {
          */
         int getType();
     private:
+        /** @brief most motors read from a motor group. Any more are ignored */
+        static constexpr int MAX_MOTORS = 8;
+
         float diameter;
         float distance;
         float rpm;
         pros::ADIEncoder* encoder = nullptr;
         pros::Rotation* rotation = nullptr;
         pros::Motor_Group* motors = nullptr;
+        /** @brief raw encoder count of each motor when the wheel was last reset */
+        std::array<std::int32_t, MAX_MOTORS> motorZeros {};
         float gearRatio = 1;
 };
 } // namespace lemlib
\ No newline at end of file
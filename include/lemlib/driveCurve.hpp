@@ -0,0 +1,147 @@
+/**
+ * @file include/lemlib/driveCurve.hpp
+ * @author LemLib Team
+ * @brief Drive curves, and tables they are baked into at compile time
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <array>
+
+namespace lemlib {
+/**
+ * @brief e to the power of x, in a form that can run at compile time
+ *
+ * @param x the exponent
+ * @return double e^x
+ */
+constexpr double constexprExp(double x) {
+    // e^x = (e^(x / 2^k))^(2^k), with x / 2^k small enough for a short Taylor series
+    int halvings = 0;
+    while (x > 0.5 || x < -0.5) {
+        x /= 2;
+        halvings++;
+    }
+    double sum = 1;
+    double term = 1;
+    for (int i = 1; i < 12; i++) {
+        term *= x / i;
+        sum += term;
+    }
+    while (halvings-- > 0) sum *= sum;
+    return sum;
+}
+
+/**
+ * @brief The exponential drive curve of `defaultDriveCurve`, in a form that can run at compile time
+ *
+ * @param gain how steep the curve is. 0 leaves the input alone
+ */
+struct ExpoCurve {
+        float gain = 0;
+
+        constexpr float operator()(float input) const {
+            if (gain == 0) return input;
+            // defaultDriveCurve raises 2.718 rather than e, so the exponents are scaled by ln(2.718)
+            constexpr double LN_BASE = 0.999896315728952;
+            const double size = input < 0 ? -input : input;
+            const double flat = constexprExp(-gain / 10 * LN_BASE);
+            return (flat + constexprExp((size - 127) / 10 * LN_BASE) * (1 - flat)) * input;
+        }
+};
+
+/**
+ * @brief What a drive curve table bakes in around its curve
+ *
+ * @param deadband how far the stick has to move before the robot does, out of 127. The rest of the stick is stretched
+ * over the whole curve
+ * @param minOutput power the robot starts at just past the deadband, usually what it takes to get it moving. The curve
+ * is squeezed into the power that is left
+ * @param interpolate whether to interpolate between the entries for inputs that aren't whole numbers, like the ones
+ * curvature drive makes. Otherwise they round to the nearest entry
+ */
+struct CurveSettings {
+        float deadband = 0;
+        float minOutput = 0;
+        bool interpolate = true;
+};
+
+/**
+ * @brief A drive curve baked into a table of its output at each input from -127 to 127
+ *
+ * Driver control looks the power up instead of working the curve out every update. Declare the table constexpr and it
+ * is worked out at compile time, from any curve that can run in a constant expression, like ExpoCurve or a lambda.
+ */
+class DriveCurveTable {
+    public:
+        /**
+         * @brief Construct a table that leaves the input alone
+         *
+         */
+        constexpr DriveCurveTable()
+            : DriveCurveTable([](float input) { return input; }) {}
+
+        /**
+         * @brief Construct a table from a curve
+         *
+         * @param curve takes an input from -127 to 127 and returns a power from -127 to 127
+         * @param settings the deadband, minimum output and interpolation to bake in
+         */
+        template <typename Curve>
+        constexpr explicit DriveCurveTable(Curve curve, CurveSettings settings = CurveSettings())
+            : values(),
+              interpolate(settings.interpolate) {
+            const float deadband = settings.deadband;
+            const float minOutput = settings.minOutput;
+            for (int i = 0; i < SIZE; i++) {
+                const float input = i - MAX;
+                const float size = input < 0 ? -input : input;
+                if (size <= deadband) continue;
+                const float stretched = (size - deadband) * MAX / (MAX - deadband);
+                float output = curve(stretched);
+                if (output < 0) output = -output;
+                output = minOutput + output * (MAX - minOutput) / MAX;
+                if (output > MAX) output = MAX;
+                values[i] = input < 0 ? -output : output;
+            }
+        }
+
+        /**
+         * @brief Look up the output at an input
+         *
+         * @param input input from -127 to 127. Inputs past either end get the output at that end
+         * @return float the output
+         */
+        constexpr float at(int input) const {
+            if (input > MAX) input = MAX;
+            else if (input < -MAX) input = -MAX;
+            return values[input + MAX];
+        }
+
+        /**
+         * @brief Look up the output at an input that doesn't have to be a whole number
+         *
+         * @param input input from -127 to 127
+         * @return float the output, interpolated or from the nearest entry as the table was built
+         */
+        constexpr float operator()(float input) const {
+            if (input >= MAX) return values[SIZE - 1];
+            if (input <= -MAX) return values[0];
+            const float position = input + MAX;
+            if (!interpolate) return values[int(position + 0.5f)];
+            const int low = int(position);
+            const float t = position - low;
+            return values[low] + (values[low + 1] - values[low]) * t;
+        }
+    private:
+        static constexpr int MAX = 127;
+        static constexpr int SIZE = 2 * MAX + 1;
+        std::array<float, SIZE> values;
+        bool interpolate;
+};
+} // namespace lemlib
@@ -1,6 +1,23 @@
 #pragma once
 
 namespace lemlib {
+/**
+ * @brief Settings for ending an exit condition's countdown early, once the robot has provably stopped on target
+ *
+ * The robot counts as settled while the input is in range, it changes no faster than maxRate, and the measured
+ * velocity is no faster than maxVelocity. It only has to stay that way for the settle time, which is much shorter
+ * than the countdown and long enough to not mistake turning around at the peak of an overshoot for settling.
+ *
+ * @param time how long the robot has to be settled for, in ms. 0 turns settle detection off, which is the default
+ * @param maxRate largest rate of change of the input, in its units per second
+ * @param maxVelocity largest velocity measured by odometry, in inches or degrees per second
+ */
+struct SettleSettings {
+        int time = 0;
+        float maxRate = 0;
+        float maxVelocity = 0;
+};
+
 class ExitCondition {
     public:
         /**
@@ -11,6 +28,13 @@ class ExitCondition {
          */
         ExitCondition(const float range, const int time);
 
+        /**
+         * @brief set how to tell the robot has settled, which exits before the countdown is up
+         *
+         * @param settle the settle settings. A time of 0 turns settle detection off
+         */
+        void setSettle(SettleSettings settle);
+
         /**
          * @brief whether the exit condition has been met
          *
@@ -23,10 +47,25 @@ class ExitCondition {
          * @brief update the exit condition
          *
          * @param input the input for the exit condition
+         * @param velocity velocity measured by odometry, for settle detection
          * @return true exit condition met
          * @return false exit condition not met
          */
-        bool update(const float input);
+        bool update(const float input, const float velocity = 0);
+
+        /**
+         * @brief how much sooner settle detection met the exit condition than the countdown would have
+         *
+         * @return time saved in ms, 0 if the countdown met it or it hasn't been met
+         */
+        int getSaved() const;
+
+        /**
+         * @brief when the countdown ended, or would have if settle detection hadn't ended it first
+         *
+         * @return the time in ms, or -1 if the input is out of range and it hasn't been met
+         */
+        int getCountdownEnd() const;
 
         /**
          * @brief reset the exit condition timer
@@ -36,7 +75,22 @@ class ExitCondition {
     private:
         const float range;
         const int time;
+        SettleSettings settle;
         int startTime = -1;
+        int settleStartTime = -1;
+        int prevTime = -1;
+        float prevInput = 0;
+        int saved = 0;
+        int doneTime = -1;
         bool done = false;
 };
+
+/**
+ * @brief when the first of two exit conditions' countdowns ended, or would have, for motions that end on either
+ *
+ * @param a the first exit condition
+ * @param b the second exit condition
+ * @return the time in ms, or -1 if neither countdown is running
+ */
+int firstCountdownEnd(const ExitCondition& a, const ExitCondition& b);
 } // namespace lemlib
\ No newline at end of file
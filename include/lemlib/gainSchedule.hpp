@@ -0,0 +1,125 @@
+/**
+ * @file include/lemlib/gainSchedule.hpp
+ * @author LemLib Team
+ * @brief Gain schedules: PID gains interpolated from a table by error or speed
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace lemlib {
+/**
+ * @brief What a gain schedule looks its gains up by
+ *
+ */
+enum class ScheduleKey {
+    /** @brief size of the error, in inches or degrees */
+    ERROR,
+    /** @brief speed of the robot, in inches or degrees per second */
+    SPEED
+};
+
+/**
+ * @brief Gains at one point of a gain schedule
+ *
+ * @param key error or speed this point is at, which has to be larger than the one of the point before
+ * @param kP proportional gain
+ * @param kI integral gain
+ * @param kD derivative gain
+ * @param kS static feedforward
+ */
+struct GainPoint {
+        float key = 0;
+        float kP = 0;
+        float kI = 0;
+        float kD = 0;
+        float kS = 0;
+};
+
+/**
+ * @brief Gains interpolated from a table of points, so large motions can run on aggressive gains and small ones on
+ * stable gains
+ *
+ * The schedule doesn't copy the table, so it has to outlive the schedule. A constexpr array at namespace scope does,
+ * and the whole schedule can then be checked at compile time. Looking gains up never allocates.
+ */
+class GainSchedule {
+    public:
+        /**
+         * @brief Construct an empty schedule, which leaves the gains alone
+         *
+         */
+        constexpr GainSchedule() = default;
+
+        /**
+         * @brief Construct a schedule from a table of points
+         *
+         * @param points the points, in order of their keys
+         * @param key what to look the gains up by
+         */
+        template <std::size_t N>
+        constexpr GainSchedule(const GainPoint (&points)[N], ScheduleKey key = ScheduleKey::ERROR)
+            : points(points),
+              size(N),
+              key(key) {}
+
+        /**
+         * @brief whether the schedule has no points
+         *
+         */
+        constexpr bool empty() const { return size == 0; }
+
+        /**
+         * @brief what the schedule looks its gains up by
+         *
+         */
+        constexpr ScheduleKey getKey() const { return key; }
+
+        /**
+         * @brief whether the keys of the points go up, which they have to
+         *
+         */
+        constexpr bool isSorted() const {
+            for (std::size_t i = 1; i < size; i++) {
+                if (points[i].key <= points[i - 1].key) return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Look up the gains, interpolating between the two closest points
+         *
+         * @param value the error or speed. Only its size matters
+         * @return GainPoint the gains, from the first or last point past either end of the table
+         */
+        constexpr GainPoint at(float value) const {
+            if (size == 0) return GainPoint();
+            if (value < 0) value = -value;
+            if (value <= points[0].key) return points[0];
+            for (std::size_t i = 1; i < size; i++) {
+                if (value >= points[i].key) continue;
+                const GainPoint& low = points[i - 1];
+                const GainPoint& high = points[i];
+                const float t = (value - low.key) / (high.key - low.key);
+                GainPoint gains;
+                gains.key = value;
+                gains.kP = low.kP + (high.kP - low.kP) * t;
+                gains.kI = low.kI + (high.kI - low.kI) * t;
+                gains.kD = low.kD + (high.kD - low.kD) * t;
+                gains.kS = low.kS + (high.kS - low.kS) * t;
+                return gains;
+            }
+            return points[size - 1];
+        }
+    private:
+        const GainPoint* points = nullptr;
+        std::size_t size = 0;
+        ScheduleKey key = ScheduleKey::ERROR;
+};
+} // namespace lemlib
@@ -0,0 +1,133 @@
+/**
+ * @file include/lemlib/inputManager.hpp
+ * @author LemLib Team
+ * @brief Samples the controller buttons once an update and runs actions on presses, releases, holds and double taps
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include "pros/misc.hpp"
+
+namespace lemlib {
+/**
+ * @brief Settings for the input manager
+ *
+ * @param debounce how long a button ignores changes after it changes, in ms. The change itself counts straight away
+ * @param holdTime how long a button has to be held down for a hold, in ms
+ * @param doubleTapTime longest time between the presses of a double tap, in ms
+ */
+struct InputSettings {
+        int debounce = 30;
+        int holdTime = 500;
+        int doubleTapTime = 300;
+};
+
+/**
+ * @brief What a button did that an action can be bound to
+ *
+ */
+enum class ButtonEvent {
+    /** @brief the button was pressed */
+    PRESS,
+    /** @brief the button was released */
+    RELEASE,
+    /** @brief the button has been held down for the hold time. Happens once per press */
+    HOLD,
+    /** @brief the button was pressed again within the double tap time of the press before. Also counts as a press */
+    DOUBLE_TAP
+};
+
+/**
+ * @brief Reads every button of a controller once an update, and runs the actions bound to what they did
+ *
+ * Opcontrol calls update once a loop, and then asks the manager rather than the controller. Actions run in update,
+ * so an action that toggles a piston doesn't have to wait out the button with pros::delay, and the drive keeps
+ * running every update. The buttons are kept in bitsets, with a bit per button.
+ */
+class InputManager {
+    public:
+        /**
+         * @brief Create a new input manager
+         *
+         * @param controller the controller to read
+         * @param settings the settings
+         */
+        InputManager(pros::Controller& controller, InputSettings settings = InputSettings());
+        /**
+         * @brief Run an action every time a button does something
+         *
+         * Actions run in update, in the task that calls it, so they shouldn't block
+         *
+         * @param button the button
+         * @param event what the button has to do
+         * @param action the action
+         * @return true the action was bound
+         * @return false there is no room for another action
+         */
+        bool bind(pros::controller_digital_e_t button, ButtonEvent event, std::function<void()> action);
+        /**
+         * @brief Read the buttons and run the actions bound to what they did since the last update
+         *
+         */
+        void update();
+        /**
+         * @brief whether a button is down, as of the last update
+         *
+         * @param button the button
+         */
+        bool isDown(pros::controller_digital_e_t button) const;
+        /**
+         * @brief whether a button did something in the last update
+         *
+         * @param button the button
+         * @param event what the button has to have done
+         */
+        bool happened(pros::controller_digital_e_t button, ButtonEvent event) const;
+    private:
+        /** @brief largest number of actions that can be bound */
+        static constexpr int MAX_BINDINGS = 16;
+        /** @brief number of digital buttons, from L1 to A */
+        static constexpr int BUTTONS = 12;
+
+        /** @brief an action and what it runs on */
+        struct Binding {
+                /** @brief bit of the button */
+                uint16_t button = 0;
+                ButtonEvent event = ButtonEvent::PRESS;
+                std::function<void()> action;
+        };
+
+        /**
+         * @brief the bit of a button in the bitsets
+         *
+         * @param button the button
+         * @return uint16_t the bit, or 0 if it isn't a digital button
+         */
+        static uint16_t bit(pros::controller_digital_e_t button);
+
+        pros::Controller& controller;
+        const InputSettings settings;
+        /** @brief buttons that are down, after debouncing */
+        uint16_t down = 0;
+        /** @brief buttons that did each event in the last update, indexed by ButtonEvent */
+        std::array<uint16_t, 4> events {};
+        /** @brief buttons whose hold has already happened for this press */
+        uint16_t holdDone = 0;
+        /** @brief buttons whose last press can still become a double tap */
+        uint16_t tapArmed = 0;
+        /** @brief when each button last changed, in ms */
+        std::array<uint32_t, BUTTONS> changeTime {};
+        /** @brief when each button was last pressed, in ms */
+        std::array<uint32_t, BUTTONS> pressTime {};
+        std::array<Binding, MAX_BINDINGS> bindings;
+        int bindingCount = 0;
+};
+} // namespace lemlib
@@ -0,0 +1,98 @@
+/**
+ * @file include/lemlib/matrix.hpp
+ * @author LemLib Team
+ * @brief Fixed size matrices
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace lemlib {
+/**
+ * @brief Matrix of floats with its size known at compile time
+ *
+ * The elements live inside the object, so matrices never allocate and can be passed around by value. Sizes are
+ * checked by the compiler, so multiplying mismatched matrices doesn't build.
+ *
+ * @tparam R number of rows
+ * @tparam C number of columns
+ */
+template <std::size_t R, std::size_t C> class Matrix {
+    public:
+        /**
+         * @brief Construct a matrix of zeros
+         *
+         */
+        constexpr Matrix() : data {} {}
+
+        /**
+         * @brief Construct a matrix from its elements, row by row
+         *
+         * @param values the elements
+         */
+        constexpr Matrix(const std::array<float, R * C>& values) : data(values) {}
+
+        /**
+         * @brief Get the identity matrix
+         *
+         * @return Matrix
+         */
+        static constexpr Matrix identity() {
+            static_assert(R == C, "only square matrices have an identity");
+            Matrix out;
+            for (std::size_t i = 0; i < R; i++) out(i, i) = 1;
+            return out;
+        }
+
+        constexpr float& operator()(std::size_t row, std::size_t col) { return data[row * C + col]; }
+
+        constexpr float operator()(std::size_t row, std::size_t col) const { return data[row * C + col]; }
+
+        constexpr Matrix operator+(const Matrix& other) const {
+            Matrix out;
+            for (std::size_t i = 0; i < R * C; i++) out.data[i] = data[i] + other.data[i];
+            return out;
+        }
+
+        constexpr Matrix operator-(const Matrix& other) const {
+            Matrix out;
+            for (std::size_t i = 0; i < R * C; i++) out.data[i] = data[i] - other.data[i];
+            return out;
+        }
+
+        constexpr Matrix operator*(float scalar) const {
+            Matrix out;
+            for (std::size_t i = 0; i < R * C; i++) out.data[i] = data[i] * scalar;
+            return out;
+        }
+
+        template <std::size_t K> constexpr Matrix<R, K> operator*(const Matrix<C, K>& other) const {
+            Matrix<R, K> out;
+            for (std::size_t i = 0; i < R; i++) {
+                for (std::size_t k = 0; k < C; k++) {
+                    const float a = (*this)(i, k);
+                    if (a == 0) continue; // the matrices used for filtering are mostly zeros
+                    for (std::size_t j = 0; j < K; j++) out(i, j) += a * other(k, j);
+                }
+            }
+            return out;
+        }
+
+        constexpr Matrix<C, R> transpose() const {
+            Matrix<C, R> out;
+            for (std::size_t i = 0; i < R; i++) {
+                for (std::size_t j = 0; j < C; j++) out(j, i) = (*this)(i, j);
+            }
+            return out;
+        }
+    private:
+        std::array<float, R * C> data;
+};
+} // namespace lemlib
@@ -0,0 +1,136 @@
+/**
+ * @file include/lemlib/motionProfile.hpp
+ * @author LemLib Team
+ * @brief Trapezoidal and S-curve motion profiles
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace lemlib {
+/**
+ * @brief Limits on how a motion profile may move
+ *
+ * Units are up to the user, as long as they are consistent. The chassis uses inches and seconds
+ */
+struct ProfileConstraints {
+        /** @brief maximum velocity. 0 disables profiling */
+        float maxVelocity = 0;
+        /** @brief maximum acceleration, also used for deceleration */
+        float maxAcceleration = 0;
+        /** @brief maximum rate of change of acceleration. 0 for a trapezoidal profile, which changes acceleration
+         * instantly */
+        float maxJerk = 0;
+};
+
+/**
+ * @brief Where a motion profile says the robot should be at some time
+ *
+ */
+struct ProfileState {
+        float position;
+        float velocity;
+        float acceleration;
+};
+
+/**
+ * @brief Time-parameterized 1D motion from rest, or a given velocity, to a distance
+ *
+ * The profile accelerates to a cruise velocity, cruises, then decelerates to the end velocity. With a jerk limit each
+ * change of velocity ramps the acceleration up and down (an S-curve), otherwise the acceleration steps (a
+ * trapezoid). If the distance is too short to reach the maximum velocity, the cruise velocity is lowered so the
+ * profile still ends exactly at the distance.
+ *
+ * Everything is computed when the profile is constructed, so sampling it is cheap enough for every control tick.
+ */
+class MotionProfile {
+    public:
+        /**
+         * @brief Construct an empty profile, which is already finished
+         *
+         */
+        MotionProfile() = default;
+        /**
+         * @brief Plan a motion
+         *
+         * @param distance distance to travel. Negative distances are travelled backwards
+         * @param constraints the limits
+         * @param startVelocity velocity at the start, in the direction of travel. 0 by default
+         * @param endVelocity velocity at the end, in the direction of travel. 0 by default
+         */
+        MotionProfile(float distance, ProfileConstraints constraints, float startVelocity = 0, float endVelocity = 0);
+        /**
+         * @brief Get where the profile is at a given time
+         *
+         * @param time time since the start of the profile, in seconds
+         * @return ProfileState the start before the profile starts, the end after it ends
+         */
+        ProfileState sample(float time) const;
+        /**
+         * @brief Get how long the profile takes
+         *
+         * @return float in seconds
+         */
+        float getDuration() const;
+        /**
+         * @brief Get the distance the profile travels
+         *
+         * @return float
+         */
+        float getDistance() const;
+    private:
+        /** @brief stretch of the profile with constant jerk */
+        struct Segment {
+                float start;
+                float duration;
+                float jerk;
+                float position;
+                float velocity;
+                float acceleration;
+        };
+
+        /**
+         * @brief Distance travelled while changing velocity, with the acceleration ramped by the jerk limit
+         *
+         * @param from velocity at the start
+         * @param to velocity at the end
+         * @return float
+         */
+        float rampDistance(float from, float to) const;
+        /**
+         * @brief Add the segments that change velocity
+         *
+         * @param from velocity at the start
+         * @param to velocity at the end
+         */
+        void addRamp(float from, float to);
+        /**
+         * @brief Add a segment, starting where the last one ended
+         *
+         * @param duration how long the segment lasts, in seconds
+         * @param jerk jerk during the segment
+         * @param acceleration acceleration at the start of the segment
+         */
+        void addSegment(float duration, float jerk, float acceleration);
+
+        ProfileConstraints constraints;
+        /** @brief the profile is planned forwards, and flipped when sampled if the distance is negative */
+        float direction = 1;
+        float distance = 0;
+        float endVelocity = 0;
+        /** @brief a ramp has up to 3 segments, so two ramps and a cruise take at most 7 */
+        std::array<Segment, 7> segments {};
+        std::size_t count = 0;
+        float duration = 0;
+        /** @brief state at the end of the last segment added */
+        float endPosition = 0;
+        float endSpeed = 0;
+};
+} // namespace lemlib
@@ -1,6 +1,32 @@
 #pragma once
 
 namespace lemlib {
+/**
+ * @brief Settings for updating a PID with the time since its last update
+ *
+ * The gains stay in the units of the plain update, per update of the period below, so the same gains work with
+ * both. A longer or shorter update than the period then integrates and differentiates over the time that actually
+ * passed, instead of kicking the output.
+ *
+ * @param period update period the gains are for, in seconds. 10 ms by default, the period of the motions. 0 ignores
+ * the time step, like the plain update
+ * @param derivativeCutoff cutoff frequency of the low-pass filter on the derivative, in Hz. 0 turns the filter off,
+ * which is the default
+ * @param derivativeOnMeasurement take the derivative of the measurement instead of the error, so a target that jumps
+ * doesn't kick the output. false by default
+ * @param maxOutput largest output. Whatever the output goes over it by is taken back off the integral. 0 for no
+ * limit, which is the default
+ * @param backCalculation how fast to take the output over the limit back off the integral, per second. 100 by
+ * default, which takes all of it off in a 10 ms update. 0 turns back-calculation off
+ */
+struct PIDSettings {
+        float period = 0.01;
+        float derivativeCutoff = 0;
+        bool derivativeOnMeasurement = false;
+        float maxOutput = 0;
+        float backCalculation = 100;
+};
+
 class PID {
     public:
         /**
@@ -22,6 +48,33 @@ class PID {
          */
         float update(float error);
 
+        /**
+         * @brief Update the PID with the time since the last update, using the settings
+         *
+         * @param error target minus position - AKA error
+         * @param dt time since the last update, in seconds
+         * @param measurement the position, so that the error is the target minus it. Only needed for derivative on
+         * measurement
+         * @return float output, limited to the max output
+         */
+        float update(float error, float dt, float measurement = 0);
+
+        /**
+         * @brief Change the settings used by the update with a time step
+         *
+         * @param settings the settings
+         */
+        void setSettings(PIDSettings settings);
+
+        /**
+         * @brief Change the gains, keeping the integral and the previous error
+         *
+         * @param kP proportional gain
+         * @param kI integral gain
+         * @param kD derivative gain
+         */
+        void setGains(float kP, float kI, float kD);
+
         /**
          * @brief reset integral, derivative, and prevTime
          *
@@ -29,15 +82,20 @@ class PID {
         void reset();
     private:
         // gains
-        const float kP;
-        const float kI;
-        const float kD;
+        float kP;
+        float kI;
+        float kD;
 
         // optimizations
         const float windupRange;
         const bool signFlipReset;
 
+        PIDSettings settings;
+
         float integral = 0;
         float prevError = 0;
+        float prevMeasurement = 0;
+        float derivative = 0;
+        bool first = true;
 };
 } // namespace lemlib
\ No newline at end of file
@@ -0,0 +1,183 @@
+/**
+ * @file include/lemlib/pipeline.hpp
+ * @author LemLib Team
+ * @brief Control pipelines put together from stages at compile time
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "pros/motors.h"
+#include "lemlib/pid.hpp"
+#include "lemlib/driveCurve.hpp"
+
+namespace lemlib {
+/**
+ * @brief Shaping stage that passes the input through
+ *
+ */
+struct NoShaping {
+        constexpr float operator()(float input) const { return input; }
+};
+
+/**
+ * @brief Shaping stage that looks the input up in a drive curve table
+ *
+ * @param table the table, which has to outlive the stage
+ */
+struct CurveLookup {
+        const DriveCurveTable* table = nullptr;
+
+        constexpr float operator()(float input) const { return (*table)(input); }
+};
+
+/**
+ * @brief Controller stage that passes the input through, for when the input already is a power, like a joystick
+ *
+ */
+struct Passthrough {
+        constexpr float operator()(float input, float) const { return input; }
+};
+
+/**
+ * @brief Controller stage that runs a PID on the input as its error
+ *
+ * @param pid the PID
+ */
+struct PIDStage {
+        PID pid;
+
+        float operator()(float error, float dt) { return pid.update(error, dt); }
+};
+
+/**
+ * @brief Limiting stage that passes the output through
+ *
+ */
+struct NoLimit {
+        constexpr float operator()(float output) const { return output; }
+};
+
+/**
+ * @brief Limiting stage that limits how fast the output can change, like `slew`
+ *
+ * @param maxChange largest change per update. No limit if set to 0
+ * @param prev output of the last update
+ */
+struct SlewLimit {
+        float maxChange = 0;
+        float prev = 0;
+
+        float operator()(float output) {
+            if (maxChange != 0) output = std::fmax(prev - maxChange, std::fmin(prev + maxChange, output));
+            prev = output;
+            return output;
+        }
+};
+
+/**
+ * @brief Output stage that maps the output to a motor power from -127 to 127
+ *
+ */
+struct PowerOutput {
+        constexpr int32_t operator()(float output) const {
+            return output > 127 ? 127 : output < -127 ? -127 : int32_t(output);
+        }
+};
+
+/**
+ * @brief Output stage that maps a power out of 127 to millivolts
+ *
+ * @param scale how much to scale the voltage by, to make up for the battery sagging
+ */
+struct VoltageOutput {
+        float scale = 1;
+
+        constexpr int32_t operator()(float output) const {
+            const float millivolts = output * 12000 / 127 * scale;
+            return millivolts > 12000 ? 12000 : millivolts < -12000 ? -12000 : int32_t(millivolts);
+        }
+};
+
+/**
+ * @brief A control pipeline: input shaping, then a controller, then a limit, then the mapping to a motor command
+ *
+ * Each stage is a type picked at compile time rather than a std::function or a virtual, so a whole update inlines
+ * into one function. Stages are public members, so their settings and state can be changed between updates.
+ *
+ * @tparam Shaping takes the input and returns it shaped, like a drive curve
+ * @tparam Controller takes the shaped input and the time step, and returns an output
+ * @tparam Limiter takes the output and returns it limited
+ * @tparam Output takes the limited output and returns the motor command
+ */
+template <typename Shaping, typename Controller, typename Limiter, typename Output> struct ControlPipeline {
+        Shaping shaping;
+        Controller controller;
+        Limiter limiter;
+        Output output;
+
+        /**
+         * @brief Run the input through every stage
+         *
+         * @param input the input, like a joystick position or an error
+         * @param dt time since the last update, in seconds
+         * @return int32_t the motor command
+         */
+        int32_t update(float input, float dt = 0) { return output(limiter(controller(shaping(input), dt))); }
+};
+
+/**
+ * @brief The ports of a group of motors, written to through the PROS C API
+ *
+ * pros::Motor_Group goes through a virtual call per motor, and on the brain takes a mutex per command. The C API
+ * takes the port straight away, and the motors keep the direction their pros::Motor was constructed with.
+ */
+class MotorPorts {
+    public:
+        /**
+         * @brief Construct an empty group
+         *
+         */
+        MotorPorts() = default;
+
+        /**
+         * @brief Construct a group from the ports of a motor group. Only the first 8 are kept
+         *
+         * @param ports ports, like from pros::Motor_Group::get_ports
+         */
+        explicit MotorPorts(const std::vector<std::uint8_t>& ports) {
+            for (const std::uint8_t port : ports) {
+                if (count < this->ports.size()) this->ports[count++] = port;
+            }
+        }
+
+        /**
+         * @brief Drive every motor at a power
+         *
+         * @param power power from -127 to 127
+         */
+        void move(int32_t power) const {
+            for (std::size_t i = 0; i < count; i++) pros::c::motor_move(ports[i], power);
+        }
+
+        /**
+         * @brief Drive every motor at a voltage
+         *
+         * @param millivolts voltage from -12000 to 12000
+         */
+        void moveVoltage(int32_t millivolts) const {
+            for (std::size_t i = 0; i < count; i++) pros::c::motor_move_voltage(ports[i], millivolts);
+        }
+    private:
+        std::array<std::uint8_t, 8> ports {};
+        std::size_t count = 0;
+};
+} // namespace lemlib
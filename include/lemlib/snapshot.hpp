@@ -0,0 +1,81 @@
+/**
+ * @file include/lemlib/snapshot.hpp
+ * @author LemLib Team
+ * @brief Double buffered seqlock for sharing a value between tasks
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+namespace lemlib {
+/**
+ * @brief A value published by one task and read by many, without locks
+ *
+ * There are two copies of the value. The writer fills the one readers aren't pointed at and then points readers at
+ * it, so a reader always copies a complete value and never waits for a writer that was preempted halfway through.
+ * Each copy also has a sequence number, odd while it is being written, so the rare reader that is overtaken by two
+ * writes while copying notices and copies again.
+ *
+ * @tparam T the value. Must be trivially copyable
+ */
+template <typename T> class Snapshot {
+        static_assert(std::is_trivially_copyable_v<T>, "snapshots are copied without locks");
+    public:
+        /**
+         * @brief Construct a new Snapshot
+         *
+         * @param value the initial value
+         */
+        explicit Snapshot(const T& value = T()) : buffers {{{value, {0}}, {value, {0}}}} {}
+
+        /**
+         * @brief Publish a new value. Only one task may publish at a time
+         *
+         * @param value the new value
+         */
+        void publish(const T& value) {
+            const std::uint32_t next = 1 - current.load(std::memory_order_relaxed);
+            Buffer& buffer = buffers[next];
+            const std::uint32_t sequence = buffer.sequence.load(std::memory_order_relaxed);
+            buffer.sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            buffer.value = value;
+            buffer.sequence.store(sequence + 2, std::memory_order_release);
+            current.store(next, std::memory_order_release);
+        }
+
+        /**
+         * @brief Get the last value published
+         *
+         * @return T
+         */
+        T read() const {
+            while (true) {
+                const Buffer& buffer = buffers[current.load(std::memory_order_acquire)];
+                const std::uint32_t before = buffer.sequence.load(std::memory_order_acquire);
+                if (before & 1) continue;
+                const T value = buffer.value;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (buffer.sequence.load(std::memory_order_relaxed) == before) return value;
+            }
+        }
+    private:
+        struct Buffer {
+                T value;
+                std::atomic<std::uint32_t> sequence;
+        };
+
+        std::array<Buffer, 2> buffers;
+        /** @brief index of the buffer readers should read */
+        std::atomic<std::uint32_t> current {0};
+};
+} // namespace lemlib
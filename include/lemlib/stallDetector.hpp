@@ -0,0 +1,82 @@
+/**
+ * @file include/lemlib/stallDetector.hpp
+ * @author LemLib Team
+ * @brief Detects the drivetrain pushing against something it can't move
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+namespace lemlib {
+/**
+ * @brief Settings for stall detection, which ends a motion once the robot is stuck against a wall or a goal
+ *
+ * The robot counts as stalled while the motors are asked for real power, but it moves much slower than that power
+ * would drive it, the IMU, if there is one, feels no acceleration, and either the motors draw most of the current
+ * they would at a standstill or the wheels slip, turning at a good share of the power's speed. It has to stay that
+ * way for the whole time, which rides out the start of a motion, when the robot is still getting up to speed. How
+ * fast the robot moves comes from the IMU where there is one, as wheels slipping against a wall keep turning.
+ *
+ * @param time how long the robot has to be stalled for, in ms. 0 disables stall detection
+ * @param minPower motor power, out of 127, below which the robot never counts as stalled
+ * @param velocityRatio stalled below this share of the speed the power would drive the robot at. The wheels slip
+ * above it
+ * @param currentRatio stalled above this share of the current the motors draw at a standstill with that power
+ * @param maxAcceleration stalled below this acceleration, in g
+ */
+struct StallSettings {
+        int time = 0;
+        float minPower = 30;
+        float velocityRatio = 0.25;
+        float currentRatio = 0.5;
+        float maxAcceleration = 0.15;
+};
+
+/**
+ * @brief Flags the robot as stalled once it has been for long enough, like an ExitCondition
+ *
+ */
+class StallDetector {
+    public:
+        /**
+         * @brief Create a new stall detector
+         *
+         * @param settings the settings
+         */
+        StallDetector(StallSettings settings = StallSettings());
+        /**
+         * @brief whether the robot has stalled
+         *
+         * @return true the robot has been stalled for long enough
+         * @return false it hasn't
+         */
+        bool getExit() const;
+        /**
+         * @brief update the stall detector
+         *
+         * @param power motor power the drivetrain is driven forwards with, out of 127
+         * @param velocity forward velocity of the robot from something that doesn't slip, in inches per second
+         * @param wheelVelocity forward velocity of the robot measured by the drive encoders, in inches per second
+         * @param freeVelocity velocity of the robot at full power with no load, in inches per second
+         * @param current average current drawn by the drivetrain motors, in mA
+         * @param acceleration horizontal acceleration measured by the IMU, in g. 0 without an IMU
+         * @return true the robot has been stalled for long enough
+         * @return false it hasn't
+         */
+        bool update(float power, float velocity, float wheelVelocity, float freeVelocity, float current,
+                    float acceleration);
+        /**
+         * @brief reset the stall detector timer
+         *
+         */
+        void reset();
+    private:
+        const StallSettings settings;
+        int startTime = -1;
+        bool done = false;
+};
+} // namespace lemlib
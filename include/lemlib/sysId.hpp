@@ -0,0 +1,161 @@
+/**
+ * @file include/lemlib/sysId.hpp
+ * @author LemLib Team
+ * @brief Logs of drivetrain characterization tests, and fitting feedforward constants to them
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace lemlib {
+/**
+ * @brief The tests Chassis::characterize runs, in order
+ *
+ * Quasistatic tests ramp the voltage up slowly, so the robot is never accelerating and the velocity shows kS and kV.
+ * Dynamic tests step straight to a voltage, so the robot accelerates hard and the acceleration shows kA. Turning tests
+ * drive the sides in opposite directions, for the angular model.
+ */
+enum class SysIdTest : std::uint8_t {
+    QUASISTATIC_FORWARD,
+    QUASISTATIC_BACKWARD,
+    DYNAMIC_FORWARD,
+    DYNAMIC_BACKWARD,
+    QUASISTATIC_CLOCKWISE,
+    QUASISTATIC_COUNTERCLOCKWISE,
+    DYNAMIC_CLOCKWISE,
+    DYNAMIC_COUNTERCLOCKWISE
+};
+
+/**
+ * @brief Settings for Chassis::characterize
+ *
+ * The defaults drive about 4 feet forwards and back, so the robot needs that much room in front of it
+ *
+ * @param rampRate how fast the quasistatic tests ramp up the voltage, in volts per second
+ * @param quasistaticTime how long each quasistatic test lasts, in seconds
+ * @param stepVoltage voltage of the dynamic tests, in volts
+ * @param dynamicTime how long each dynamic test lasts, in seconds
+ * @param restTime how long to let the robot stop between tests, in seconds
+ */
+struct SysIdSettings {
+        float rampRate = 0.5;
+        float quasistaticTime = 7;
+        float stepVoltage = 7;
+        float dynamicTime = 1.2;
+        float restTime = 1;
+};
+
+/**
+ * @brief One sample of a characterization test, averaged over the motors on each side
+ *
+ */
+struct SysIdSample {
+        /** @brief time the motors took the sample, in milliseconds */
+        std::uint32_t time;
+        SysIdTest test;
+        /** @brief voltage across the motors, in volts */
+        float leftVoltage;
+        float rightVoltage;
+        /** @brief velocity of the wheels, in inches per second */
+        float leftVelocity;
+        float rightVelocity;
+        /** @brief current drawn by one motor, in amps */
+        float leftCurrent;
+        float rightCurrent;
+};
+
+/**
+ * @brief A feedforward model, voltage = kS * sign(velocity) + kV * velocity + kA * acceleration
+ *
+ * The constants are in volts. Multiply them by 127 / 12 to get motor power for ControllerSettings
+ */
+struct SysIdModel {
+        float kS = 0;
+        float kV = 0;
+        float kA = 0;
+        /** @brief fraction of the variation in voltage the model explains. 1 is a perfect fit */
+        float rSquared = 0;
+        /** @brief number of samples the model was fit to. 0 if there weren't enough to fit it */
+        int samples = 0;
+};
+
+/**
+ * @brief The samples of a characterization run, and the binary file they are saved in
+ *
+ * The file is a 12 byte header followed by 18 bytes per sample, little endian, with voltages in millivolts, velocities
+ * in hundredths of an inch per second and currents in milliamps. A full run of the default tests is about 60 kB.
+ */
+class SysIdLog {
+    public:
+        /**
+         * @brief Construct an empty log
+         *
+         * @param trackWidth distance between the left and right wheels, in inches. Needed to fit the angular model
+         */
+        SysIdLog(float trackWidth = 0);
+        /**
+         * @brief Add a sample to the end of the log
+         *
+         * @param sample the sample
+         */
+        void add(const SysIdSample& sample);
+        /**
+         * @brief Save the log
+         *
+         * @param path where to save it. Files on the SD card start with /usd/
+         * @return true if the whole log was written
+         */
+        bool save(const char* path) const;
+        /**
+         * @brief Load a log saved with save
+         *
+         * @param path the file
+         * @return true if the file was a log and was read, false leaves this log as it was
+         */
+        bool load(const char* path);
+        /**
+         * @brief Get the samples
+         *
+         * @return const std::vector<SysIdSample>&
+         */
+        const std::vector<SysIdSample>& getSamples() const;
+        /**
+         * @brief Get the track width the log was taken with
+         *
+         * @return float in inches
+         */
+        float getTrackWidth() const;
+    private:
+        float trackWidth;
+        std::vector<SysIdSample> samples;
+};
+
+/**
+ * @brief Fit the feedforward model of driving straight, with least squares
+ *
+ * Uses the average of the two sides from the forward and backward tests. Acceleration is the change in velocity
+ * between the samples either side, and samples where the robot is barely moving are skipped, since static friction
+ * holds it still there rather than following the model.
+ *
+ * @param log the log
+ * @return SysIdModel velocity in inches per second
+ */
+SysIdModel fitLinear(const SysIdLog& log);
+
+/**
+ * @brief Fit the feedforward model of turning in place, with least squares
+ *
+ * Uses half the difference between the two sides from the turning tests, which is the angular output of a motion.
+ *
+ * @param log the log. Its track width must be set
+ * @return SysIdModel velocity in degrees per second, clockwise positive
+ */
+SysIdModel fitAngular(const SysIdLog& log);
+} // namespace lemlib
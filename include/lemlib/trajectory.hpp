@@ -0,0 +1,117 @@
+/**
+ * @file include/lemlib/trajectory.hpp
+ * @author LemLib Team
+ * @brief Time-parameterized trajectories along a path, planned at the limits of the drivetrain
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "lemlib/pose.hpp"
+
+namespace lemlib {
+/**
+ * @brief Limits on how fast a trajectory may drive the robot
+ *
+ * Velocity and acceleration limits apply to each wheel, so the outer wheel of a turn is what limits the robot. Units
+ * are inches and seconds
+ */
+struct TrajectoryConstraints {
+        /** @brief maximum velocity of either wheel. 0 uses the free speed of the drivetrain */
+        float maxVelocity = 0;
+        /** @brief maximum acceleration of either wheel, also used for deceleration. 0 disables trajectories */
+        float maxAcceleration = 0;
+        /** @brief maximum sideways acceleration in turns, before the wheels slide. 0 for no limit */
+        float maxCentripetal = 0;
+};
+
+/**
+ * @brief Where a trajectory says the robot should be at some time
+ *
+ * Angles follow the standard convention, in radians: 0 faces +x and positive is counter-clockwise, so a positive
+ * curvature turns left
+ */
+struct TrajectoryPoint {
+        /** @brief time since the start of the trajectory, in seconds */
+        float time;
+        /** @brief distance along the path, in inches */
+        float distance;
+        float x;
+        float y;
+        float theta;
+        /** @brief 1 / turning radius, in 1 / inches */
+        float curvature;
+        /** @brief velocity along the path, in inches per second */
+        float velocity;
+        /** @brief acceleration along the path, in inches per second squared */
+        float acceleration;
+};
+
+/**
+ * @brief A path with a velocity for every point, and the time the robot reaches it
+ *
+ * The fastest velocity at every point is found from the curvature of the path: the outer wheel can't go faster than
+ * the max velocity, and the robot can't turn harder than the max centripetal acceleration. A forward pass then limits
+ * how quickly each point can be reached from the one before, starting from rest, and a backward pass limits how
+ * quickly each point can stop by the one after, ending at rest. What is left is the fastest motion along the path
+ * the constraints allow, and integrating it gives the time of each point.
+ *
+ * Planning is linear in the number of points, and is done once before the robot moves.
+ */
+class Trajectory {
+    public:
+        /**
+         * @brief Construct an empty trajectory
+         *
+         */
+        Trajectory() = default;
+        /**
+         * @brief Plan a trajectory along a path
+         *
+         * @param path the points of the path. Theta is ignored
+         * @param trackWidth distance between the left and right wheels, in inches
+         * @param constraints the limits. The max velocity must be set
+         */
+        Trajectory(const std::vector<Pose>& path, float trackWidth, TrajectoryConstraints constraints);
+        /**
+         * @brief Get where the trajectory is at a given time, between its points
+         *
+         * @param time time since the start of the trajectory, in seconds
+         * @return TrajectoryPoint the first point before the start, the last point after the end
+         */
+        TrajectoryPoint sample(float time) const;
+        /**
+         * @brief Get one of the points of the trajectory
+         *
+         * @param index the index, which matches the index of the point in the path
+         * @return const TrajectoryPoint&
+         */
+        const TrajectoryPoint& at(std::size_t index) const;
+        /**
+         * @brief Get the number of points
+         *
+         * @return std::size_t
+         */
+        std::size_t size() const;
+        /**
+         * @brief Get how long the trajectory takes
+         *
+         * @return float in seconds
+         */
+        float getDuration() const;
+        /**
+         * @brief Get the length of the path
+         *
+         * @return float in inches
+         */
+        float getLength() const;
+    private:
+        std::vector<TrajectoryPoint> points;
+};
+} // namespace lemlib
@@ -68,6 +68,7 @@ void CloseSideAuton(void);
 void SkillsAuton(void);
 void autonomous(void);
 void initialize(void);
+void simSettings(void);
 void disabled(void);
 void competition_initialize(void);
 void opcontrol(void);
@@ -17,9 +17,16 @@
 
 #include <stdarg.h>   
 #include <stdbool.h>  
+// g++ already defines _GNU_SOURCE, and undefining it after stdio.h would take it away from what follows
+#ifndef _GNU_SOURCE
 #define _GNU_SOURCE
+#define _PROS_SCREEN_GNU_SOURCE_
+#endif
 #include <stdio.h>  
+#ifdef _PROS_SCREEN_GNU_SOURCE_
 #undef _GNU_SOURCE
+#undef _PROS_SCREEN_GNU_SOURCE_
+#endif
 #include <stdint.h>
 
 #include "pros/colors.h"     // c color macros
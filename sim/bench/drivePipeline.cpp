@@ -0,0 +1,111 @@
+/**
+ * @file sim/bench/drivePipeline.cpp
+ * @brief Times one control tick through the old type-erased path and through a compile-time ControlPipeline
+ *
+ * Two ticks are timed, each driving both sides of the drivetrain in src/main.cpp. The driver tick bends a joystick
+ * input with the default drive curve and sends the power to the motors, once through DriveCurveFunction_t and
+ * pros::Motor_Group::move, and once through a DriveCurveTable looked up by ControlPipeline<CurveLookup, ...> and
+ * MotorPorts. The motion tick runs an error through a PID, a slew limit and the mapping to millivolts, once through
+ * PID::update, slew, a lambda and pros::Motor_Group::move_voltage, and once through ControlPipeline<NoShaping,
+ * PIDStage, SlewLimit, VoltageOutput>.
+ * Each tick is its own noinline function, and `make -C sim bench` prints their code sizes after the timings. The
+ * old path also calls into defaultDriveCurve and the motor group, which its size doesn't include.
+ * On the brain, pros::Motor_Group also takes a mutex for every command, which the simulated one doesn't.
+ *
+ * Usage: drive-pipeline-bench [iterations]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "lemlib/api.hpp"
+
+extern lemlib::Drivetrain drivetrain;
+
+namespace {
+/** @brief drive curve gain for the driver tick */
+constexpr float CURVE_GAIN = 3;
+/** @brief largest change in power per tick for the motion tick */
+constexpr float SLEW = 5;
+
+/** @brief a joystick sweeping back and forth, so every tick gets a different input */
+float input(long i) { return float(i % 255 - 127); }
+
+__attribute__((noinline)) void driverTickStdFunction(const lemlib::DriveCurveFunction_t& curve, long i) {
+    drivetrain.leftMotors->move(curve(input(i), CURVE_GAIN));
+    drivetrain.rightMotors->move(curve(-input(i), CURVE_GAIN));
+}
+
+/** @brief the default drive curve at CURVE_GAIN, baked at compile time */
+constexpr lemlib::DriveCurveTable CURVE_TABLE(lemlib::ExpoCurve {CURVE_GAIN});
+
+using DrivePipeline = lemlib::ControlPipeline<lemlib::CurveLookup, lemlib::Passthrough, lemlib::NoLimit,
+                                              lemlib::PowerOutput>;
+
+__attribute__((noinline)) void driverTickPipeline(DrivePipeline& pipeline, const lemlib::MotorPorts& left,
+                                                  const lemlib::MotorPorts& right, long i) {
+    left.move(pipeline.update(input(i)));
+    right.move(pipeline.update(-input(i)));
+}
+
+/** @brief state of the old motion tick */
+struct MotionTick {
+        lemlib::PID pid {10, 0, 30, 0, true};
+        float prevOut = 0;
+};
+
+__attribute__((noinline)) void motionTickStdFunction(MotionTick& tick, long i) {
+    const float scale = 1.05;
+    auto millivolts = [scale](float power) {
+        return int32_t(std::clamp(power * 12000 / 127 * scale, -12000.0f, 12000.0f));
+    };
+    float out = tick.pid.update(input(i) / 10, 0.01);
+    out = lemlib::slew(out, tick.prevOut, SLEW);
+    tick.prevOut = out;
+    drivetrain.leftMotors->move_voltage(millivolts(out));
+    drivetrain.rightMotors->move_voltage(millivolts(-out));
+}
+
+using MotionPipeline = lemlib::ControlPipeline<lemlib::NoShaping, lemlib::PIDStage, lemlib::SlewLimit,
+                                               lemlib::VoltageOutput>;
+
+__attribute__((noinline)) void motionTickPipeline(MotionPipeline& pipeline, const lemlib::MotorPorts& left,
+                                                  const lemlib::MotorPorts& right, long i) {
+    const int32_t millivolts = pipeline.update(input(i) / 10, 0.01);
+    left.moveVoltage(millivolts);
+    right.moveVoltage(-millivolts);
+}
+
+/** @brief time a tick, in ns per tick */
+template <typename Tick> double timeTick(long iterations, Tick tick) {
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++) tick(i);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    const long iterations = argc > 1 ? std::atol(argv[1]) : 2000000;
+    const lemlib::MotorPorts left(drivetrain.leftMotors->get_ports());
+    const lemlib::MotorPorts right(drivetrain.rightMotors->get_ports());
+
+    const lemlib::DriveCurveFunction_t curve = &lemlib::defaultDriveCurve;
+    DrivePipeline drivePipeline;
+    drivePipeline.shaping.table = &CURVE_TABLE;
+    MotionTick motionTick;
+    MotionPipeline motionPipeline {{}, {lemlib::PID(10, 0, 30, 0, true)}, {SLEW}, {1.05}};
+
+    const double driverOld = timeTick(iterations, [&](long i) { driverTickStdFunction(curve, i); });
+    const double driverNew = timeTick(iterations, [&](long i) { driverTickPipeline(drivePipeline, left, right, i); });
+    const double motionOld = timeTick(iterations, [&](long i) { motionTickStdFunction(motionTick, i); });
+    const double motionNew = timeTick(iterations, [&](long i) { motionTickPipeline(motionPipeline, left, right, i); });
+
+    std::printf("iterations:   %ld, %d + %d motors\n", iterations, int(drivetrain.leftMotors->size()),
+                int(drivetrain.rightMotors->size()));
+    std::printf("driver tick:  %.1f ns std::function + Motor_Group, %.1f ns table pipeline + MotorPorts\n", driverOld,
+                driverNew);
+    std::printf("motion tick:  %.1f ns PID + slew + Motor_Group, %.1f ns pipeline + MotorPorts\n", motionOld,
+                motionNew);
+    return 0;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file sim/bench/ekf.cpp
+ * @brief Times one update of the pose estimator on the host
+ *
+ * Each iteration does what the tracking task does every update with a full sensor set: a prediction, two vertical
+ * and one horizontal tracking wheel, two drive sides, IMU heading and yaw rate, and a GPS fix. The V5 brain's
+ * Cortex-A9 is roughly 10-20x slower than a desktop core, which still leaves the update far inside its 10 ms budget.
+ *
+ * Usage: ekf-bench [iterations]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "lemlib/chassis/ekf.hpp"
+
+namespace {
+/** @brief the results are written here, so the compiler can't leave out the work that makes them */
+volatile float sink = 0;
+} // namespace
+
+int main(int argc, char** argv) {
+    const long iterations = argc > 1 ? std::atol(argv[1]) : 1000000;
+    lemlib::Ekf ekf;
+    const lemlib::EkfSettings& settings = ekf.getSettings();
+
+    // drive an arc so the filter does real work instead of sitting at rest
+    constexpr float dt = 0.005;
+    constexpr float speed = 40;
+    constexpr float omega = 1.5;
+    float x = 0, y = 0, theta = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++) {
+        x += speed * std::sin(theta) * dt;
+        y += speed * std::cos(theta) * dt;
+        theta += omega * dt;
+        ekf.predict(dt);
+        ekf.updateWheel(speed - 1 * omega, 1, false, settings.trackingWheelNoise);
+        ekf.updateWheel(speed + 1 * omega, -1, false, settings.trackingWheelNoise);
+        ekf.updateWheel(3.7 * omega, -3.7, true, settings.trackingWheelNoise);
+        ekf.updateWheel(speed + 6 * omega, -6, false, settings.motorEncoderNoise);
+        ekf.updateWheel(speed - 6 * omega, 6, false, settings.motorEncoderNoise);
+        ekf.updateHeading(theta, settings.imuHeadingNoise);
+        ekf.updateAngularVelocity(omega, settings.gyroNoise);
+        ekf.updatePosition(x, y, 0.5);
+        sink = ekf.getPose().x;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const lemlib::Pose pose = ekf.getPose();
+    std::printf("iterations:   %ld\n", iterations);
+    std::printf("per update:   %.3f us\n", seconds * 1e6 / iterations);
+    std::printf("final error:  %.4f in, %.5f rad\n", std::hypot(pose.x - x, pose.y - y), pose.theta - theta);
+    return 0;
+}
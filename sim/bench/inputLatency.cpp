@@ -0,0 +1,159 @@
+/**
+ * @file sim/bench/inputLatency.cpp
+ * @brief Measures how long opcontrol takes to act on the controller while the pneumatics are toggled, in virtual time
+ *
+ * A scripted driver taps A, which toggles the back wings, and 40 ms later flips the left stick from full forwards to
+ * full backwards or back. Each tap is timed from the press to the solenoid changing, and each flip from the stick
+ * moving to the left drive motors being told to go the other way. This runs once with the old opcontrol loop, which
+ * waited out each toggle with pros::delay(500), and once with opcontrol in src/main.cpp, which uses InputManager.
+ *
+ * Usage: input-latency-bench [taps]
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "main.h"
+#include "lemlib/api.hpp"
+#include "sim/devices.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+
+extern lemlib::Drivetrain drivetrain;
+extern lemlib::Chassis chassis;
+extern pros::Controller controller;
+extern pros::ADIDigitalOut backWingsL;
+extern pros::ADIDigitalOut backWingsR;
+
+namespace {
+/** @brief time between taps, in ms */
+constexpr uint32_t PERIOD = 1000;
+/** @brief how long a tap holds the button down, in ms */
+constexpr uint32_t TAP = 80;
+/** @brief time from the press to the stick flipping, in ms */
+constexpr uint32_t FLIP = 40;
+
+/** @brief how late opcontrol acted on each tap and flip, in ms */
+struct Latencies {
+        std::vector<uint32_t> toggle;
+        std::vector<uint32_t> drive;
+};
+
+/** @brief the opcontrol loop before InputManager, cut down to the drive and the back wings */
+void oldOpcontrol() {
+    bool toggleBackWings = false;
+    while (true) {
+        int leftY = controller.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y);
+        int rightX = controller.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y);
+        chassis.tank(leftY, rightX);
+
+        if (controller.get_digital(pros::E_CONTROLLER_DIGITAL_A)) {
+            toggleBackWings = !toggleBackWings;
+            backWingsL.set_value(toggleBackWings);
+            backWingsR.set_value(toggleBackWings);
+            pros::delay(500);
+        }
+
+        pros::delay(10);
+    }
+}
+
+/** @brief mean and largest of some latencies */
+void report(const char* name, const std::vector<uint32_t>& latencies) {
+    double sum = 0;
+    for (const uint32_t latency : latencies) sum += latency;
+    const uint32_t worst = latencies.empty() ? 0 : *std::max_element(latencies.begin(), latencies.end());
+    std::printf("%-22s %6.1f ms mean, %4u ms max\n", name, latencies.empty() ? 0 : sum / latencies.size(), worst);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    const int taps = argc > 1 ? std::atoi(argv[1]) : 10;
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    std::ostream null(nullptr);
+    std::cout.rdbuf(null.rdbuf());
+
+    sim::DrivetrainConfig config;
+    config.leftPorts = drivetrain.leftMotors->get_ports();
+    config.rightPorts = drivetrain.rightMotors->get_ports();
+    config.trackWidth = drivetrain.trackWidth;
+    config.wheelDiameter = drivetrain.wheelDiameter;
+    config.wheelRpm = drivetrain.rpm;
+    sim::Robot robot(config);
+    const uint8_t leftPort = config.leftPorts.front();
+
+    // the script, from when it starts
+    sim::Controller& master = sim::devices().master;
+    uint32_t scriptStart = 0;
+    bool running = false;
+    uint32_t flipTime = 0;
+    float stick = 0;
+    Latencies* latencies = nullptr;
+    scheduler.addTickHook([&](uint32_t time) {
+        robot.step(0.001);
+        sim::devices().sample(time);
+        if (!running) return;
+        const uint32_t t = (time - scriptStart) % PERIOD;
+        if ((time - scriptStart) / PERIOD >= uint32_t(taps)) {
+            running = false;
+            master.digital[pros::E_CONTROLLER_DIGITAL_A] = false;
+            return;
+        }
+        master.digital[pros::E_CONTROLLER_DIGITAL_A] = t < TAP;
+        if (t == FLIP) {
+            stick = stick > 0 ? -127 : 127;
+            master.analog[pros::E_CONTROLLER_ANALOG_LEFT_Y] = stick;
+            flipTime = time;
+        }
+        // the drive has caught up once the left motors are told to go the way of the stick
+        const double target = sim::devices().motors[leftPort].target;
+        if (flipTime != 0 && target * stick > 0) {
+            latencies->drive.push_back(time - flipTime);
+            flipTime = 0;
+        }
+    });
+
+    pros::Task initTask([] {
+        initialize();
+        simSettings();
+    }, "initialize");
+    initTask.join();
+    chassis.setPose(0, 0, 0);
+    pros::delay(20);
+
+    Latencies old;
+    Latencies current;
+    for (Latencies* run : {&old, &current}) {
+        latencies = run;
+        master.analog[pros::E_CONTROLLER_ANALOG_LEFT_Y] = 0;
+        stick = 0;
+        flipTime = 0;
+        sim::devices().digitalEvents.clear();
+        pros::Task driver(run == &old ? oldOpcontrol : opcontrol, "driver");
+        pros::delay(PERIOD / 2);
+        scriptStart = pros::millis();
+        running = true;
+        while (running) pros::delay(10);
+        pros::delay(PERIOD);
+        driver.remove();
+
+        // each tap should toggle both solenoids once, so only the first change after a tap counts
+        uint32_t lastTap = 0;
+        for (const sim::DigitalEvent& event : sim::devices().digitalEvents) {
+            if (event.time < scriptStart) continue;
+            const uint32_t tap = (event.time - scriptStart) / PERIOD * PERIOD + scriptStart;
+            if (tap == lastTap || event.time - tap >= PERIOD / 2) continue;
+            run->toggle.push_back(event.time - tap);
+            lastTap = tap;
+        }
+    }
+
+    std::printf("taps:                  %d, stick flipped %u ms after each press\n", taps, FLIP);
+    report("delay(500) toggles", old.toggle);
+    report("  drive after a tap", old.drive);
+    report("InputManager toggles", current.toggle);
+    report("  drive after a tap", current.drive);
+    return 0;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file sim/bench/relocalizer.cpp
+ * @brief Times the ray casting the relocalizer does on every update, on the host
+ *
+ * One iteration casts a ray for every particle and every sensor against the field perimeter, which is the bulk of
+ * a relocalizer update. The batch is also checked against casting the rays one at a time.
+ *
+ * Usage: relocalizer-bench [iterations] [particles] [sensors]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "lemlib/chassis/relocalizer.hpp"
+
+namespace {
+/** @brief the results are written here, so the compiler can't leave out the work that makes them */
+volatile float sink = 0;
+} // namespace
+
+int main(int argc, char** argv) {
+    const long iterations = argc > 1 ? std::atol(argv[1]) : 10000;
+    const std::size_t particles = argc > 2 ? std::atol(argv[2]) : 300;
+    const int sensors = argc > 3 ? std::atoi(argv[3]) : 3;
+    const lemlib::FieldModel field = lemlib::FieldModel::perimeter();
+
+    // a cloud of particles somewhere on the field, facing every which way
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(-60, 60);
+    std::uniform_real_distribution<float> heading(-M_PI, M_PI);
+    std::vector<float> x(particles), y(particles), theta(particles), s(particles), c(particles), out(particles);
+    for (std::size_t i = 0; i < particles; i++) {
+        x[i] = position(rng);
+        y[i] = position(rng);
+        theta[i] = heading(rng);
+        s[i] = std::sin(theta[i]);
+        c[i] = std::cos(theta[i]);
+    }
+
+    float worst = 0;
+    field.castRays(particles, x.data(), y.data(), s.data(), c.data(), out.data());
+    for (std::size_t i = 0; i < particles; i++) {
+        worst = std::fmax(worst, std::fabs(out[i] - field.castRay(x[i], y[i], theta[i])));
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++) {
+        for (int j = 0; j < sensors; j++) {
+            field.castRays(particles, x.data(), y.data(), s.data(), c.data(), out.data());
+            sink = out[j];
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("particles:    %zu, %d sensors, %zu walls\n", particles, sensors, field.size());
+    std::printf("per update:   %.3f us\n", seconds * 1e6 / iterations);
+    std::printf("per ray:      %.3f ns\n", seconds * 1e9 / iterations / sensors / particles);
+    std::printf("batch error:  %.6f in\n", worst);
+    return 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file sim/bench/turnSettle.cpp
+ * @brief Times how long turnTo takes to settle with different angular PID settings, with and without a jittery loop
+ *
+ * The robot turns in place through the same series of headings once for each PID setup, first with every control
+ * cycle exactly 10 ms long, then with pros::delay oversleeping by up to the given jitter. The setups are the per
+ * update PID that ignores the time step, the one that scales by the measured time step, and the one that also
+ * low-passes the derivative and limits the output, like simSettings. Each runs with the kD in src/main.cpp and a
+ * higher one, which the filtered derivative can take.
+ * Settling is timed from the simulated robot: how long until its true heading stays within a degree of the target.
+ *
+ * Usage: turn-settle-bench [jitter ms] [high kD]
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "main.h"
+#include "lemlib/api.hpp"
+#include "sim/devices.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+
+extern lemlib::Drivetrain drivetrain;
+extern lemlib::ControllerSettings angularController;
+extern lemlib::Chassis chassis;
+
+namespace {
+/** @brief headings to turn to, in order, in degrees */
+constexpr float HEADINGS[] = {90, 180, 45, 270, 0, 135, 315, 0};
+/** @brief how close the true heading has to stay to count as settled, in degrees */
+constexpr float SETTLED = 1;
+/** @brief how long after a turn ends to keep watching the heading, in ms */
+constexpr uint32_t WATCH = 300;
+
+/** @brief one way of running the angular PID */
+struct Setup {
+        const char* kind;
+        lemlib::PIDSettings settings;
+        float kD;
+};
+
+/** @brief how a series of turns went */
+struct Result {
+        double turnTime = 0;
+        double settleTime = 0;
+        double overshoot = 0;
+        double error = 0;
+};
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint32_t jitter = argc > 1 ? std::atoi(argv[1]) : 6;
+    const float highKD = argc > 2 ? std::atof(argv[2]) : 35;
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    std::ostream null(nullptr);
+    std::cout.rdbuf(null.rdbuf());
+
+    sim::DrivetrainConfig config;
+    config.leftPorts = drivetrain.leftMotors->get_ports();
+    config.rightPorts = drivetrain.rightMotors->get_ports();
+    config.trackWidth = drivetrain.trackWidth;
+    config.wheelDiameter = drivetrain.wheelDiameter;
+    config.wheelRpm = drivetrain.rpm;
+    sim::Robot robot(config);
+
+    // the heading error of the robot through the turn being watched, one sample per ms
+    std::vector<float> errors;
+    float target = 0;
+    bool watching = false;
+    scheduler.addTickHook([&](uint32_t time) {
+        robot.step(0.001);
+        sim::devices().sample(time);
+        if (watching) errors.push_back(std::remainder(robot.state().theta - target, 360));
+    });
+
+    pros::Task initTask([] {
+        initialize();
+        simSettings();
+    }, "initialize");
+    initTask.join();
+    chassis.setPose(0, 0, 0);
+    pros::delay(20);
+
+    lemlib::PIDSettings filtered;
+    filtered.derivativeCutoff = 25;
+    filtered.maxOutput = 127;
+    lemlib::PIDSettings perUpdate;
+    perUpdate.period = 0;
+    const Setup setups[] = {
+        {"per update", perUpdate, angularController.kD},          {"per update", perUpdate, highKD},
+        {"dt-aware", lemlib::PIDSettings(), angularController.kD}, {"dt-aware", lemlib::PIDSettings(), highKD},
+        {"filtered", filtered, angularController.kD},             {"filtered", filtered, highKD},
+    };
+
+    std::printf("%-19s %-6s %-12s %-12s %-14s %s\n", "angular PID", "jitter", "turn (ms)", "settle (ms)",
+                "overshoot (deg)", "error (deg)");
+    for (const uint32_t delayJitter : {0u, jitter}) {
+        for (const Setup& setup : setups) {
+            chassis.setPIDSettings(lemlib::PIDSettings(), setup.settings);
+            chassis.setAngularGains({angularController.kP, angularController.kI, setup.kD});
+            scheduler.setDelayJitter(delayJitter, 1);
+            Result result;
+            for (const float heading : HEADINGS) {
+                const lemlib::Pose pose = chassis.getPose();
+                target = heading;
+                errors.clear();
+                watching = true;
+                const uint32_t start = pros::millis();
+                chassis.turnTo(pose.x + 24 * std::sin(lemlib::degToRad(heading)),
+                               pose.y + 24 * std::cos(lemlib::degToRad(heading)), 2000);
+                chassis.waitUntilDone();
+                result.turnTime += pros::millis() - start;
+                result.error += std::fabs(errors.back());
+                pros::delay(WATCH);
+                watching = false;
+
+                // settled once the heading stays close, and overshoot is how far it swung past the target
+                std::size_t settled = errors.size();
+                while (settled > 0 && std::fabs(errors[settled - 1]) < SETTLED) settled--;
+                result.settleTime += settled;
+                const float side = errors.front() < 0 ? 1 : -1;
+                float overshoot = 0;
+                for (const float error : errors) overshoot = std::max(overshoot, side * error);
+                result.overshoot = std::max<double>(result.overshoot, overshoot);
+            }
+            const std::size_t turns = sizeof(HEADINGS) / sizeof(HEADINGS[0]);
+            std::printf("%-10s kD %-6g %-6u %-12.0f %-12.0f %-14.2f %.2f\n", setup.kind, setup.kD, delayJitter,
+                        result.turnTime / turns, result.settleTime / turns, result.overshoot, result.error / turns);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file sim/bench/waitLatency.cpp
+ * @brief Measures how late Chassis::waitUntil wakes the task waiting on it, in virtual time
+ *
+ * The robot drives straight ahead while one task waits on a series of distances with waitUntil, and another waits on
+ * the same distances by checking the published chassis state every 10 ms, the way waitUntil used to. The same
+ * distances also get an action each with atDistance, as many as there is room for. All three are timed against when
+ * the simulated robot actually got that far, and the report also counts how many times each waiting task ran.
+ * Odometry can run a little ahead of the robot, so a wake can come a millisecond or two early.
+ *
+ * Usage: wait-latency-bench [distance] [step]
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "main.h"
+#include "lemlib/api.hpp"
+#include "sim/devices.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+
+extern lemlib::Drivetrain drivetrain;
+extern lemlib::Chassis chassis;
+
+namespace {
+/** @brief when each waiter woke, in virtual ms, and how many times it ran */
+struct Waiter {
+        /** @brief 0 for the distances it didn't wait on */
+        std::vector<uint32_t> wakes;
+        uint64_t slices = 0;
+};
+
+/** @brief mean and largest of how late a waiter woke */
+void report(const char* name, const Waiter& waiter, const std::vector<uint32_t>& reached) {
+    double sum = 0;
+    int worst = 0;
+    int count = 0;
+    for (std::size_t i = 0; i < reached.size(); i++) {
+        if (waiter.wakes[i] == 0) continue;
+        const int late = int(waiter.wakes[i]) - int(reached[i]);
+        sum += late;
+        worst = std::max(worst, late);
+        count++;
+    }
+    std::printf("%-10s %6.1f ms mean, %3d ms max", name, count > 0 ? sum / count : 0, worst);
+    if (waiter.slices != 0) std::printf(", %5lu task slices", (unsigned long)waiter.slices);
+    std::printf("\n");
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    const float distance = argc > 1 ? std::atof(argv[1]) : 48;
+    const float step = argc > 2 ? std::atof(argv[2]) : 4;
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    std::ostream null(nullptr);
+    std::cout.rdbuf(null.rdbuf());
+
+    sim::DrivetrainConfig config;
+    config.leftPorts = drivetrain.leftMotors->get_ports();
+    config.rightPorts = drivetrain.rightMotors->get_ports();
+    config.trackWidth = drivetrain.trackWidth;
+    config.wheelDiameter = drivetrain.wheelDiameter;
+    config.wheelRpm = drivetrain.rpm;
+    sim::Robot robot(config);
+
+    std::vector<float> thresholds;
+    for (float d = step; d < distance - step / 2; d += step) thresholds.push_back(d);
+    std::vector<uint32_t> reached;
+    double startDistance = -1;
+    scheduler.addTickHook([&](uint32_t time) {
+        robot.step(0.001);
+        sim::devices().sample(time);
+        // the robot's own distance from where it was when the motion started
+        if (startDistance < 0 || reached.size() == thresholds.size()) return;
+        if (robot.state().distance - startDistance > thresholds[reached.size()]) reached.push_back(time);
+    });
+
+    pros::Task initTask([] {
+        initialize();
+        simSettings();
+    }, "initialize");
+    initTask.join();
+    chassis.setPose(0, 0, 0);
+    pros::delay(20);
+
+    startDistance = robot.state().distance;
+    chassis.moveToPoint(0, distance, 5000);
+    Waiter event, poll, action;
+    event.wakes.resize(thresholds.size());
+    poll.wakes.resize(thresholds.size());
+    action.wakes.resize(thresholds.size());
+    // there is only room for so many actions
+    for (std::size_t i = 0; i < thresholds.size(); i++) {
+        chassis.atDistance(thresholds[i], [&action, i] { action.wakes[i] = pros::millis(); });
+    }
+    pros::Task eventTask([&] {
+        for (std::size_t i = 0; i < thresholds.size(); i++) {
+            chassis.waitUntil(thresholds[i]);
+            event.wakes[i] = pros::millis();
+        }
+        event.slices = scheduler.current()->slices;
+    }, "event");
+    pros::Task pollTask([&] {
+        for (std::size_t i = 0; i < thresholds.size(); i++) {
+            float travelled;
+            do {
+                pros::delay(10);
+                travelled = chassis.getState().distTravelled;
+            } while (travelled <= thresholds[i] && travelled != -1);
+            poll.wakes[i] = pros::millis();
+        }
+        poll.slices = scheduler.current()->slices;
+    }, "poll");
+    eventTask.join();
+    pollTask.join();
+    chassis.waitUntilDone();
+
+    if (reached.size() != thresholds.size()) {
+        std::fprintf(stderr, "the robot only got %zu of %zu distances\n", reached.size(), thresholds.size());
+        return 1;
+    }
+    std::printf("distances:  %zu, every %.1f in up to %.1f in\n", thresholds.size(), step, distance);
+    report("waitUntil", event, reached);
+    report("polling", poll, reached);
+    report("atDistance", action, reached);
+    return 0;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file sim/bench/wallStall.cpp
+ * @brief Checks that stall detection ends a motion driven into a wall, even with the wheels slipping against it
+ *
+ * The robot runs the last motion of the skills routine in src/main.cpp, moveToPose(-10, -200, 180, 9000), which aims
+ * far past the back wall. It runs once from where skills starts it, so the robot hits the wall at speed, and once
+ * from against the wall, so it pushes from a standstill. Each runs with the stall settings from simSettings, and then
+ * with stall detection off for comparison. The wheels slip against the wall, so odometry runs on past it for as long
+ * as the motion pushes.
+ * Exits with 1 if stall detection didn't end a motion that it was on for.
+ *
+ * Usage: wall-stall-bench [friction]
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include "main.h"
+#include "lemlib/api.hpp"
+#include "sim/devices.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+
+extern lemlib::Drivetrain drivetrain;
+extern lemlib::Chassis chassis;
+
+namespace {
+/** @brief timeout of the motion, in ms */
+constexpr int TIMEOUT = 9000;
+/** @brief distance from the center of the field to the inside of each wall, as in sim/src/robot.cpp, in inches */
+constexpr float FIELD_HALF_SIZE = 70.2;
+
+/** @brief a place to start the motion from */
+struct Start {
+        const char* name;
+        float y;
+};
+
+/** @brief how a motion went */
+struct Result {
+        uint32_t time = 0;
+        bool stalled = false;
+        double odomError = 0;
+};
+} // namespace
+
+int main(int argc, char** argv) {
+    const double friction = argc > 1 ? std::atof(argv[1]) : sim::DrivetrainConfig().friction;
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    std::ostream null(nullptr);
+    std::cout.rdbuf(null.rdbuf());
+
+    sim::DrivetrainConfig config;
+    config.leftPorts = drivetrain.leftMotors->get_ports();
+    config.rightPorts = drivetrain.rightMotors->get_ports();
+    config.trackWidth = drivetrain.trackWidth;
+    config.wheelDiameter = drivetrain.wheelDiameter;
+    config.wheelRpm = drivetrain.rpm;
+    config.friction = friction;
+    sim::Robot robot(config);
+    scheduler.addTickHook([&](uint32_t time) {
+        robot.step(0.001);
+        sim::devices().sample(time);
+    });
+
+    pros::Task initTask([] {
+        initialize();
+        simSettings();
+    }, "initialize");
+    initTask.join();
+
+    // where skills starts the motion, and backed up against the wall
+    const float wall = -(FIELD_HALF_SIZE - config.halfSize);
+    const Start starts[] = {{"from y -10", -10}, {"against the wall", wall}};
+    auto run = [&](const Start& start) {
+        robot.setPose(-10, start.y, 180);
+        chassis.setPose(-10, start.y, 180);
+        pros::delay(200);
+        Result result;
+        const uint32_t stalls = chassis.getState().stalls;
+        const uint32_t begin = pros::millis();
+        chassis.moveToPose(-10, -200, 180, TIMEOUT);
+        chassis.waitUntilDone();
+        result.time = pros::millis() - begin;
+        result.stalled = chassis.getState().stalls != stalls;
+        const lemlib::Pose pose = chassis.getPose();
+        result.odomError = std::hypot(pose.x - robot.state().x, pose.y - robot.state().y);
+        return result;
+    };
+
+    std::printf("friction:           %g\n", friction);
+    std::printf("%-18s %-14s %-12s %s\n", "start", "detection", "time (ms)", "odom error (in)");
+    bool missed = false;
+    for (const bool detection : {true, false}) {
+        if (!detection) chassis.setStallSettings({0});
+        for (const Start& start : starts) {
+            const Result result = run(start);
+            std::printf("%-18s %-14s %-12u %.1f%s\n", start.name, detection ? "on" : "off", result.time,
+                        result.odomError, result.stalled ? ", stalled" : "");
+            if (detection && !result.stalled) missed = true;
+        }
+    }
+    if (missed) std::printf("stall detection didn't end every motion into the wall\n");
+    return missed ? 1 : 0;
+}
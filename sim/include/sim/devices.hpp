@@ -0,0 +1,308 @@
+/**
+ * @file sim/include/sim/devices.hpp
+ * @brief State of the simulated V5 devices
+ *
+ * The simulated PROS API reads and writes these structs instead of talking to real hardware. Each device keeps its
+ * true state, which is written by the robot model, and the last sample it reported, which is what user code sees.
+ * Samples are taken at the device data rate, just like the V5 brain receives them over the smart port.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "pros/adi.h"
+#include "pros/misc.h"
+#include "pros/motors.h"
+
+namespace sim {
+/** @brief number of smart ports on the brain. The internal ADI expander uses port 22 */
+constexpr int NUM_PORTS = 22;
+
+/**
+ * @brief Free speed of a V5 motor cartridge
+ *
+ * @param gearset the cartridge
+ * @return double rpm
+ */
+double cartridgeRpm(pros::motor_gearset_e_t gearset);
+
+/**
+ * @brief Encoder ticks per output revolution of a V5 motor cartridge
+ *
+ * @param gearset the cartridge
+ * @return double ticks
+ */
+double cartridgeTicks(pros::motor_gearset_e_t gearset);
+
+/**
+ * @brief Simulated V5 smart motor
+ *
+ * Positions and velocities are stored in the direction set by the user, so a reversed motor reports positive
+ * position when it is commanded forwards.
+ */
+struct Motor {
+        /** @brief how the motor is currently being commanded */
+        enum class Mode { VOLTAGE, VELOCITY, POSITION, BRAKE };
+
+        pros::motor_gearset_e_t gearset = pros::E_MOTOR_GEARSET_18;
+        pros::motor_encoder_units_e_t units = pros::E_MOTOR_ENCODER_DEGREES;
+        pros::motor_brake_mode_e_t brakeMode = pros::E_MOTOR_BRAKE_COAST;
+        bool reversed = false;
+        int32_t currentLimit = 2500;
+        int32_t voltageLimit = 0;
+
+        Mode mode = Mode::VOLTAGE;
+        /** @brief target voltage in mV, target velocity in rpm, or target position in degrees */
+        double target = 0;
+        /** @brief maximum velocity while moving to a target position, in rpm */
+        double profileVelocity = 0;
+
+        /** @brief output shaft position, in degrees */
+        double position = 0;
+        /** @brief output shaft velocity, in rpm */
+        double velocity = 0;
+        /** @brief current draw, in mA */
+        double current = 0;
+        /** @brief voltage applied to the windings, in mV */
+        double voltage = 0;
+        /** @brief output torque, in Nm */
+        double torque = 0;
+        /** @brief position reported as 0, in degrees */
+        double zero = 0;
+
+        /** @brief what the motor last reported to the brain */
+        struct Sample {
+                double position = 0;
+                double velocity = 0;
+                double current = 0;
+                double voltage = 0;
+                double torque = 0;
+                uint32_t timestamp = 0;
+        } sample;
+
+        /**
+         * @brief Voltage the motor controller wants to apply this tick, before battery and limit clamping
+         *
+         * @return double mV
+         */
+        double commandedVoltage() const;
+};
+
+/**
+ * @brief Simulated V5 inertial sensor
+ *
+ */
+struct Imu {
+        /** @brief time at which calibration finishes */
+        uint32_t calibrationEnd = 0;
+        uint32_t dataRate = 10;
+
+        /** @brief true rotation of the robot, clockwise positive, in degrees */
+        double rotation = 0;
+        /** @brief true yaw rate of the robot, clockwise positive, in degrees per second */
+        double gyroZ = 0;
+        /** @brief true acceleration of the robot in the sensor frame, in g */
+        double accelX = 0;
+        double accelY = 0;
+        /** @brief sums of the acceleration since the last sample. The sensor filters it, so a sample is their mean */
+        double accelXSum = 0;
+        double accelYSum = 0;
+        int accelCount = 0;
+        /** @brief offset added to rotation by tare and set_rotation */
+        double rotationOffset = 0;
+        /** @brief offset added to heading by tare and set_heading */
+        double headingOffset = 0;
+
+        struct Sample {
+                double rotation = 0;
+                double gyroZ = 0;
+                double accelX = 0;
+                double accelY = 0;
+                uint32_t timestamp = 0;
+        } sample;
+};
+
+/**
+ * @brief Simulated V5 rotation sensor
+ *
+ */
+struct Rotation {
+        uint32_t dataRate = 10;
+        bool reversed = false;
+
+        /** @brief true angle of the shaft, in centidegrees */
+        double position = 0;
+        /** @brief true velocity of the shaft, in centidegrees per second */
+        double velocity = 0;
+        /** @brief position reported as 0, in centidegrees */
+        double zero = 0;
+
+        struct Sample {
+                double position = 0;
+                double velocity = 0;
+                uint32_t timestamp = 0;
+        } sample;
+};
+
+/**
+ * @brief Simulated V5 GPS sensor
+ *
+ * Reports the true pose of the robot's tracking center, as though it were mounted there and always had a clear view
+ * of the field strips.
+ */
+struct Gps {
+        uint32_t dataRate = 10;
+
+        /** @brief true position, in meters from the center of the field */
+        double x = 0;
+        double y = 0;
+        /** @brief true heading, clockwise from +y, in degrees */
+        double heading = 0;
+        /** @brief offset added to rotation by tare_rotation and set_rotation */
+        double rotationOffset = 0;
+
+        struct Sample {
+                double x = 0;
+                double y = 0;
+                double heading = 0;
+                /** @brief continuous heading, in degrees */
+                double rotation = 0;
+                /** @brief the sensor's estimate of its position error, in meters */
+                double error = 0;
+                uint32_t timestamp = 0;
+        } sample;
+};
+
+/**
+ * @brief Simulated V5 distance sensor
+ *
+ * The robot model casts a ray from where the sensor is mounted to the field walls, which is all the sensor can see.
+ */
+struct Distance {
+        uint32_t dataRate = 33;
+
+        /** @brief true distance to the nearest wall in front of the sensor, in mm. Negative if there is none */
+        double distance = -1;
+
+        struct Sample {
+                /** @brief reported distance, in mm. 9999 when nothing is in range */
+                int32_t distance = 9999;
+                /** @brief how sure the sensor is about the reading, out of 63 */
+                int32_t confidence = 0;
+                int32_t objectSize = 0;
+                uint32_t timestamp = 0;
+        } sample;
+};
+
+/**
+ * @brief Simulated three-wire port expander, or the brain's own ADI ports
+ *
+ */
+struct Adi {
+        std::array<pros::adi_port_config_e_t, 8> config {};
+        /** @brief value written by user code, or the true reading of a sensor */
+        std::array<int32_t, 8> value {};
+        /** @brief whether a legacy encoder on this port counts backwards */
+        std::array<bool, 8> reversed {};
+};
+
+/**
+ * @brief Change of a digital output, such as a pneumatic solenoid
+ *
+ */
+struct DigitalEvent {
+        uint32_t time;
+        uint8_t smartPort;
+        uint8_t adiPort;
+        bool value;
+};
+
+/**
+ * @brief Simulated V5 controller
+ *
+ */
+struct Controller {
+        std::array<int32_t, 4> analog {};
+        std::array<bool, 18> digital {};
+        std::array<bool, 18> pressed {};
+};
+
+/**
+ * @brief Simulated V5 battery
+ *
+ */
+struct Battery {
+        /** @brief terminal voltage, in mV */
+        double voltage = 12800;
+        /** @brief current draw, in mA */
+        double current = 0;
+        /** @brief remaining capacity, in percent */
+        double capacity = 100;
+        double temperature = 25;
+};
+
+/**
+ * @brief Sensor noise, applied when devices report a sample. Everything is off by default
+ *
+ */
+struct Noise {
+        /** @brief standard deviation of each IMU rotation sample, in degrees */
+        double imuRotation = 0;
+        /** @brief IMU gyro bias, in degrees per second */
+        double imuDrift = 0;
+        /** @brief IMU accelerometer bias along its y axis, in g */
+        double accelBias = 0;
+        /** @brief standard deviation of each motor encoder sample, in degrees */
+        double motorPosition = 0;
+        /** @brief standard deviation of each GPS position sample, in meters */
+        double gpsPosition = 0;
+        /** @brief standard deviation of each distance sample, as a fraction of the distance */
+        double distance = 0;
+        std::mt19937_64 rng;
+};
+
+/**
+ * @brief Every simulated device
+ *
+ */
+struct Devices {
+        /** Indexed by smart port number. Index 0 is unused */
+        std::array<Motor, NUM_PORTS + 1> motors {};
+        std::array<Imu, NUM_PORTS + 1> imus {};
+        std::array<Rotation, NUM_PORTS + 1> rotations {};
+        std::array<Gps, NUM_PORTS + 1> gps {};
+        std::array<Distance, NUM_PORTS + 1> distances {};
+        std::array<Adi, NUM_PORTS + 1> adi {};
+        std::vector<DigitalEvent> digitalEvents;
+        Controller master;
+        Controller partner;
+        Battery battery;
+        Noise noise;
+        uint8_t competitionStatus = 0;
+
+        /**
+         * @brief Take a new sample from every device that is due for one
+         *
+         * @param time the current virtual time
+         */
+        void sample(uint32_t time);
+};
+
+/**
+ * @brief Get the simulated devices
+ *
+ * @return Devices&
+ */
+Devices& devices();
+
+/**
+ * @brief Check whether a smart port number is valid, setting errno if it isn't
+ *
+ * @param port the port
+ * @return true the port is valid
+ */
+bool validPort(int port);
+} // namespace sim
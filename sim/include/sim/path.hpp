@@ -0,0 +1,30 @@
+/**
+ * @file sim/include/sim/path.hpp
+ * @brief The path followed by --auton path
+ *
+ * An S-bend into a straight, starting at (0, -42) facing +y, with points an inch apart in the format path.jerryio
+ * exports for LemLib. The velocity column is a hand-picked 100 that ramps down over the last foot and is 0 at the end,
+ * the way such files are usually made.
+ */
+
+#pragma once
+
+#include "lemlib/asset.hpp"
+
+namespace sim {
+/**
+ * @brief Get the path file
+ *
+ * @return const asset&
+ */
+const asset& testPath();
+
+/**
+ * @brief Get how far a point is from the path
+ *
+ * @param x x coordinate, in inches
+ * @param y y coordinate, in inches
+ * @return double distance to the nearest point on the path, in inches
+ */
+double distanceToTestPath(double x, double y);
+} // namespace sim
@@ -0,0 +1,174 @@
+/**
+ * @file sim/include/sim/robot.hpp
+ * @brief Physics model of a differential drive robot
+ *
+ * Each tick the model reads what the motors were commanded to do, applies V5 motor torque/speed curves for each
+ * cartridge, and integrates the drivetrain dynamics: the wheels on each side are driven by their motors and pushed
+ * along by friction with the field tiles, which in turn accelerate the mass and yaw inertia of the robot. Wheels can
+ * slip when the motors ask for more force than the tiles can take, turning is resisted by wheel scrub, and the battery
+ * sags under load. The field walls stop the robot dead, leaving the motors to stall or the wheels to slip against
+ * them. The new true state is written back to the simulated devices for odometry to read.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace sim {
+/**
+ * @brief Unpowered tracking wheel, read by a rotation sensor or an ADI encoder
+ *
+ * Offsets use the LemLib convention, so the same value can be passed to lemlib::TrackingWheel.
+ */
+struct TrackingWheelConfig {
+        /** @brief smart port of the rotation sensor, or of the ADI expander */
+        std::uint8_t port = 0;
+        /** @brief top ADI port (1-8) of an encoder, 0 if the wheel uses a rotation sensor */
+        std::uint8_t adiPort = 0;
+        /** @brief true for a wheel that measures sideways motion */
+        bool horizontal = false;
+        /** @brief wheel diameter, in inches */
+        double diameter = 2.75;
+        /** @brief distance from the tracking center, in inches */
+        double offset = 0;
+        /** @brief wheel rotations per sensor rotation */
+        double ratio = 1;
+};
+
+/**
+ * @brief Distance sensor mounted on the robot, facing out towards the field walls
+ *
+ */
+struct DistanceSensorConfig {
+        std::uint8_t port = 0;
+        /** @brief offset from the tracking center, right and forwards positive, in inches */
+        double x = 0;
+        double y = 0;
+        /** @brief direction the sensor faces relative to the front of the robot, clockwise positive, in degrees */
+        double angle = 0;
+};
+
+/**
+ * @brief Description of the simulated drivetrain
+ *
+ */
+struct DrivetrainConfig {
+        /** @brief smart ports of the motors on each side */
+        std::vector<std::uint8_t> leftPorts;
+        std::vector<std::uint8_t> rightPorts;
+        /** @brief distance between the left and right wheels, in inches */
+        double trackWidth = 12;
+        /** @brief wheel diameter, in inches */
+        double wheelDiameter = 3.25;
+        /** @brief wheel rpm when the motors spin at the cartridge free speed */
+        double wheelRpm = 300;
+        /** @brief half the width of the robot's square footprint, which stops it at the field walls, in inches */
+        double halfSize = 9;
+        std::vector<TrackingWheelConfig> trackingWheels;
+        std::vector<DistanceSensorConfig> distanceSensors;
+
+        /** @brief mass of the robot, in kg */
+        double mass = 6.8;
+        /** @brief moment of inertia about the vertical axis, in kg m^2 */
+        double inertia = 0.25;
+        /** @brief rotor and gear inertia of one side, expressed as mass at the wheel tread, in kg */
+        double sideMass = 0.8;
+        /** @brief coefficient of friction between the wheels and the tiles */
+        double friction = 0.9;
+        /** @brief wheel slip speed at which friction is mostly developed, in m/s */
+        double slipVelocity = 0.05;
+        /** @brief torque resisting rotation from wheels sliding sideways, in Nm */
+        double scrubTorque = 1.0;
+        /** @brief rolling resistance, as a fraction of the robot's weight */
+        double rollingResistance = 0.02;
+        /** @brief internal resistance of the battery, in ohms */
+        double batteryResistance = 0.15;
+        /** @brief battery capacity, in amp hours */
+        double batteryCapacity = 1.1;
+};
+
+/**
+ * @brief True state of the robot on the field
+ *
+ * Uses the same convention as LemLib: x and y in inches, theta in degrees, 0 facing +y and increasing clockwise.
+ */
+struct RobotState {
+        double x = 0;
+        double y = 0;
+        double theta = 0;
+        /** @brief forward velocity, in inches per second */
+        double velocity = 0;
+        /** @brief angular velocity, clockwise positive, in degrees per second */
+        double angularVelocity = 0;
+        /** @brief distance driven by the center of the robot, in inches */
+        double distance = 0;
+        /** @brief tread speed of the left and right wheels, in inches per second */
+        double leftWheel = 0;
+        double rightWheel = 0;
+        /** @brief lowest battery voltage seen so far, in mV */
+        double minBatteryVoltage = 0;
+};
+
+/**
+ * @brief Differential drive dynamics model
+ *
+ */
+class Robot {
+    public:
+        /**
+         * @brief Construct a new robot
+         *
+         * @param config the drivetrain
+         */
+        explicit Robot(DrivetrainConfig config);
+        /**
+         * @brief Advance every motor, the robot and its sensors
+         *
+         * @param dt time step, in seconds
+         */
+        void step(double dt);
+        /**
+         * @brief Place the robot on the field. Sensors are not affected
+         *
+         * @param x x position, in inches
+         * @param y y position, in inches
+         * @param theta heading, in degrees
+         */
+        void setPose(double x, double y, double theta);
+        /**
+         * @brief Get the true state of the robot
+         *
+         * @return const RobotState&
+         */
+        const RobotState& state() const;
+    private:
+        /**
+         * @brief Integrate the drivetrain over one substep
+         *
+         * @param dt substep length, in seconds
+         */
+        void integrate(double dt);
+        /**
+         * @brief Force that the motors on one side apply at the wheel tread
+         *
+         * @param ports the motors on the side
+         * @param wheelSpeed tread speed of the side, in m/s
+         * @return double force, in N
+         */
+        double sideForce(const std::vector<std::uint8_t>& ports, double wheelSpeed);
+
+        DrivetrainConfig config;
+        RobotState robotState;
+        /** @brief forward and angular velocity, in m/s and rad/s */
+        double v = 0;
+        double omega = 0;
+        /** @brief tread speed of each side, in m/s */
+        double leftSpeed = 0;
+        double rightSpeed = 0;
+        /** @brief total current drawn from the battery on the last step, in A */
+        double batteryCurrent = 0;
+        /** @brief fractional ADI encoder ticks not yet reported, per tracking wheel */
+        std::vector<double> encoderRemainder;
+};
+} // namespace sim
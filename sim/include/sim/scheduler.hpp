@@ -0,0 +1,261 @@
+/**
+ * @file sim/include/sim/scheduler.hpp
+ * @brief Virtual-time task scheduler backing the simulated PROS RTOS
+ *
+ * Every PROS task is backed by a host thread, but only one of them is allowed to run at a time, just like on the
+ * single core of the V5 brain. A task runs until it blocks (delay, mutex, notification, join). Virtual time only
+ * advances once every task is blocked, so a routine runs as fast as the host can execute its control loops.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "pros/rtos.h"
+
+namespace sim {
+/**
+ * @brief Simulated RTOS task
+ *
+ */
+struct Task {
+        /** @brief State of the simulated task */
+        enum class State { READY, BLOCKED, SUSPENDED, DELETED };
+
+        uint32_t id = 0;
+        std::string name;
+        uint32_t priority = TASK_PRIORITY_DEFAULT;
+        State state = State::READY;
+        /** @brief virtual time at which the task was created */
+        uint32_t createdAt = 0;
+        /** @brief order in which the task became ready, used for round-robin between equal priorities */
+        uint64_t readySeq = 0;
+
+        /** @brief virtual time at which a blocked task times out. UINT32_MAX blocks forever */
+        uint32_t wakeTime = UINT32_MAX;
+        /** @brief object the task is blocked on, nullptr when only delayed */
+        const void* waitingOn = nullptr;
+
+        uint32_t notifyValue = 0;
+        bool notifyWaiting = false;
+
+        /** @brief host CPU time spent running this task, in nanoseconds */
+        uint64_t cpuNs = 0;
+        /** @brief number of times the task has run until it blocked */
+        uint64_t slices = 0;
+        /** @brief host CPU timestamp of when the task last started running */
+        uint64_t sliceStart = 0;
+
+        std::thread thread;
+        std::condition_variable cv;
+};
+
+/**
+ * @brief Simulated mutex
+ *
+ */
+struct Mutex {
+        Task* owner = nullptr;
+};
+
+/**
+ * @brief Cooperative, virtual-time scheduler
+ *
+ * The thread that first touches the scheduler is adopted as the "main" task, which is the equivalent of the PROS
+ * system daemon that runs initialize() and the competition modes.
+ */
+class Scheduler {
+    public:
+        /**
+         * @brief Get the global scheduler
+         *
+         * @return Scheduler&
+         */
+        static Scheduler& get();
+
+        /**
+         * @brief Current virtual time
+         *
+         * @return uint32_t milliseconds since the simulation started
+         */
+        uint32_t now() const;
+        /**
+         * @brief Get the task that is currently running
+         *
+         * @return Task*
+         */
+        Task* current() const;
+        /**
+         * @brief Get every task that has been created, including deleted ones
+         *
+         * @return const std::deque<Task*>&
+         */
+        const std::deque<Task*>& tasks() const;
+
+        /**
+         * @brief Create a new task. The new task will not run until the creating task blocks, or right away if it
+         * has a higher priority
+         *
+         * @param function the task function
+         * @param parameters the parameter passed to the task function
+         * @param priority the task priority
+         * @param name the task name
+         * @return Task*
+         */
+        Task* create(pros::task_fn_t function, void* parameters, uint32_t priority, const char* name);
+        /**
+         * @brief Remove a task. Removing the running task never returns
+         *
+         * @param task the task to remove
+         */
+        void remove(Task* task);
+        /**
+         * @brief Block the running task until a point in virtual time
+         *
+         * @param time the time to wake up at
+         */
+        void sleepUntil(uint32_t time);
+        /**
+         * @brief Give the processor to the next ready task with the same or higher priority
+         *
+         */
+        void yield();
+        /**
+         * @brief Block the running task on an object until it is woken or times out
+         *
+         * @param object the object to block on
+         * @param timeout maximum time to block, TIMEOUT_MAX to block forever
+         * @return true the task was woken by wake()
+         * @return false the task timed out
+         */
+        bool block(const void* object, uint32_t timeout);
+        /**
+         * @brief Wake the highest priority task blocked on an object
+         *
+         * @param object the object
+         * @return Task* the task that was woken, nullptr if there was none
+         */
+        Task* wakeOne(const void* object);
+        /**
+         * @brief Wake a specific blocked task
+         *
+         * @param task the task to wake
+         */
+        void wake(Task* task);
+        /**
+         * @brief Suspend a task. Suspending the running task blocks it until it is resumed
+         *
+         * @param task the task to suspend
+         */
+        void suspend(Task* task);
+        /**
+         * @brief Resume a suspended task
+         *
+         * @param task the task to resume
+         */
+        void resume(Task* task);
+
+        /**
+         * @brief Register a function called once for every millisecond of virtual time, before tasks waiting on
+         * that millisecond are woken
+         *
+         * @param hook the function. Receives the new virtual time
+         */
+        void addTickHook(std::function<void(uint32_t)> hook);
+        /**
+         * @brief Register a function called whenever a task is deleted, either because its function returned or
+         * because it was removed. Like tick hooks, it must not call back into the scheduler
+         *
+         * @param hook the function. Receives the deleted task
+         */
+        void addExitHook(std::function<void(Task*)> hook);
+        /**
+         * @brief Set a function called when every task is blocked forever
+         *
+         * @param handler the function. If it returns, the process exits
+         */
+        void setDeadlockHandler(std::function<void()> handler);
+        /**
+         * @brief Make pros::delay oversleep by a random amount, like it does on a brain busy with other tasks.
+         * delay_until keeps to its deadlines
+         *
+         * @param maxJitter the longest oversleep, in ms. 0 turns jitter off, which is the default
+         * @param seed seed for the oversleeps
+         */
+        void setDelayJitter(uint32_t maxJitter, uint64_t seed);
+        /**
+         * @brief How long the next pros::delay oversleeps
+         *
+         * @return uint32_t milliseconds
+         */
+        uint32_t delayJitter();
+    private:
+        Scheduler();
+
+        /**
+         * @brief Hand the processor to the next task and park the running task until it is scheduled again
+         *
+         * @param self the task giving up the processor
+         */
+        void switchFrom(Task* self, std::unique_lock<std::mutex>& lock);
+        /**
+         * @brief Pick the next task to run, advancing virtual time if nothing is ready
+         *
+         * @return Task*
+         */
+        Task* pickNext();
+        /**
+         * @brief Make a task ready to run
+         *
+         * @param task the task
+         */
+        void makeReady(Task* task);
+        /**
+         * @brief Mark a task as deleted, wake the tasks joining it and run the exit hooks
+         *
+         * @param task the task
+         */
+        void markDeleted(Task* task);
+        /**
+         * @brief Park the calling thread until its task is scheduled
+         *
+         */
+        void waitForTurn(Task* self, std::unique_lock<std::mutex>& lock);
+        /**
+         * @brief Start accounting CPU time for a task
+         *
+         */
+        void startSlice(Task* task);
+        /**
+         * @brief Stop accounting CPU time for a task
+         *
+         */
+        void endSlice(Task* task);
+
+        mutable std::mutex mutex;
+        std::deque<Task*> allTasks;
+        std::vector<std::function<void(uint32_t)>> tickHooks;
+        std::vector<std::function<void(Task*)>> exitHooks;
+        std::function<void()> deadlockHandler;
+        Task* running = nullptr;
+        uint32_t time = 0;
+        uint64_t readyCounter = 0;
+        uint32_t nextId = 0;
+        uint32_t maxJitter = 0;
+        std::mt19937_64 jitterRng;
+};
+
+/**
+ * @brief Host CPU time used by the calling thread
+ *
+ * @return uint64_t nanoseconds
+ */
+uint64_t threadCpuNs();
+} // namespace sim
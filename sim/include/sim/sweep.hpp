@@ -0,0 +1,92 @@
+/**
+ * @file sim/include/sim/sweep.hpp
+ * @brief Monte Carlo sweeps of an autonomous routine
+ *
+ * The robot program lives in global state (the chassis, the motors, the scheduler), so every run is a separate
+ * process: the sweep spawns the simulator once per seed from a work-stealing thread pool and collects what each run
+ * reports. Run 0 is the nominal run with nothing randomized, and the other runs are compared against it.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace sim {
+/**
+ * @brief Where the robot was when one motion of a routine finished
+ *
+ */
+struct MotionRecord {
+        /** @brief virtual time the motion started and finished, in ms since the routine started */
+        uint32_t start = 0;
+        uint32_t end = 0;
+        /** @brief true pose */
+        double x = 0;
+        double y = 0;
+        double theta = 0;
+        /** @brief pose according to odometry */
+        double odomX = 0;
+        double odomY = 0;
+        double odomTheta = 0;
+        /** @brief how much sooner settle detection ended the motion than the exit countdowns would have, in ms */
+        uint32_t saved = 0;
+};
+
+/**
+ * @brief Result of one run of a routine
+ *
+ */
+struct RunRecord {
+        uint64_t seed = 0;
+        /** @brief false if the run crashed or its output couldn't be read */
+        bool valid = false;
+        bool timedOut = false;
+        /** @brief time the routine took, in ms */
+        uint32_t routeMs = 0;
+        std::vector<MotionRecord> motions;
+};
+
+/**
+ * @brief Write a run record in the line format read by parseRunRecord
+ *
+ * @param file where to write
+ * @param record the record
+ */
+void writeRunRecord(std::FILE* file, const RunRecord& record);
+
+/**
+ * @brief Parse the output of a run
+ *
+ * @param text everything the run wrote to stdout
+ * @return RunRecord with valid set if a complete record was found
+ */
+RunRecord parseRunRecord(const std::string& text);
+
+/**
+ * @brief Settings for a sweep
+ *
+ */
+struct SweepOptions {
+        /** @brief path of the simulator executable */
+        std::string program;
+        std::string auton;
+        uint32_t timeLimit = 120000;
+        /** @brief number of randomized runs, not counting the nominal run */
+        int runs = 100;
+        /** @brief worker threads, 0 for one per hardware thread */
+        unsigned jobs = 0;
+        /** @brief passed on to every run */
+        std::vector<std::string> extraArgs;
+};
+
+/**
+ * @brief Run a sweep and print completion time and pose error distributions to stdout
+ *
+ * @param options the sweep
+ * @return int process exit code
+ */
+int runSweep(const SweepOptions& options);
+} // namespace sim
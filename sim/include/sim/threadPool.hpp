@@ -0,0 +1,81 @@
+/**
+ * @file sim/include/sim/threadPool.hpp
+ * @brief Work-stealing thread pool for running many simulations at once
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sim {
+/**
+ * @brief Work-stealing thread pool
+ *
+ * Every worker has its own deque of jobs. A worker takes jobs from the front of its own deque, and when that runs
+ * dry it steals from the back of another worker's deque, so long jobs on one worker don't leave the others idle.
+ */
+class ThreadPool {
+    public:
+        /**
+         * @brief Construct a new thread pool
+         *
+         * @param threads number of worker threads. 0 uses one per hardware thread
+         */
+        explicit ThreadPool(unsigned threads = 0);
+        /**
+         * @brief Wait for every submitted job to finish and stop the workers
+         *
+         */
+        ~ThreadPool();
+        /**
+         * @brief Queue a job. Jobs are spread across the workers round-robin
+         *
+         * @param job the job
+         */
+        void submit(std::function<void()> job);
+        /**
+         * @brief Block until every submitted job has finished
+         *
+         */
+        void wait();
+        /**
+         * @brief Number of worker threads
+         *
+         * @return size_t
+         */
+        size_t size() const;
+    private:
+        struct Worker {
+                std::deque<std::function<void()>> jobs;
+                std::mutex mutex;
+        };
+
+        /**
+         * @brief Take a job from a worker's own deque, or steal one from another worker
+         *
+         * @param self index of the worker looking for a job
+         * @param job output
+         * @return true a job was found
+         */
+        bool take(size_t self, std::function<void()>& job);
+        void run(size_t self);
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::vector<std::thread> threads;
+        std::atomic<size_t> nextWorker {0};
+        /** @brief jobs that have been submitted but not finished */
+        size_t pending = 0;
+        bool stopping = false;
+        std::mutex stateMutex;
+        std::condition_variable workAvailable;
+        std::condition_variable allDone;
+};
+} // namespace sim
@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include "sim/devices.hpp"
+
+namespace sim {
+double cartridgeRpm(pros::motor_gearset_e_t gearset) {
+    switch (gearset) {
+        case pros::E_MOTOR_GEARSET_36: return 100;
+        case pros::E_MOTOR_GEARSET_06: return 600;
+        default: return 200;
+    }
+}
+
+double cartridgeTicks(pros::motor_gearset_e_t gearset) {
+    switch (gearset) {
+        case pros::E_MOTOR_GEARSET_36: return 1800;
+        case pros::E_MOTOR_GEARSET_06: return 300;
+        default: return 900;
+    }
+}
+
+double Motor::commandedVoltage() const {
+    const double freeRpm = cartridgeRpm(gearset);
+    // rough stand-in for the velocity controller running on the motor itself
+    const double kV = 12000 / freeRpm;
+    const double kP = 4 * kV;
+    double out = 0;
+    switch (mode) {
+        case Mode::VOLTAGE: out = target; break;
+        case Mode::VELOCITY: out = kV * target + kP * (target - velocity); break;
+        case Mode::POSITION: {
+            double velocityTarget = (target - position) * 0.5; // degrees of error to rpm
+            const double maxVelocity = profileVelocity != 0 ? std::fabs(profileVelocity) : freeRpm;
+            velocityTarget = std::fmax(-maxVelocity, std::fmin(maxVelocity, velocityTarget));
+            out = kV * velocityTarget + kP * (velocityTarget - velocity);
+            break;
+        }
+        case Mode::BRAKE: {
+            if (brakeMode == pros::E_MOTOR_BRAKE_HOLD) out = kP * (target - position) * 0.5 - kP * velocity;
+            else out = 0;
+            break;
+        }
+    }
+    if (voltageLimit != 0) out = std::fmax(-voltageLimit, std::fmin(voltageLimit, out));
+    return std::fmax(-12000.0, std::fmin(12000.0, out));
+}
+
+void Devices::sample(uint32_t time) {
+    std::normal_distribution<double> gaussian;
+    for (int port = 1; port <= NUM_PORTS; port++) {
+        // devices are offset by their port so they don't all report on the same tick
+        Motor& motor = motors[port];
+        if ((time + port) % 10 == 0) {
+            motor.sample.position = motor.position;
+            if (noise.motorPosition != 0) motor.sample.position += noise.motorPosition * gaussian(noise.rng);
+            motor.sample.velocity = motor.velocity;
+            motor.sample.current = motor.current;
+            motor.sample.voltage = motor.voltage;
+            motor.sample.torque = motor.torque;
+            motor.sample.timestamp = time;
+        }
+        Imu& imu = imus[port];
+        if (imu.dataRate != 0 && (time + port) % imu.dataRate == 0) {
+            imu.sample.rotation = imu.rotation + noise.imuDrift * time / 1000;
+            if (noise.imuRotation != 0) imu.sample.rotation += noise.imuRotation * gaussian(noise.rng);
+            imu.sample.gyroZ = imu.gyroZ + noise.imuDrift;
+            // a knock between samples still shows up in the next one, spread over the sample period
+            imu.sample.accelX = imu.accelCount != 0 ? imu.accelXSum / imu.accelCount : imu.accelX;
+            imu.sample.accelY = imu.accelCount != 0 ? imu.accelYSum / imu.accelCount : imu.accelY;
+            imu.sample.accelY += noise.accelBias;
+            imu.accelXSum = imu.accelYSum = 0;
+            imu.accelCount = 0;
+            imu.sample.timestamp = time;
+        }
+        Rotation& rotation = rotations[port];
+        if (rotation.dataRate != 0 && (time + port) % rotation.dataRate == 0) {
+            rotation.sample.position = rotation.position;
+            rotation.sample.velocity = rotation.velocity;
+            rotation.sample.timestamp = time;
+        }
+        Gps& gpsSensor = gps[port];
+        if (gpsSensor.dataRate != 0 && (time + port) % gpsSensor.dataRate == 0) {
+            gpsSensor.sample.x = gpsSensor.x;
+            gpsSensor.sample.y = gpsSensor.y;
+            if (noise.gpsPosition != 0) {
+                gpsSensor.sample.x += noise.gpsPosition * gaussian(noise.rng);
+                gpsSensor.sample.y += noise.gpsPosition * gaussian(noise.rng);
+            }
+            gpsSensor.sample.heading = std::fmod(std::fmod(gpsSensor.heading, 360) + 360, 360);
+            gpsSensor.sample.rotation = gpsSensor.heading;
+            gpsSensor.sample.error = noise.gpsPosition;
+            gpsSensor.sample.timestamp = time;
+        }
+        Distance& distance = distances[port];
+        if (distance.dataRate != 0 && (time + port) % distance.dataRate == 0) {
+            // the sensor gives up past 2 m
+            double reading = distance.distance;
+            if (noise.distance != 0) reading *= 1 + noise.distance * gaussian(noise.rng);
+            if (distance.distance < 0 || reading > 2000) {
+                distance.sample.distance = 9999;
+                distance.sample.confidence = 0;
+                distance.sample.objectSize = 0;
+            } else {
+                distance.sample.distance = int32_t(std::round(std::max(0.0, reading)));
+                // below 200 mm the sensor reports a fixed confidence of 10
+                distance.sample.confidence = reading < 200 ? 10 : 63;
+                distance.sample.objectSize = 400;
+            }
+            distance.sample.timestamp = time;
+        }
+    }
+}
+
+Devices& devices() {
+    static Devices devices;
+    return devices;
+}
+
+bool validPort(int port) {
+    if (port < 1 || port > NUM_PORTS) {
+        errno = ENXIO;
+        return false;
+    }
+    return true;
+}
+} // namespace sim
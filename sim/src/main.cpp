@@ -0,0 +1,480 @@
+/**
+ * @file sim/src/main.cpp
+ * @brief Runs an autonomous routine from src/main.cpp in virtual time and reports how long and how much CPU it took
+ *
+ * Usage: rc5-sim [--auton skills|far|close|pidtune|path|waypoints|sysid|autotune] [--time-limit ms] [--verbose]
+ *                [--seed n] [--record] [--ekf] [--gps] [--relocalize] [--ramsete] [--battery percent] [--chain in]
+ *                [--no-stall] [--no-settle] [--jitter ms]
+ *        rc5-sim --sweep runs [--jobs threads] [--auton ...] [--time-limit ms] [--ekf] [--gps] [--relocalize]
+ *                [--ramsete] [--battery percent] [--chain in] [--no-stall] [--no-settle] [--jitter ms]
+ *
+ * The robot is set up by initialize, and then by simSettings with the settings that have only been tuned in the sim.
+ * --ekf estimates the pose with the Kalman filter instead of dead reckoning, and --gps also gives it a GPS sensor.
+ * --relocalize mounts distance sensors on the left, right and back of the robot and corrects odometry against the
+ * field walls with them.
+ *
+ * --auton path follows the path in sim/src/path.cpp and also reports how far the robot strayed from it, with pure
+ * pursuit or, with --ramsete, by tracking the planned trajectory. --auton sysid runs the drivetrain characterization
+ * tests and saves the log to sysid.bin in the working directory, for sim/bin/sysid-fit. --auton autotune tunes the
+ * PIDs with relay feedback and saves the gains to gains.txt, printing what it found with --verbose. --auton
+ * waypoints queues moveToPose and moveToPoint calls back to back, and --chain sets how far before each target they
+ * hand over to the next, with 0 stopping at every one. The field walls stop the robot dead, and --no-stall turns off
+ * the stall detection that ends a motion pushing into one, to see how long the routine would sit there otherwise.
+ * The report lists how much time settle detection saved each motion it ended early, and --no-settle turns it off so
+ * every motion waits out its exit countdowns instead. --jitter makes every pros::delay oversleep by up to the given
+ * time, like a brain busy with other tasks, which the control loops have to cope with.
+ *
+ * A non-zero seed randomizes the start pose, sensor noise, battery charge and wheel traction. --record prints a
+ * machine-readable record instead of the report, which is what --sweep collects from each of its runs. --battery
+ * starts with the battery at a given charge instead, from 0 to 100, to see how the routine holds up as it drains.
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "main.h"
+#include "lemlib/api.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/chassis/relocalizer.hpp"
+#include "sim/devices.hpp"
+#include "sim/path.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/sweep.hpp"
+
+extern lemlib::Drivetrain drivetrain;
+extern lemlib::Chassis chassis;
+void PIDTune();
+void SysIdAuton(const char* path);
+void AutotuneAuton(const char* path);
+
+namespace {
+/** @brief how --auton path follows the path */
+lemlib::PathFollower pathFollower = lemlib::PathFollower::PURE_PURSUIT;
+
+void followPath() {
+    chassis.setPose(0, -42, 0);
+    chassis.follow(sim::testPath(), 12, 15000, true, true, pathFollower);
+}
+
+/** @brief waypoints queued back to back, which chaining drives through without stopping at each one */
+void waypoints() {
+    chassis.setPose(-36, -17, 0);
+    chassis.moveToPoint(-36, 13, 3000);
+    chassis.moveToPose(-12, 37, 90, 3000);
+    chassis.moveToPoint(18, 37, 3000);
+    chassis.moveToPose(36, 13, 180, 3000);
+    chassis.moveToPoint(36, -17, 3000);
+    chassis.moveToPose(12, -37, 270, 3000);
+    chassis.moveToPoint(-16, -37, 3000);
+    chassis.moveToPose(-36, -17, 0, 3000);
+    chassis.waitUntilDone();
+}
+
+/** @brief the characterization tests, saving the log in the working directory instead of on the SD card */
+void sysId() { SysIdAuton("sysid.bin"); }
+
+/** @brief the PID autotuner, saving the gains in the working directory instead of on the SD card */
+void autotune() { AutotuneAuton("gains.txt"); }
+
+const std::map<std::string, void (*)()> routines = {
+    {"skills", SkillsAuton},
+    {"far", FarSideAuton},
+    {"close", CloseSideAuton},
+    {"pidtune", PIDTune},
+    {"path", followPath},
+    {"waypoints", waypoints},
+    {"sysid", sysId},
+    {"autotune", autotune},
+};
+
+struct Options {
+        std::string auton = "skills";
+        uint32_t timeLimit = 120000;
+        bool verbose = false;
+        uint64_t seed = 0;
+        bool record = false;
+        int sweepRuns = 0;
+        unsigned jobs = 0;
+        bool ekf = false;
+        bool gps = false;
+        bool relocalize = false;
+        bool ramsete = false;
+        /** @brief charge of the battery at the start, in percent. Negative leaves it to the seed */
+        double battery = -1;
+        /** @brief exit distance for chaining motions, in inches. Negative leaves it to simSettings */
+        double chain = -1;
+        bool noStall = false;
+        bool noSettle = false;
+        /** @brief longest a pros::delay oversleeps, in ms */
+        uint32_t jitter = 0;
+};
+
+/** @brief smart port of the GPS sensor added by --gps */
+constexpr std::uint8_t GPS_PORT = 20;
+/** @brief distance sensors added by --relocalize: port, offset right and forwards in inches, and angle in degrees */
+const sim::DistanceSensorConfig DISTANCE_SENSORS[] = {
+    {16, -6, 0, -90},
+    {17, 6, 0, 90},
+    {18, 0, -7, 180},
+};
+
+[[noreturn]] void usage(const char* program) {
+    std::fprintf(stderr,
+                 "usage: %s [--auton skills|far|close|pidtune|path|waypoints|sysid|autotune] [--time-limit ms] "
+                 "[--verbose] [--seed n] [--record] [--ekf] [--gps] [--relocalize] [--ramsete] [--battery percent] "
+                 "[--chain in] [--no-stall] [--no-settle] [--jitter ms]\n"
+                 "       %s --sweep runs [--jobs threads] [--auton ...] [--time-limit ms] [--ekf] [--gps] "
+                 "[--relocalize] [--ramsete] [--battery percent] [--chain in] [--no-stall] [--no-settle] "
+                 "[--jitter ms]\n",
+                 program, program);
+    std::exit(2);
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--auton") && i + 1 < argc) options.auton = argv[++i];
+        else if (!std::strcmp(argv[i], "--time-limit") && i + 1 < argc) options.timeLimit = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--verbose")) options.verbose = true;
+        else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) options.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--record")) options.record = true;
+        else if (!std::strcmp(argv[i], "--sweep") && i + 1 < argc) options.sweepRuns = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--jobs") && i + 1 < argc) options.jobs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--ekf")) options.ekf = true;
+        else if (!std::strcmp(argv[i], "--gps")) options.ekf = options.gps = true;
+        else if (!std::strcmp(argv[i], "--relocalize")) options.relocalize = true;
+        else if (!std::strcmp(argv[i], "--ramsete")) options.ramsete = true;
+        else if (!std::strcmp(argv[i], "--battery") && i + 1 < argc) options.battery = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--chain") && i + 1 < argc) options.chain = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--no-stall")) options.noStall = true;
+        else if (!std::strcmp(argv[i], "--no-settle")) options.noSettle = true;
+        else if (!std::strcmp(argv[i], "--jitter") && i + 1 < argc) options.jitter = std::atoi(argv[++i]);
+        else usage(argv[0]);
+    }
+    if (routines.find(options.auton) == routines.end()) usage(argv[0]);
+    return options;
+}
+
+uint64_t wallNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+uint64_t processCpuNs() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+/** @brief how far the robot is from where the routine thinks it starts */
+struct StartError {
+        double x = 0;
+        double y = 0;
+        double theta = 0;
+};
+
+/**
+ * @brief Randomize the things that change from match to match
+ *
+ * @param seed the seed. 0 leaves everything nominal
+ * @param config the drivetrain, whose traction is randomized
+ * @return StartError how badly the robot was placed
+ */
+StartError randomize(uint64_t seed, sim::DrivetrainConfig& config) {
+    StartError start;
+    if (seed == 0) return start;
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> gaussian;
+    auto uniform = [&rng](double min, double max) { return std::uniform_real_distribution<double>(min, max)(rng); };
+
+    // placement by hand is good to about an inch and a couple of degrees
+    start.x = 1.0 * gaussian(rng);
+    start.y = 1.0 * gaussian(rng);
+    start.theta = 2.0 * gaussian(rng);
+
+    sim::Noise& noise = sim::devices().noise;
+    noise.rng.seed(rng());
+    noise.imuRotation = 0.02;
+    noise.imuDrift = 0.01 * gaussian(rng);
+    noise.motorPosition = 0.5;
+
+    sim::Battery& battery = sim::devices().battery;
+    battery.capacity = uniform(30, 100);
+    battery.voltage = 12000 + 8 * battery.capacity;
+
+    // dusty tiles and worn wheels
+    config.friction = uniform(0.6, 1.0);
+    config.slipVelocity = uniform(0.03, 0.1);
+
+    // an IMU mounted a little off level reads some of gravity as forward acceleration
+    noise.accelBias = 0.02 * gaussian(rng);
+    return start;
+}
+
+/** @brief robot code CPU time, excluding the driver itself */
+uint64_t robotCpuNs() {
+    uint64_t total = 0;
+    for (sim::Task* task : sim::Scheduler::get().tasks()) {
+        if (task->name != "main") total += task->cpuNs;
+    }
+    return total;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    const Options options = parseOptions(argc, argv);
+    if (options.sweepRuns > 0) {
+        sim::SweepOptions sweep;
+        sweep.program = "/proc/self/exe";
+        sweep.auton = options.auton;
+        sweep.timeLimit = options.timeLimit;
+        sweep.runs = options.sweepRuns;
+        sweep.jobs = options.jobs;
+        if (options.ekf) sweep.extraArgs.push_back("--ekf");
+        if (options.gps) sweep.extraArgs.push_back("--gps");
+        if (options.relocalize) sweep.extraArgs.push_back("--relocalize");
+        if (options.ramsete) sweep.extraArgs.push_back("--ramsete");
+        if (options.battery >= 0) {
+            sweep.extraArgs.push_back("--battery");
+            sweep.extraArgs.push_back(std::to_string(options.battery));
+        }
+        if (options.chain >= 0) {
+            sweep.extraArgs.push_back("--chain");
+            sweep.extraArgs.push_back(std::to_string(options.chain));
+        }
+        if (options.noStall) sweep.extraArgs.push_back("--no-stall");
+        if (options.noSettle) sweep.extraArgs.push_back("--no-settle");
+        if (options.jitter != 0) {
+            sweep.extraArgs.push_back("--jitter");
+            sweep.extraArgs.push_back(std::to_string(options.jitter));
+        }
+        return sim::runSweep(sweep);
+    }
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    if (options.ramsete) pathFollower = lemlib::PathFollower::RAMSETE;
+
+    // LemLib logs telemetry to stdout, which would bury the report
+    std::ostream null(nullptr);
+    if (!options.verbose) std::cout.rdbuf(null.rdbuf());
+
+    sim::DrivetrainConfig config;
+    config.leftPorts = drivetrain.leftMotors->get_ports();
+    config.rightPorts = drivetrain.rightMotors->get_ports();
+    config.trackWidth = drivetrain.trackWidth;
+    config.wheelDiameter = drivetrain.wheelDiameter;
+    config.wheelRpm = drivetrain.rpm;
+    if (options.relocalize) config.distanceSensors.assign(std::begin(DISTANCE_SENSORS), std::end(DISTANCE_SENSORS));
+    const StartError startError = randomize(options.seed, config);
+    if (options.battery >= 0) {
+        sim::Battery& battery = sim::devices().battery;
+        battery.capacity = std::clamp(options.battery, 0.0, 100.0);
+        battery.voltage = 12000 + 8 * battery.capacity;
+    }
+    sim::Robot robot(config);
+
+    static pros::Gps gps(GPS_PORT);
+    if (options.gps) sim::devices().noise.gpsPosition = 0.01;
+    if (options.ekf) lemlib::useEkf(lemlib::EkfSettings(), options.gps ? &gps : nullptr);
+
+    // the routine sets its starting pose before it first blocks, so the robot is placed there on the next tick
+    bool autonStarted = false;
+    bool placed = false;
+    const bool followingPath = options.auton == "path";
+    double crossTrackSum = 0, crossTrackMax = 0;
+    uint32_t crossTrackSamples = 0;
+    scheduler.addTickHook([&](uint32_t time) {
+        if (autonStarted && !placed) {
+            const lemlib::Pose pose = chassis.getPose();
+            robot.setPose(pose.x + startError.x, pose.y + startError.y, pose.theta + startError.theta);
+            placed = true;
+        }
+        robot.step(0.001);
+        sim::devices().sample(time);
+        if (followingPath && placed && chassis.getState().inMotion) {
+            const double error = sim::distanceToTestPath(robot.state().x, robot.state().y);
+            crossTrackSum += error;
+            crossTrackMax = std::max(crossTrackMax, error);
+            crossTrackSamples++;
+        }
+    });
+    scheduler.setDeadlockHandler([] { std::fprintf(stderr, "sim: deadlock, every task is blocked forever\n"); });
+
+    sim::devices().competitionStatus = COMPETITION_CONNECTED | COMPETITION_DISABLED;
+    pros::Task initTask([] {
+        initialize();
+        simSettings();
+    }, "initialize");
+    initTask.join();
+    if (options.chain >= 0) chassis.setChainSettings({float(options.chain)});
+    if (options.noStall) chassis.setStallSettings({0});
+    if (options.noSettle) chassis.setSettleSettings({0}, {0});
+
+    static std::vector<pros::Distance> distanceSensors;
+    std::vector<lemlib::RelocalizerSensor> relocalizerSensors;
+    distanceSensors.reserve(config.distanceSensors.size());
+    for (const sim::DistanceSensorConfig& sensor : config.distanceSensors) {
+        distanceSensors.emplace_back(sensor.port);
+        relocalizerSensors.push_back({&distanceSensors.back(), float(sensor.x), float(sensor.y), float(sensor.angle)});
+    }
+    static lemlib::Relocalizer relocalizer(lemlib::FieldModel::perimeter(), relocalizerSensors);
+    if (options.relocalize) {
+        sim::devices().noise.distance = 0.03;
+        relocalizer.start();
+    }
+
+    // snapshot every task so initialization isn't counted against the routine
+    std::map<sim::Task*, std::pair<uint64_t, uint64_t>> before;
+    for (sim::Task* task : scheduler.tasks()) before[task] = {task->cpuNs, task->slices};
+    const uint64_t robotCpuStart = robotCpuNs();
+    const uint64_t processCpuStart = processCpuNs();
+    const uint64_t wallStart = wallNs();
+    const uint32_t start = pros::millis();
+    lemlib::resetStats();
+    const uint32_t stallsStart = chassis.getState().stalls;
+
+    // the chassis numbers its motions and publishes the one running, so a motion ends when that number changes
+    sim::RunRecord record;
+    record.seed = options.seed;
+    uint32_t runningMotion = 0;
+    uint32_t motionStart = 0;
+    uint32_t savedStart = 0;
+    scheduler.addTickHook([&](uint32_t time) {
+        if (!autonStarted) return;
+        const uint32_t id = chassis.getState().motionId;
+        if (id == runningMotion) return;
+        const uint32_t now = time - start;
+        if (runningMotion != 0) {
+            const lemlib::Pose odom = chassis.getPose();
+            const sim::RobotState& truth = robot.state();
+            sim::MotionRecord motion;
+            motion.start = motionStart;
+            motion.end = now;
+            motion.x = truth.x;
+            motion.y = truth.y;
+            motion.theta = truth.theta;
+            motion.odomX = odom.x;
+            motion.odomY = odom.y;
+            motion.odomTheta = odom.theta;
+            motion.saved = chassis.getState().settleSaved - savedStart;
+            record.motions.push_back(motion);
+        }
+        runningMotion = id;
+        motionStart = now;
+        savedStart = chassis.getState().settleSaved;
+    });
+
+    scheduler.setDelayJitter(options.jitter, options.seed);
+    sim::devices().competitionStatus = COMPETITION_CONNECTED | COMPETITION_AUTONOMOUS;
+    autonStarted = true;
+    void (*routine)() = routines.at(options.auton);
+    pros::Task autonTask([routine] { routine(); }, "autonomous");
+    bool timedOut = false;
+    while (autonTask.get_state() != pros::E_TASK_STATE_DELETED || chassis.isInMotion()) {
+        if (pros::millis() - start >= options.timeLimit) {
+            timedOut = true;
+            break;
+        }
+        pros::delay(10);
+    }
+
+    const uint32_t routeMs = pros::millis() - start;
+    const double wallMs = (wallNs() - wallStart) / 1e6;
+    const double robotCpuMs = (robotCpuNs() - robotCpuStart) / 1e6;
+    const double processCpuMs = (processCpuNs() - processCpuStart) / 1e6;
+    const double cycles = routeMs / 10.0;
+
+    if (options.record) {
+        record.timedOut = timedOut;
+        record.routeMs = routeMs;
+        sim::writeRunRecord(stdout, record);
+        std::fflush(stdout);
+        std::_Exit(0);
+    }
+
+    std::printf("routine:            %s%s\n", options.auton.c_str(), timedOut ? " (timed out)" : "");
+    std::printf("route time:         %.3f s virtual\n", routeMs / 1000.0);
+    std::printf("stalls:             %u motions ended pushing against something\n",
+                chassis.getState().stalls - stallsStart);
+    std::printf("wall time:          %.3f s (%.0fx real time)\n", wallMs / 1000, wallMs > 0 ? routeMs / wallMs : 0);
+    std::printf("robot code cpu:     %.3f ms, %.2f us per 10 ms control cycle\n", robotCpuMs,
+                cycles > 0 ? robotCpuMs * 1000 / cycles : 0);
+    std::printf("process cpu:        %.3f ms (includes the robot model and scheduler)\n", processCpuMs);
+    // tasks the routine started that have finished by its end are summed into one line
+    std::printf("tasks:\n");
+    uint64_t motionCpu = 0, motionSlices = 0, motionTasks = 0;
+    for (sim::Task* task : scheduler.tasks()) {
+        if (task->name == "main") continue;
+        const auto it = before.find(task);
+        const bool existed = it != before.end();
+        const uint64_t cpu = task->cpuNs - (existed ? it->second.first : 0);
+        const uint64_t slices = task->slices - (existed ? it->second.second : 0);
+        if (slices == 0) continue;
+        if (!existed && task->state == sim::Task::State::DELETED && task->name != "autonomous") {
+            motionCpu += cpu;
+            motionSlices += slices;
+            motionTasks++;
+            continue;
+        }
+        std::printf("  %-24s %9.3f ms %8" PRIu64 " slices\n", task->name.c_str(), cpu / 1e6, slices);
+    }
+    if (motionTasks != 0) {
+        const std::string name = std::to_string(motionTasks) + " short-lived tasks";
+        std::printf("  %-24s %9.3f ms %8" PRIu64 " slices\n", name.c_str(), motionCpu / 1e6, motionSlices);
+    }
+
+    const lemlib::Pose odom = chassis.getPose();
+    const sim::RobotState& truth = robot.state();
+    const lemlib::OdomStats odomStats = lemlib::getStats();
+    std::printf("odom loop:          %.0f Hz, %u updates, %u overruns, jitter %.1f us mean %u us max, "
+                "sample dt %.0f-%.0f ms\n",
+                1000.0 / odomStats.period, odomStats.updates, odomStats.overruns, odomStats.meanJitter,
+                odomStats.maxJitter, odomStats.minDt * 1000, odomStats.maxDt * 1000);
+    if (options.relocalize) {
+        const lemlib::RelocalizerStats stats = relocalizer.getStats();
+        // update times are in virtual time here, which doesn't advance while code runs. See make bench instead
+        std::printf("relocalizer:        %u updates, %u corrections, %u resamples, %u resets\n", stats.updates,
+                    stats.corrections, stats.resamples, stats.resets);
+    }
+    if (followingPath) {
+        std::printf("cross-track error:  %.3f in mean, %.3f in max\n",
+                    crossTrackSamples > 0 ? crossTrackSum / crossTrackSamples : 0, crossTrackMax);
+    }
+    std::printf("odom pose:          x %.2f in, y %.2f in, theta %.2f deg\n", odom.x, odom.y, odom.theta);
+    std::printf("true pose:          x %.2f in, y %.2f in, theta %.2f deg\n", truth.x, truth.y, truth.theta);
+    std::printf("odom error:         %.3f in, %.3f deg\n", std::hypot(odom.x - truth.x, odom.y - truth.y),
+                std::remainder(odom.theta - truth.theta, 360));
+    std::printf("distance driven:    %.1f in\n", truth.distance);
+    std::printf("battery:            %.2f V lowest, %.1f%% left\n", truth.minBatteryVoltage / 1000,
+                sim::devices().battery.capacity);
+    std::printf("solenoid changes:   %zu\n", sim::devices().digitalEvents.size());
+    // motions are numbered in the order they ran
+    uint32_t savedTotal = 0;
+    size_t settled = 0;
+    for (const sim::MotionRecord& motion : record.motions) {
+        savedTotal += motion.saved;
+        if (motion.saved != 0) settled++;
+    }
+    std::printf("settling:           %zu of %zu motions ended early, %u ms saved\n", settled, record.motions.size(),
+                savedTotal);
+    for (size_t m = 0; m < record.motions.size(); m++) {
+        const sim::MotionRecord& motion = record.motions[m];
+        if (motion.saved == 0) continue;
+        const double time = (motion.end - motion.start) / 1000.0;
+        std::printf("  motion %-3zu %6.3f s, %3u ms saved\n", m + 1, time, motion.saved);
+    }
+
+    // other tasks are parked on their own threads, so skip static destructors instead of tearing objects down
+    // underneath them
+    std::fflush(stdout);
+    std::_Exit(timedOut ? 1 : 0);
+}
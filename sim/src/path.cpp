@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "sim/path.hpp"
+
+namespace sim {
+namespace {
+struct Point {
+        double x;
+        double y;
+};
+
+/** @brief spacing of the points, in inches */
+constexpr double SPACING = 1;
+/** @brief velocity in the file, and the distance from the end over which it ramps down */
+constexpr double VELOCITY = 100;
+constexpr double RAMP = 12;
+constexpr double MIN_VELOCITY = 20;
+
+/**
+ * @brief Sample the centerline finely: a cubic Bezier S-bend from (0, -42) to (36, 6), then straight to (36, 42), which
+ * stops short of the wall
+ */
+std::vector<Point> centerline() {
+    const Point control[] = {{0, -42}, {0, -6}, {36, -30}, {36, 6}};
+    std::vector<Point> points;
+    for (int i = 0; i <= 1000; i++) {
+        const double t = i / 1000.0;
+        const double u = 1 - t;
+        const double a = u * u * u, b = 3 * u * u * t, c = 3 * u * t * t, d = t * t * t;
+        points.push_back({a * control[0].x + b * control[1].x + c * control[2].x + d * control[3].x,
+                          a * control[0].y + b * control[1].y + c * control[2].y + d * control[3].y});
+    }
+    for (int i = 1; i <= 360; i++) points.push_back({36, 6 + i / 10.0});
+    return points;
+}
+
+/** @brief the centerline resampled to evenly spaced points */
+const std::vector<Point>& pathPoints() {
+    static const std::vector<Point> points = [] {
+        const std::vector<Point> fine = centerline();
+        std::vector<Point> even = {fine.front()};
+        double travelled = 0;
+        for (std::size_t i = 1; i < fine.size(); i++) {
+            travelled += std::hypot(fine[i].x - fine[i - 1].x, fine[i].y - fine[i - 1].y);
+            if (travelled >= SPACING) {
+                even.push_back(fine[i]);
+                travelled = 0;
+            }
+        }
+        if (travelled > 0) even.push_back(fine.back());
+        return even;
+    }();
+    return points;
+}
+} // namespace
+
+const asset& testPath() {
+    static std::string text;
+    static asset file;
+    if (text.empty()) {
+        const std::vector<Point>& points = pathPoints();
+        for (std::size_t i = 0; i < points.size(); i++) {
+            const double remaining = (points.size() - 1 - i) * SPACING;
+            double velocity = std::max(MIN_VELOCITY, VELOCITY * std::min(1.0, remaining / RAMP));
+            if (i + 1 == points.size()) velocity = 0;
+            text += std::to_string(points[i].x) + ", " + std::to_string(points[i].y) + ", " + std::to_string(velocity) +
+                    "\n";
+        }
+        text += "endData\n";
+        file = {reinterpret_cast<uint8_t*>(text.data()), text.size()};
+    }
+    return file;
+}
+
+double distanceToTestPath(double x, double y) {
+    const std::vector<Point>& points = pathPoints();
+    double nearest = INFINITY;
+    for (std::size_t i = 1; i < points.size(); i++) {
+        const Point& a = points[i - 1];
+        const Point& b = points[i];
+        const double dx = b.x - a.x, dy = b.y - a.y;
+        const double t = std::clamp(((x - a.x) * dx + (y - a.y) * dy) / (dx * dx + dy * dy), 0.0, 1.0);
+        nearest = std::min(nearest, std::hypot(x - a.x - t * dx, y - a.y - t * dy));
+    }
+    return nearest;
+}
+} // namespace sim
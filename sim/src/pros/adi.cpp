@@ -0,0 +1,143 @@
+/**
+ * @file sim/src/pros/adi.cpp
+ * @brief Simulated PROS three-wire port API
+ */
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include "pros/adi.hpp"
+#include "pros/rtos.hpp"
+#include "sim/devices.hpp"
+
+namespace {
+/**
+ * @brief Convert a three-wire port given as 1-8, 'a'-'h' or 'A'-'H' to 1-8
+ *
+ * @return std::uint8_t 0 if the port is invalid
+ */
+std::uint8_t adiIndex(std::uint8_t port) {
+    if (port >= 'a' && port <= 'h') return port - 'a' + 1;
+    if (port >= 'A' && port <= 'H') return port - 'A' + 1;
+    if (port >= 1 && port <= 8) return port;
+    return 0;
+}
+
+/**
+ * @brief Get the simulated expander on a smart port, setting errno if the ports are invalid
+ */
+sim::Adi* adiAt(std::uint8_t smartPort, std::uint8_t adiPort) {
+    if (!sim::validPort(smartPort)) return nullptr;
+    if (adiPort == 0) {
+        errno = ENXIO;
+        return nullptr;
+    }
+    return &sim::devices().adi[smartPort];
+}
+} // namespace
+
+namespace pros {
+ADIPort::ADIPort(std::uint8_t adi_port, adi_port_config_e_t type)
+    : _smart_port(INTERNAL_ADI_PORT),
+      _adi_port(adiIndex(adi_port)) {
+    if (type != E_ADI_TYPE_UNDEFINED) set_config(type);
+}
+
+ADIPort::ADIPort(ext_adi_port_pair_t port_pair, adi_port_config_e_t type)
+    : _smart_port(port_pair.first),
+      _adi_port(adiIndex(port_pair.second)) {
+    if (type != E_ADI_TYPE_UNDEFINED) set_config(type);
+}
+
+std::int32_t ADIPort::get_config() const {
+    sim::Adi* adi = adiAt(_smart_port, _adi_port);
+    if (adi == nullptr) return PROS_ERR;
+    return adi->config[_adi_port - 1];
+}
+
+std::int32_t ADIPort::get_value() const {
+    sim::Adi* adi = adiAt(_smart_port, _adi_port);
+    if (adi == nullptr) return PROS_ERR;
+    return adi->value[_adi_port - 1];
+}
+
+std::int32_t ADIPort::set_config(adi_port_config_e_t type) const {
+    sim::Adi* adi = adiAt(_smart_port, _adi_port);
+    if (adi == nullptr) return PROS_ERR;
+    adi->config[_adi_port - 1] = type;
+    adi->value[_adi_port - 1] = 0;
+    return 1;
+}
+
+std::int32_t ADIPort::set_value(std::int32_t value) const {
+    sim::Adi* adi = adiAt(_smart_port, _adi_port);
+    if (adi == nullptr) return PROS_ERR;
+    const adi_port_config_e_t config = adi->config[_adi_port - 1];
+    if (config == E_ADI_DIGITAL_OUT) {
+        value = value != 0;
+        // record solenoid changes so routines can be checked against the mechanisms they fire
+        if (value != adi->value[_adi_port - 1]) {
+            sim::devices().digitalEvents.push_back({c::millis(), _smart_port, _adi_port, value != 0});
+        }
+    } else if (config != E_ADI_ANALOG_OUT && config != E_ADI_LEGACY_PWM && config != E_ADI_LEGACY_SERVO) {
+        errno = EADDRINUSE;
+        return PROS_ERR;
+    }
+    adi->value[_adi_port - 1] = value;
+    return 1;
+}
+
+ADIDigitalOut::ADIDigitalOut(std::uint8_t adi_port, bool init_state)
+    : ADIPort(adi_port, E_ADI_DIGITAL_OUT) {
+    set_value(init_state);
+}
+
+ADIDigitalOut::ADIDigitalOut(ext_adi_port_pair_t port_pair, bool init_state)
+    : ADIPort(port_pair, E_ADI_DIGITAL_OUT) {
+    set_value(init_state);
+}
+
+ADIDigitalIn::ADIDigitalIn(std::uint8_t adi_port)
+    : ADIPort(adi_port, E_ADI_DIGITAL_IN) {}
+
+ADIDigitalIn::ADIDigitalIn(ext_adi_port_pair_t port_pair)
+    : ADIPort(port_pair, E_ADI_DIGITAL_IN) {}
+
+std::int32_t ADIDigitalIn::get_new_press() const {
+    sim::Adi* adi = adiAt(_smart_port, _adi_port);
+    if (adi == nullptr) return PROS_ERR;
+    // last value seen by get_new_press on every port
+    static std::array<std::array<bool, 8>, sim::NUM_PORTS + 1> lastValue {};
+    bool& last = lastValue[_smart_port][_adi_port - 1];
+    const bool value = adi->value[_adi_port - 1] != 0;
+    const bool pressed = value && !last;
+    last = value;
+    return pressed;
+}
+
+ADIEncoder::ADIEncoder(std::uint8_t adi_port_top, std::uint8_t adi_port_bottom, bool reversed)
+    : ADIPort(adi_port_top, E_ADI_LEGACY_ENCODER) {
+    sim::Adi* adi = adiAt(_smart_port, _adi_port);
+    if (adi != nullptr) adi->reversed[_adi_port - 1] = reversed;
+}
+
+ADIEncoder::ADIEncoder(ext_adi_port_tuple_t port_tuple, bool reversed)
+    : ADIPort(ext_adi_port_pair_t(std::get<0>(port_tuple), std::get<1>(port_tuple)), E_ADI_LEGACY_ENCODER) {
+    sim::Adi* adi = adiAt(_smart_port, _adi_port);
+    if (adi != nullptr) adi->reversed[_adi_port - 1] = reversed;
+}
+
+std::int32_t ADIEncoder::reset() const {
+    sim::Adi* adi = adiAt(_smart_port, _adi_port);
+    if (adi == nullptr) return PROS_ERR;
+    adi->value[_adi_port - 1] = 0;
+    return 1;
+}
+
+std::int32_t ADIEncoder::get_value() const {
+    sim::Adi* adi = adiAt(_smart_port, _adi_port);
+    if (adi == nullptr) return PROS_ERR;
+    const std::int32_t value = adi->value[_adi_port - 1];
+    return adi->reversed[_adi_port - 1] ? -value : value;
+}
+} // namespace pros
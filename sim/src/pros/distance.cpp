@@ -0,0 +1,55 @@
+/**
+ * @file sim/src/pros/distance.cpp
+ * @brief Simulated PROS distance sensor API
+ */
+
+#include "pros/distance.hpp"
+#include "pros/error.h"
+#include "sim/devices.hpp"
+
+namespace {
+sim::Distance* distanceAt(std::uint8_t port) {
+    if (!sim::validPort(port)) return nullptr;
+    return &sim::devices().distances[port];
+}
+} // namespace
+
+namespace pros {
+namespace c {
+int32_t distance_get(uint8_t port) {
+    sim::Distance* distance = distanceAt(port);
+    if (distance == nullptr) return PROS_ERR;
+    return distance->sample.distance;
+}
+
+int32_t distance_get_confidence(uint8_t port) {
+    sim::Distance* distance = distanceAt(port);
+    if (distance == nullptr) return PROS_ERR;
+    return distance->sample.confidence;
+}
+
+int32_t distance_get_object_size(uint8_t port) {
+    sim::Distance* distance = distanceAt(port);
+    if (distance == nullptr) return PROS_ERR;
+    return distance->sample.objectSize;
+}
+
+double distance_get_object_velocity(uint8_t port) {
+    // the walls never move
+    return distanceAt(port) == nullptr ? PROS_ERR_F : 0;
+}
+} // namespace c
+
+Distance::Distance(const std::uint8_t port)
+    : _port(port) {}
+
+std::int32_t Distance::get() { return c::distance_get(_port); }
+
+std::int32_t Distance::get_confidence() { return c::distance_get_confidence(_port); }
+
+std::int32_t Distance::get_object_size() { return c::distance_get_object_size(_port); }
+
+double Distance::get_object_velocity() { return c::distance_get_object_velocity(_port); }
+
+std::uint8_t Distance::get_port() { return _port; }
+} // namespace pros
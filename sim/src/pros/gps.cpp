@@ -0,0 +1,137 @@
+/**
+ * @file sim/src/pros/gps.cpp
+ * @brief Simulated PROS GPS sensor API
+ *
+ * The simulated sensor always knows where it is, so the initial position and offset are accepted and ignored.
+ */
+
+#include <cmath>
+#include "pros/error.h"
+#include "pros/gps.hpp"
+#include "sim/devices.hpp"
+
+namespace {
+sim::Gps* gpsAt(std::uint8_t port) {
+    if (!sim::validPort(port)) return nullptr;
+    return &sim::devices().gps[port];
+}
+} // namespace
+
+namespace pros {
+namespace c {
+int32_t gps_initialize_full(uint8_t port, double xInitial, double yInitial, double headingInitial, double xOffset,
+                            double yOffset) {
+    return gpsAt(port) == nullptr ? PROS_ERR : 1;
+}
+
+int32_t gps_set_offset(uint8_t port, double xOffset, double yOffset) { return gpsAt(port) == nullptr ? PROS_ERR : 1; }
+
+int32_t gps_get_offset(uint8_t port, double* xOffset, double* yOffset) {
+    if (gpsAt(port) == nullptr) return PROS_ERR;
+    *xOffset = 0;
+    *yOffset = 0;
+    return 1;
+}
+
+int32_t gps_set_position(uint8_t port, double xInitial, double yInitial, double headingInitial) {
+    return gpsAt(port) == nullptr ? PROS_ERR : 1;
+}
+
+int32_t gps_set_data_rate(uint8_t port, uint32_t rate) {
+    sim::Gps* gps = gpsAt(port);
+    if (gps == nullptr) return PROS_ERR;
+    gps->dataRate = rate < 5 ? 5 : rate - rate % 5;
+    return 1;
+}
+
+double gps_get_error(uint8_t port) {
+    sim::Gps* gps = gpsAt(port);
+    if (gps == nullptr) return PROS_ERR_F;
+    return gps->sample.error;
+}
+
+gps_status_s_t gps_get_status(uint8_t port) {
+    gps_status_s_t out {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+    sim::Gps* gps = gpsAt(port);
+    if (gps == nullptr) return out;
+    out.x = gps->sample.x;
+    out.y = gps->sample.y;
+    out.pitch = 0;
+    out.roll = 0;
+    out.yaw = gps->sample.heading;
+    return out;
+}
+
+double gps_get_heading(uint8_t port) {
+    sim::Gps* gps = gpsAt(port);
+    if (gps == nullptr) return PROS_ERR_F;
+    return gps->sample.heading;
+}
+
+double gps_get_heading_raw(uint8_t port) { return gps_get_heading(port); }
+
+double gps_get_rotation(uint8_t port) {
+    sim::Gps* gps = gpsAt(port);
+    if (gps == nullptr) return PROS_ERR_F;
+    return gps->sample.rotation + gps->rotationOffset;
+}
+
+int32_t gps_set_rotation(uint8_t port, double target) {
+    sim::Gps* gps = gpsAt(port);
+    if (gps == nullptr) return PROS_ERR;
+    gps->rotationOffset = target - gps->sample.rotation;
+    return 1;
+}
+
+int32_t gps_tare_rotation(uint8_t port) { return gps_set_rotation(port, 0); }
+
+gps_gyro_s_t gps_get_gyro_rate(uint8_t port) {
+    gps_gyro_s_t out {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+    if (gpsAt(port) == nullptr) return out;
+    out = {0, 0, 0};
+    return out;
+}
+
+gps_accel_s_t gps_get_accel(uint8_t port) {
+    gps_accel_s_t out {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+    if (gpsAt(port) == nullptr) return out;
+    out = {0, 0, 0};
+    return out;
+}
+} // namespace c
+
+std::int32_t Gps::initialize_full(double xInitial, double yInitial, double headingInitial, double xOffset,
+                                  double yOffset) const {
+    return c::gps_initialize_full(_port, xInitial, yInitial, headingInitial, xOffset, yOffset);
+}
+
+std::int32_t Gps::set_offset(double xOffset, double yOffset) const { return c::gps_set_offset(_port, xOffset, yOffset); }
+
+std::int32_t Gps::get_offset(double* xOffset, double* yOffset) const {
+    return c::gps_get_offset(_port, xOffset, yOffset);
+}
+
+std::int32_t Gps::set_position(double xInitial, double yInitial, double headingInitial) const {
+    return c::gps_set_position(_port, xInitial, yInitial, headingInitial);
+}
+
+std::int32_t Gps::set_data_rate(std::uint32_t rate) const { return c::gps_set_data_rate(_port, rate); }
+
+double Gps::get_error() const { return c::gps_get_error(_port); }
+
+pros::c::gps_status_s_t Gps::get_status() const { return c::gps_get_status(_port); }
+
+double Gps::get_heading() const { return c::gps_get_heading(_port); }
+
+double Gps::get_heading_raw() const { return c::gps_get_heading_raw(_port); }
+
+double Gps::get_rotation() const { return c::gps_get_rotation(_port); }
+
+std::int32_t Gps::set_rotation(double target) const { return c::gps_set_rotation(_port, target); }
+
+std::int32_t Gps::tare_rotation() const { return c::gps_tare_rotation(_port); }
+
+pros::c::gps_gyro_s_t Gps::get_gyro_rate() const { return c::gps_get_gyro_rate(_port); }
+
+pros::c::gps_accel_s_t Gps::get_accel() const { return c::gps_get_accel(_port); }
+} // namespace pros
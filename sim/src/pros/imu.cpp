@@ -0,0 +1,174 @@
+/**
+ * @file sim/src/pros/imu.cpp
+ * @brief Simulated PROS inertial sensor API
+ */
+
+#include <cerrno>
+#include <cmath>
+#include "pros/error.h"
+#include "pros/imu.hpp"
+#include "pros/rtos.hpp"
+#include "sim/devices.hpp"
+
+namespace {
+/** @brief time the simulated IMU takes to calibrate, in ms */
+constexpr uint32_t CALIBRATION_TIME = 2000;
+
+/**
+ * @brief Get a calibrated IMU, setting errno if there isn't one
+ *
+ * @param port the smart port
+ * @return sim::Imu* nullptr if the port is invalid or the IMU is still calibrating
+ */
+sim::Imu* imuAt(std::uint8_t port) {
+    if (!sim::validPort(port)) return nullptr;
+    sim::Imu* imu = &sim::devices().imus[port];
+    if (pros::c::millis() < imu->calibrationEnd) {
+        errno = EAGAIN;
+        return nullptr;
+    }
+    return imu;
+}
+
+/** @brief wrap an angle to [0, 360) */
+double wrap360(double angle) {
+    angle = std::fmod(angle, 360);
+    return angle < 0 ? angle + 360 : angle;
+}
+
+/** @brief wrap an angle to [-180, 180) */
+double wrap180(double angle) { return wrap360(angle + 180) - 180; }
+} // namespace
+
+namespace pros {
+std::int32_t Imu::reset(bool blocking) const {
+    if (!sim::validPort(_port)) return PROS_ERR;
+    sim::Imu& imu = sim::devices().imus[_port];
+    imu.calibrationEnd = c::millis() + CALIBRATION_TIME;
+    // calibration zeroes the heading at wherever the robot is sitting
+    imu.rotationOffset = -imu.rotation;
+    imu.headingOffset = -imu.rotation;
+    if (blocking) c::delay(CALIBRATION_TIME);
+    return 1;
+}
+
+std::int32_t Imu::set_data_rate(std::uint32_t rate) const {
+    sim::Imu* imu = imuAt(_port);
+    if (imu == nullptr) return PROS_ERR;
+    // rounded down to a multiple of 5, with 5 ms as the minimum
+    imu->dataRate = rate < IMU_MINIMUM_DATA_RATE ? IMU_MINIMUM_DATA_RATE : rate - rate % IMU_MINIMUM_DATA_RATE;
+    return 1;
+}
+
+double Imu::get_rotation() const {
+    sim::Imu* imu = imuAt(_port);
+    if (imu == nullptr) return PROS_ERR_F;
+    return imu->sample.rotation + imu->rotationOffset;
+}
+
+double Imu::get_heading() const {
+    sim::Imu* imu = imuAt(_port);
+    if (imu == nullptr) return PROS_ERR_F;
+    return wrap360(imu->sample.rotation + imu->headingOffset);
+}
+
+pros::c::quaternion_s_t Imu::get_quaternion() const {
+    pros::c::quaternion_s_t out {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+    const double yaw = get_yaw();
+    if (yaw == PROS_ERR_F) return out;
+    // rotation about the z axis only, the simulated field is flat
+    const double half = -yaw * M_PI / 360;
+    out.x = 0;
+    out.y = 0;
+    out.z = std::sin(half);
+    out.w = std::cos(half);
+    return out;
+}
+
+pros::c::euler_s_t Imu::get_euler() const {
+    pros::c::euler_s_t out {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+    const double yaw = get_yaw();
+    if (yaw == PROS_ERR_F) return out;
+    out.pitch = 0;
+    out.roll = 0;
+    out.yaw = yaw;
+    return out;
+}
+
+double Imu::get_pitch() const { return imuAt(_port) ? 0 : PROS_ERR_F; }
+
+double Imu::get_roll() const { return imuAt(_port) ? 0 : PROS_ERR_F; }
+
+double Imu::get_yaw() const {
+    sim::Imu* imu = imuAt(_port);
+    if (imu == nullptr) return PROS_ERR_F;
+    return wrap180(imu->sample.rotation + imu->headingOffset);
+}
+
+pros::c::imu_gyro_s_t Imu::get_gyro_rate() const {
+    pros::c::imu_gyro_s_t out {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+    sim::Imu* imu = imuAt(_port);
+    if (imu == nullptr) return out;
+    out.x = 0;
+    out.y = 0;
+    out.z = imu->sample.gyroZ;
+    return out;
+}
+
+std::int32_t Imu::tare_rotation() const { return set_rotation(0); }
+
+std::int32_t Imu::tare_heading() const { return set_heading(0); }
+
+std::int32_t Imu::tare_pitch() const { return imuAt(_port) ? 1 : PROS_ERR; }
+
+std::int32_t Imu::tare_yaw() const { return set_yaw(0); }
+
+std::int32_t Imu::tare_roll() const { return imuAt(_port) ? 1 : PROS_ERR; }
+
+std::int32_t Imu::tare() const {
+    if (tare_rotation() == PROS_ERR) return PROS_ERR;
+    return tare_heading();
+}
+
+std::int32_t Imu::tare_euler() const { return tare_yaw(); }
+
+std::int32_t Imu::set_heading(const double target) const {
+    sim::Imu* imu = imuAt(_port);
+    if (imu == nullptr) return PROS_ERR;
+    imu->headingOffset = wrap360(target) - imu->sample.rotation;
+    return 1;
+}
+
+std::int32_t Imu::set_rotation(const double target) const {
+    sim::Imu* imu = imuAt(_port);
+    if (imu == nullptr) return PROS_ERR;
+    imu->rotationOffset = target - imu->sample.rotation;
+    return 1;
+}
+
+std::int32_t Imu::set_yaw(const double target) const { return set_heading(target); }
+
+std::int32_t Imu::set_pitch(const double target) const { return imuAt(_port) ? 1 : PROS_ERR; }
+
+std::int32_t Imu::set_roll(const double target) const { return imuAt(_port) ? 1 : PROS_ERR; }
+
+std::int32_t Imu::set_euler(const pros::c::euler_s_t target) const { return set_yaw(target.yaw); }
+
+pros::c::imu_accel_s_t Imu::get_accel() const {
+    pros::c::imu_accel_s_t out {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+    sim::Imu* imu = imuAt(_port);
+    if (imu == nullptr) return out;
+    out.x = imu->sample.accelX;
+    out.y = imu->sample.accelY;
+    out.z = 1;
+    return out;
+}
+
+pros::c::imu_status_e_t Imu::get_status() const {
+    if (!sim::validPort(_port)) return pros::c::E_IMU_STATUS_ERROR;
+    const bool calibrating = c::millis() < sim::devices().imus[_port].calibrationEnd;
+    return calibrating ? pros::c::E_IMU_STATUS_CALIBRATING : static_cast<pros::c::imu_status_e_t>(0);
+}
+
+bool Imu::is_calibrating() const { return get_status() == pros::c::E_IMU_STATUS_CALIBRATING; }
+} // namespace pros
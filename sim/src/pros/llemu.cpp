@@ -0,0 +1,121 @@
+/**
+ * @file sim/src/pros/llemu.cpp
+ * @brief Simulated PROS LCD emulator
+ *
+ * Lines written to the emulated screen are kept in memory but not displayed, so routines that print telemetry every
+ * cycle don't slow down the simulation.
+ */
+
+#include <array>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+#include "pros/llemu.hpp"
+
+namespace {
+bool initialized = false;
+std::array<std::string, 8> lines;
+std::array<pros::lcd_btn_cb_fn_t, 3> callbacks {};
+
+bool validLine(int16_t line) {
+    if (!initialized) {
+        errno = ENXIO;
+        return false;
+    }
+    if (line < 0 || line >= int16_t(lines.size())) {
+        errno = EINVAL;
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+namespace pros {
+namespace c {
+bool lcd_is_initialized(void) { return initialized; }
+
+bool lcd_initialize(void) {
+    if (initialized) return false;
+    initialized = true;
+    return true;
+}
+
+bool lcd_shutdown(void) {
+    if (!initialized) return false;
+    initialized = false;
+    return true;
+}
+
+bool lcd_print(int16_t line, const char* fmt, ...) {
+    if (!validLine(line)) return false;
+    char buffer[64];
+    va_list args;
+    va_start(args, fmt);
+    std::vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+    lines[line] = buffer;
+    return true;
+}
+
+bool lcd_set_text(int16_t line, const char* text) {
+    if (!validLine(line)) return false;
+    lines[line] = text;
+    return true;
+}
+
+bool lcd_clear(void) {
+    if (!initialized) {
+        errno = ENXIO;
+        return false;
+    }
+    for (std::string& line : lines) line.clear();
+    return true;
+}
+
+bool lcd_clear_line(int16_t line) {
+    if (!validLine(line)) return false;
+    lines[line].clear();
+    return true;
+}
+
+bool lcd_register_btn0_cb(lcd_btn_cb_fn_t cb) {
+    callbacks[0] = cb;
+    return initialized;
+}
+
+bool lcd_register_btn1_cb(lcd_btn_cb_fn_t cb) {
+    callbacks[1] = cb;
+    return initialized;
+}
+
+bool lcd_register_btn2_cb(lcd_btn_cb_fn_t cb) {
+    callbacks[2] = cb;
+    return initialized;
+}
+
+uint8_t lcd_read_buttons(void) { return 0; }
+} // namespace c
+
+namespace lcd {
+bool is_initialized(void) { return c::lcd_is_initialized(); }
+
+bool initialize(void) { return c::lcd_initialize(); }
+
+bool shutdown(void) { return c::lcd_shutdown(); }
+
+bool set_text(std::int16_t line, std::string text) { return c::lcd_set_text(line, text.c_str()); }
+
+bool clear(void) { return c::lcd_clear(); }
+
+bool clear_line(std::int16_t line) { return c::lcd_clear_line(line); }
+
+void register_btn0_cb(lcd_btn_cb_fn_t cb) { c::lcd_register_btn0_cb(cb); }
+
+void register_btn1_cb(lcd_btn_cb_fn_t cb) { c::lcd_register_btn1_cb(cb); }
+
+void register_btn2_cb(lcd_btn_cb_fn_t cb) { c::lcd_register_btn2_cb(cb); }
+
+std::uint8_t read_buttons(void) { return c::lcd_read_buttons(); }
+} // namespace lcd
+} // namespace pros
@@ -0,0 +1,146 @@
+/**
+ * @file sim/src/pros/misc.cpp
+ * @brief Simulated PROS controller, battery and competition API
+ */
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include "pros/misc.hpp"
+#include "sim/devices.hpp"
+
+namespace {
+sim::Controller* controllerAt(pros::controller_id_e_t id) {
+    switch (id) {
+        case pros::E_CONTROLLER_MASTER: return &sim::devices().master;
+        case pros::E_CONTROLLER_PARTNER: return &sim::devices().partner;
+        default: errno = EINVAL; return nullptr;
+    }
+}
+} // namespace
+
+namespace pros {
+namespace c {
+uint8_t competition_get_status(void) { return sim::devices().competitionStatus; }
+
+int32_t controller_is_connected(controller_id_e_t id) { return controllerAt(id) ? 1 : PROS_ERR; }
+
+int32_t controller_get_analog(controller_id_e_t id, controller_analog_e_t channel) {
+    sim::Controller* controller = controllerAt(id);
+    if (controller == nullptr) return PROS_ERR;
+    if (channel < 0 || channel >= int(controller->analog.size())) {
+        errno = EINVAL;
+        return 0;
+    }
+    return controller->analog[channel];
+}
+
+int32_t controller_get_battery_capacity(controller_id_e_t id) { return controllerAt(id) ? 100 : PROS_ERR; }
+
+int32_t controller_get_battery_level(controller_id_e_t id) { return controllerAt(id) ? 100 : PROS_ERR; }
+
+int32_t controller_get_digital(controller_id_e_t id, controller_digital_e_t button) {
+    sim::Controller* controller = controllerAt(id);
+    if (controller == nullptr) return PROS_ERR;
+    if (button < 0 || button >= int(controller->digital.size())) {
+        errno = EINVAL;
+        return 0;
+    }
+    return controller->digital[button];
+}
+
+int32_t controller_get_digital_new_press(controller_id_e_t id, controller_digital_e_t button) {
+    sim::Controller* controller = controllerAt(id);
+    if (controller == nullptr) return PROS_ERR;
+    if (button < 0 || button >= int(controller->digital.size())) {
+        errno = EINVAL;
+        return 0;
+    }
+    const bool pressed = controller->digital[button] && !controller->pressed[button];
+    controller->pressed[button] = controller->digital[button];
+    return pressed;
+}
+
+// the simulated controller has no screen, so text is accepted and dropped
+int32_t controller_print(controller_id_e_t id, uint8_t line, uint8_t col, const char* fmt, ...) {
+    return controllerAt(id) ? 1 : PROS_ERR;
+}
+
+int32_t controller_set_text(controller_id_e_t id, uint8_t line, uint8_t col, const char* str) {
+    return controllerAt(id) ? 1 : PROS_ERR;
+}
+
+int32_t controller_clear_line(controller_id_e_t id, uint8_t line) { return controllerAt(id) ? 1 : PROS_ERR; }
+
+int32_t controller_clear(controller_id_e_t id) { return controllerAt(id) ? 1 : PROS_ERR; }
+
+int32_t controller_rumble(controller_id_e_t id, const char* rumble_pattern) {
+    return controllerAt(id) ? 1 : PROS_ERR;
+}
+
+int32_t battery_get_voltage(void) { return int32_t(sim::devices().battery.voltage); }
+
+int32_t battery_get_current(void) { return int32_t(sim::devices().battery.current); }
+
+double battery_get_temperature(void) { return sim::devices().battery.temperature; }
+
+double battery_get_capacity(void) { return sim::devices().battery.capacity; }
+
+int32_t usd_is_installed(void) { return 1; }
+} // namespace c
+
+Controller::Controller(controller_id_e_t id)
+    : _id(id) {}
+
+std::int32_t Controller::is_connected(void) { return c::controller_is_connected(_id); }
+
+std::int32_t Controller::get_analog(controller_analog_e_t channel) { return c::controller_get_analog(_id, channel); }
+
+std::int32_t Controller::get_battery_capacity(void) { return c::controller_get_battery_capacity(_id); }
+
+std::int32_t Controller::get_battery_level(void) { return c::controller_get_battery_level(_id); }
+
+std::int32_t Controller::get_digital(controller_digital_e_t button) { return c::controller_get_digital(_id, button); }
+
+std::int32_t Controller::get_digital_new_press(controller_digital_e_t button) {
+    return c::controller_get_digital_new_press(_id, button);
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const char* str) {
+    return c::controller_set_text(_id, line, col, str);
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const std::string& str) {
+    return c::controller_set_text(_id, line, col, str.c_str());
+}
+
+std::int32_t Controller::clear_line(std::uint8_t line) { return c::controller_clear_line(_id, line); }
+
+std::int32_t Controller::rumble(const char* rumble_pattern) { return c::controller_rumble(_id, rumble_pattern); }
+
+std::int32_t Controller::clear(void) { return c::controller_clear(_id); }
+
+namespace battery {
+double get_capacity(void) { return c::battery_get_capacity(); }
+
+int32_t get_current(void) { return c::battery_get_current(); }
+
+double get_temperature(void) { return c::battery_get_temperature(); }
+
+int32_t get_voltage(void) { return c::battery_get_voltage(); }
+} // namespace battery
+
+namespace competition {
+std::uint8_t get_status(void) { return c::competition_get_status(); }
+
+std::uint8_t is_autonomous(void) { return (c::competition_get_status() & COMPETITION_AUTONOMOUS) != 0; }
+
+std::uint8_t is_connected(void) { return (c::competition_get_status() & COMPETITION_CONNECTED) != 0; }
+
+std::uint8_t is_disabled(void) { return (c::competition_get_status() & COMPETITION_DISABLED) != 0; }
+} // namespace competition
+
+namespace usd {
+std::int32_t is_installed(void) { return c::usd_is_installed(); }
+} // namespace usd
+} // namespace pros
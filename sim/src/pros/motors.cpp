@@ -0,0 +1,630 @@
+/**
+ * @file sim/src/pros/motors.cpp
+ * @brief Simulated PROS motor API
+ *
+ * Commands are stored on the simulated motor and carried out by the robot model on the next tick. Getters report the
+ * last sample the motor sent to the brain.
+ */
+
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include "pros/error.h"
+#include "pros/motors.hpp"
+#include "pros/rtos.hpp"
+#include "sim/devices.hpp"
+
+namespace {
+sim::Motor* motorAt(std::uint8_t port) {
+    if (!sim::validPort(port)) return nullptr;
+    return &sim::devices().motors[port];
+}
+
+/** @brief convert degrees to the encoder units of a motor */
+double toUnits(const sim::Motor& motor, double degrees) {
+    switch (motor.units) {
+        case pros::E_MOTOR_ENCODER_ROTATIONS: return degrees / 360;
+        case pros::E_MOTOR_ENCODER_COUNTS: return degrees / 360 * sim::cartridgeTicks(motor.gearset);
+        default: return degrees;
+    }
+}
+
+/** @brief convert the encoder units of a motor to degrees */
+double fromUnits(const sim::Motor& motor, double value) {
+    switch (motor.units) {
+        case pros::E_MOTOR_ENCODER_ROTATIONS: return value * 360;
+        case pros::E_MOTOR_ENCODER_COUNTS: return value * 360 / sim::cartridgeTicks(motor.gearset);
+        default: return value;
+    }
+}
+} // namespace
+
+namespace pros {
+namespace c {
+int32_t motor_brake(uint8_t port) {
+    sim::Motor* motor = motorAt(port);
+    if (motor == nullptr) return PROS_ERR;
+    if (motor->mode != sim::Motor::Mode::BRAKE) {
+        motor->mode = sim::Motor::Mode::BRAKE;
+        motor->target = motor->position;
+    }
+    return 1;
+}
+
+int32_t motor_move(uint8_t port, int32_t voltage) {
+    if (voltage > 127) voltage = 127;
+    else if (voltage < -127) voltage = -127;
+    return motor_move_voltage(port, voltage * 12000 / 127);
+}
+
+int32_t motor_move_voltage(uint8_t port, const int32_t voltage) {
+    sim::Motor* motor = motorAt(port);
+    if (motor == nullptr) return PROS_ERR;
+    // the motor firmware treats 0 V as a request to stop with its brake mode
+    if (voltage == 0) return motor_brake(port);
+    motor->mode = sim::Motor::Mode::VOLTAGE;
+    motor->target = std::fmax(-12000, std::fmin(12000, voltage));
+    return 1;
+}
+} // namespace c
+
+Motor::Motor(const std::int8_t port, const motor_gearset_e_t gearset, const bool reverse,
+             const motor_encoder_units_e_t encoder_units)
+    : _port(std::abs(port)) {
+    set_gearing(gearset);
+    set_reversed(port < 0 ? !reverse : reverse);
+    set_encoder_units(encoder_units);
+}
+
+Motor::Motor(const std::int8_t port, const motor_gearset_e_t gearset, const bool reverse)
+    : _port(std::abs(port)) {
+    set_gearing(gearset);
+    set_reversed(port < 0 ? !reverse : reverse);
+}
+
+Motor::Motor(const std::int8_t port, const motor_gearset_e_t gearset)
+    : _port(std::abs(port)) {
+    set_gearing(gearset);
+    if (port < 0) set_reversed(true);
+}
+
+Motor::Motor(const std::int8_t port, const bool reverse)
+    : _port(std::abs(port)) {
+    set_reversed(port < 0 ? !reverse : reverse);
+}
+
+Motor::Motor(const std::int8_t port)
+    : _port(std::abs(port)) {
+    if (port < 0) set_reversed(true);
+}
+
+std::int32_t Motor::operator=(std::int32_t voltage) const { return move(voltage); }
+
+std::int32_t Motor::move(std::int32_t voltage) const { return c::motor_move(_port, voltage); }
+
+std::int32_t Motor::move_absolute(const double position, const std::int32_t velocity) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    motor->mode = sim::Motor::Mode::POSITION;
+    motor->target = fromUnits(*motor, position) + motor->zero;
+    motor->profileVelocity = velocity;
+    return 1;
+}
+
+std::int32_t Motor::move_relative(const double position, const std::int32_t velocity) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    // relative to the current target, like the real motor
+    const double base = motor->mode == sim::Motor::Mode::POSITION ? motor->target : motor->position;
+    motor->mode = sim::Motor::Mode::POSITION;
+    motor->target = base + fromUnits(*motor, position);
+    motor->profileVelocity = velocity;
+    return 1;
+}
+
+std::int32_t Motor::move_velocity(const std::int32_t velocity) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    if (velocity == 0) return brake();
+    motor->mode = sim::Motor::Mode::VELOCITY;
+    motor->target = velocity;
+    return 1;
+}
+
+std::int32_t Motor::move_voltage(const std::int32_t voltage) const {
+    return c::motor_move_voltage(_port, voltage);
+}
+
+std::int32_t Motor::brake(void) const { return c::motor_brake(_port); }
+
+std::int32_t Motor::modify_profiled_velocity(const std::int32_t velocity) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    motor->profileVelocity = velocity;
+    return 1;
+}
+
+double Motor::get_target_position(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR_F;
+    return toUnits(*motor, motor->target - motor->zero);
+}
+
+std::int32_t Motor::get_target_velocity(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    return motor->mode == sim::Motor::Mode::VELOCITY ? std::int32_t(motor->target) : 0;
+}
+
+double Motor::get_actual_velocity(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR_F;
+    return motor->sample.velocity;
+}
+
+std::int32_t Motor::get_current_draw(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    return std::int32_t(motor->sample.current);
+}
+
+std::int32_t Motor::get_direction(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    return motor->sample.velocity < 0 ? -1 : 1;
+}
+
+double Motor::get_efficiency(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR_F;
+    const double input = std::fabs(motor->sample.voltage * motor->sample.current) / 1e6;
+    if (input == 0) return 0;
+    const double output = std::fabs(motor->sample.torque * motor->sample.velocity * 2 * M_PI / 60);
+    return std::fmin(100, output / input * 100);
+}
+
+std::int32_t Motor::is_over_current(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    return std::fabs(motor->sample.current) >= motor->currentLimit;
+}
+
+std::int32_t Motor::is_stopped(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    return std::fabs(motor->sample.velocity) < 1;
+}
+
+std::int32_t Motor::get_zero_position_flag(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    return std::fabs(motor->sample.position - motor->zero) < 1;
+}
+
+std::uint32_t Motor::get_faults(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    return std::fabs(motor->sample.current) >= motor->currentLimit ? E_MOTOR_FAULT_OVER_CURRENT : E_MOTOR_FAULT_NO_FAULTS;
+}
+
+std::uint32_t Motor::get_flags(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    return is_stopped() ? E_MOTOR_FLAGS_ZERO_VELOCITY : E_MOTOR_FLAGS_NONE;
+}
+
+std::int32_t Motor::get_raw_position(std::uint32_t* const timestamp) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    if (timestamp != nullptr) *timestamp = motor->sample.timestamp;
+    return std::int32_t(std::lround(motor->sample.position / 360 * sim::cartridgeTicks(motor->gearset)));
+}
+
+std::int32_t Motor::is_over_temp(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    return 0;
+}
+
+double Motor::get_position(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR_F;
+    return toUnits(*motor, motor->sample.position - motor->zero);
+}
+
+double Motor::get_power(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR_F;
+    return std::fabs(motor->sample.voltage * motor->sample.current) / 1e6;
+}
+
+double Motor::get_temperature(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR_F;
+    return 25;
+}
+
+double Motor::get_torque(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR_F;
+    return motor->sample.torque;
+}
+
+std::int32_t Motor::get_voltage(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    return std::int32_t(motor->sample.voltage);
+}
+
+std::int32_t Motor::set_zero_position(const double position) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    motor->zero = motor->sample.position - fromUnits(*motor, position);
+    return 1;
+}
+
+std::int32_t Motor::tare_position(void) const { return set_zero_position(0); }
+
+std::int32_t Motor::set_brake_mode(const motor_brake_mode_e_t mode) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    motor->brakeMode = mode;
+    return 1;
+}
+
+std::int32_t Motor::set_current_limit(const std::int32_t limit) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    motor->currentLimit = limit;
+    return 1;
+}
+
+std::int32_t Motor::set_encoder_units(const motor_encoder_units_e_t units) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    motor->units = units;
+    return 1;
+}
+
+std::int32_t Motor::set_gearing(const motor_gearset_e_t gearset) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    motor->gearset = gearset;
+    return 1;
+}
+
+motor_pid_s_t Motor::convert_pid(double kf, double kp, double ki, double kd) {
+    motor_pid_s_t pid;
+    pid.kf = std::uint8_t(kf * 16);
+    pid.kp = std::uint8_t(kp * 16);
+    pid.ki = std::uint8_t(ki * 16);
+    pid.kd = std::uint8_t(kd * 16);
+    return pid;
+}
+
+motor_pid_full_s_t Motor::convert_pid_full(double kf, double kp, double ki, double kd, double filter, double limit,
+                                           double threshold, double loopspeed) {
+    motor_pid_full_s_t pid;
+    pid.kf = std::uint8_t(kf * 16);
+    pid.kp = std::uint8_t(kp * 16);
+    pid.ki = std::uint8_t(ki * 16);
+    pid.kd = std::uint8_t(kd * 16);
+    pid.filter = std::uint8_t(filter * 16);
+    pid.limit = std::uint16_t(limit * 16);
+    pid.threshold = std::uint8_t(threshold * 16);
+    pid.loopspeed = std::uint8_t(loopspeed * 16);
+    return pid;
+}
+
+// the simulated motors use a fixed internal controller, so PID changes are accepted and ignored
+std::int32_t Motor::set_pos_pid(const motor_pid_s_t pid) const { return motorAt(_port) ? 1 : PROS_ERR; }
+
+std::int32_t Motor::set_pos_pid_full(const motor_pid_full_s_t pid) const { return motorAt(_port) ? 1 : PROS_ERR; }
+
+std::int32_t Motor::set_vel_pid(const motor_pid_s_t pid) const { return motorAt(_port) ? 1 : PROS_ERR; }
+
+std::int32_t Motor::set_vel_pid_full(const motor_pid_full_s_t pid) const { return motorAt(_port) ? 1 : PROS_ERR; }
+
+std::int32_t Motor::set_reversed(const bool reverse) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    motor->reversed = reverse;
+    return 1;
+}
+
+std::int32_t Motor::set_voltage_limit(const std::int32_t limit) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    motor->voltageLimit = limit;
+    return 1;
+}
+
+motor_brake_mode_e_t Motor::get_brake_mode(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return E_MOTOR_BRAKE_INVALID;
+    return motor->brakeMode;
+}
+
+std::int32_t Motor::get_current_limit(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    return motor->currentLimit;
+}
+
+motor_encoder_units_e_t Motor::get_encoder_units(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return E_MOTOR_ENCODER_INVALID;
+    return motor->units;
+}
+
+motor_gearset_e_t Motor::get_gearing(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return E_MOTOR_GEARSET_INVALID;
+    return motor->gearset;
+}
+
+motor_pid_full_s_t Motor::get_pos_pid(void) const { return motor_pid_full_s_t {}; }
+
+motor_pid_full_s_t Motor::get_vel_pid(void) const { return motor_pid_full_s_t {}; }
+
+std::int32_t Motor::is_reversed(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    return motor->reversed;
+}
+
+std::int32_t Motor::get_voltage_limit(void) const {
+    sim::Motor* motor = motorAt(_port);
+    if (motor == nullptr) return PROS_ERR;
+    return motor->voltageLimit;
+}
+
+std::uint8_t Motor::get_port(void) const { return _port; }
+
+Motor_Group::Motor_Group(const std::initializer_list<Motor> motors)
+    : _motors(motors),
+      _motor_count(motors.size()) {}
+
+Motor_Group::Motor_Group(const std::vector<pros::Motor>& motors)
+    : _motors(motors),
+      _motor_count(motors.size()) {}
+
+Motor_Group::Motor_Group(const std::initializer_list<std::int8_t> motor_ports)
+    : Motor_Group(std::vector<std::int8_t>(motor_ports)) {}
+
+Motor_Group::Motor_Group(const std::vector<std::int8_t> motor_ports)
+    : _motor_count(motor_ports.size()) {
+    for (std::int8_t port : motor_ports) _motors.emplace_back(port);
+}
+
+std::int32_t Motor_Group::operator=(std::int32_t voltage) { return move(voltage); }
+
+std::int32_t Motor_Group::move(std::int32_t voltage) {
+    std::int32_t out = 1;
+    for (Motor& motor : _motors) {
+        if (motor.move(voltage) == PROS_ERR) out = PROS_ERR;
+    }
+    return out;
+}
+
+std::int32_t Motor_Group::move_absolute(const double position, const std::int32_t velocity) {
+    std::int32_t out = 1;
+    for (Motor& motor : _motors) {
+        if (motor.move_absolute(position, velocity) == PROS_ERR) out = PROS_ERR;
+    }
+    return out;
+}
+
+std::int32_t Motor_Group::move_relative(const double position, const std::int32_t velocity) {
+    std::int32_t out = 1;
+    for (Motor& motor : _motors) {
+        if (motor.move_relative(position, velocity) == PROS_ERR) out = PROS_ERR;
+    }
+    return out;
+}
+
+std::int32_t Motor_Group::move_velocity(const std::int32_t velocity) {
+    std::int32_t out = 1;
+    for (Motor& motor : _motors) {
+        if (motor.move_velocity(velocity) == PROS_ERR) out = PROS_ERR;
+    }
+    return out;
+}
+
+std::int32_t Motor_Group::move_voltage(const std::int32_t voltage) {
+    std::int32_t out = 1;
+    for (Motor& motor : _motors) {
+        if (motor.move_voltage(voltage) == PROS_ERR) out = PROS_ERR;
+    }
+    return out;
+}
+
+std::int32_t Motor_Group::brake(void) {
+    std::int32_t out = 1;
+    for (Motor& motor : _motors) {
+        if (motor.brake() == PROS_ERR) out = PROS_ERR;
+    }
+    return out;
+}
+
+std::vector<std::uint32_t> Motor_Group::get_voltages(void) {
+    std::vector<std::uint32_t> out;
+    for (Motor& motor : _motors) out.push_back(motor.get_voltage());
+    return out;
+}
+
+std::vector<std::uint32_t> Motor_Group::get_voltage_limits(void) {
+    std::vector<std::uint32_t> out;
+    for (Motor& motor : _motors) out.push_back(motor.get_voltage_limit());
+    return out;
+}
+
+std::vector<std::int32_t> Motor_Group::get_raw_positions(std::vector<std::uint32_t*>& timestamps) {
+    std::vector<std::int32_t> out;
+    // PROS writes a timestamp for every motor without checking, so a short vector throws here instead
+    for (int i = 0; i < _motor_count; i++) out.push_back(_motors[i].get_raw_position(timestamps.at(i)));
+    return out;
+}
+
+pros::Motor& Motor_Group::operator[](int i) { return _motors[i]; }
+
+pros::Motor& Motor_Group::at(int i) {
+    if (i < 0 || i >= _motor_count) throw std::out_of_range("Motor_Group::at: index out of range");
+    return _motors[i];
+}
+
+std::int32_t Motor_Group::size() { return _motor_count; }
+
+std::int32_t Motor_Group::set_zero_position(const double position) {
+    std::int32_t out = 1;
+    for (Motor& motor : _motors) {
+        if (motor.set_zero_position(position) == PROS_ERR) out = PROS_ERR;
+    }
+    return out;
+}
+
+std::int32_t Motor_Group::set_brake_modes(motor_brake_mode_e_t mode) {
+    std::int32_t out = 1;
+    for (Motor& motor : _motors) {
+        if (motor.set_brake_mode(mode) == PROS_ERR) out = PROS_ERR;
+    }
+    return out;
+}
+
+std::int32_t Motor_Group::set_reversed(const bool reversed) {
+    std::int32_t out = 1;
+    for (Motor& motor : _motors) {
+        if (motor.set_reversed(reversed) == PROS_ERR) out = PROS_ERR;
+    }
+    return out;
+}
+
+std::int32_t Motor_Group::set_voltage_limit(const std::int32_t limit) {
+    std::int32_t out = 1;
+    for (Motor& motor : _motors) {
+        if (motor.set_voltage_limit(limit) == PROS_ERR) out = PROS_ERR;
+    }
+    return out;
+}
+
+std::int32_t Motor_Group::set_gearing(const motor_gearset_e_t gearset) {
+    std::int32_t out = 1;
+    for (Motor& motor : _motors) {
+        if (motor.set_gearing(gearset) == PROS_ERR) out = PROS_ERR;
+    }
+    return out;
+}
+
+std::int32_t Motor_Group::set_encoder_units(const motor_encoder_units_e_t units) {
+    std::int32_t out = 1;
+    for (Motor& motor : _motors) {
+        if (motor.set_encoder_units(units) == PROS_ERR) out = PROS_ERR;
+    }
+    return out;
+}
+
+std::int32_t Motor_Group::tare_position(void) {
+    std::int32_t out = 1;
+    for (Motor& motor : _motors) {
+        if (motor.tare_position() == PROS_ERR) out = PROS_ERR;
+    }
+    return out;
+}
+
+std::vector<double> Motor_Group::get_actual_velocities(void) {
+    std::vector<double> out;
+    for (Motor& motor : _motors) out.push_back(motor.get_actual_velocity());
+    return out;
+}
+
+std::vector<std::int32_t> Motor_Group::get_target_velocities(void) {
+    std::vector<std::int32_t> out;
+    for (Motor& motor : _motors) out.push_back(motor.get_target_velocity());
+    return out;
+}
+
+std::vector<double> Motor_Group::get_target_positions(void) {
+    std::vector<double> out;
+    for (Motor& motor : _motors) out.push_back(motor.get_target_position());
+    return out;
+}
+
+std::vector<double> Motor_Group::get_positions(void) {
+    std::vector<double> out;
+    for (Motor& motor : _motors) out.push_back(motor.get_position());
+    return out;
+}
+
+std::vector<double> Motor_Group::get_efficiencies(void) {
+    std::vector<double> out;
+    for (Motor& motor : _motors) out.push_back(motor.get_efficiency());
+    return out;
+}
+
+std::vector<std::int32_t> Motor_Group::are_over_current(void) {
+    std::vector<std::int32_t> out;
+    for (Motor& motor : _motors) out.push_back(motor.is_over_current());
+    return out;
+}
+
+std::vector<std::int32_t> Motor_Group::are_over_temp(void) {
+    std::vector<std::int32_t> out;
+    for (Motor& motor : _motors) out.push_back(motor.is_over_temp());
+    return out;
+}
+
+std::vector<pros::motor_brake_mode_e_t> Motor_Group::get_brake_modes(void) {
+    std::vector<pros::motor_brake_mode_e_t> out;
+    for (Motor& motor : _motors) out.push_back(motor.get_brake_mode());
+    return out;
+}
+
+std::vector<motor_gearset_e_t> Motor_Group::get_gearing(void) {
+    std::vector<motor_gearset_e_t> out;
+    for (Motor& motor : _motors) out.push_back(motor.get_gearing());
+    return out;
+}
+
+std::vector<std::int32_t> Motor_Group::get_current_draws(void) {
+    std::vector<std::int32_t> out;
+    for (Motor& motor : _motors) out.push_back(motor.get_current_draw());
+    return out;
+}
+
+std::vector<std::int32_t> Motor_Group::get_current_limits(void) {
+    std::vector<std::int32_t> out;
+    for (Motor& motor : _motors) out.push_back(motor.get_current_limit());
+    return out;
+}
+
+std::vector<std::uint8_t> Motor_Group::get_ports(void) {
+    std::vector<std::uint8_t> out;
+    for (Motor& motor : _motors) out.push_back(motor.get_port());
+    return out;
+}
+
+std::vector<std::int32_t> Motor_Group::get_directions(void) {
+    std::vector<std::int32_t> out;
+    for (Motor& motor : _motors) out.push_back(motor.get_direction());
+    return out;
+}
+
+std::vector<pros::motor_encoder_units_e_t> Motor_Group::get_encoder_units(void) {
+    std::vector<pros::motor_encoder_units_e_t> out;
+    for (Motor& motor : _motors) out.push_back(motor.get_encoder_units());
+    return out;
+}
+
+std::vector<double> Motor_Group::get_temperatures(void) {
+    std::vector<double> out;
+    for (Motor& motor : _motors) out.push_back(motor.get_temperature());
+    return out;
+}
+
+namespace literals {
+const pros::Motor operator"" _mtr(const unsigned long long int m) { return Motor(m, false); }
+
+const pros::Motor operator"" _rmtr(const unsigned long long int m) { return Motor(m, true); }
+} // namespace literals
+} // namespace pros
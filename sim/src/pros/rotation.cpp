@@ -0,0 +1,97 @@
+/**
+ * @file sim/src/pros/rotation.cpp
+ * @brief Simulated PROS rotation sensor API
+ */
+
+#include <cmath>
+#include "pros/error.h"
+#include "pros/rotation.hpp"
+#include "sim/devices.hpp"
+
+namespace {
+sim::Rotation* rotationAt(std::uint8_t port) {
+    if (!sim::validPort(port)) return nullptr;
+    return &sim::devices().rotations[port];
+}
+
+/** @brief position reported by the sensor, in centidegrees */
+double reported(const sim::Rotation& rotation) {
+    const double position = rotation.sample.position - rotation.zero;
+    return rotation.reversed ? -position : position;
+}
+} // namespace
+
+namespace pros {
+Rotation::Rotation(const std::uint8_t port, const bool reverse_flag)
+    : _port(port) {
+    set_reversed(reverse_flag);
+}
+
+std::int32_t Rotation::reset() {
+    sim::Rotation* rotation = rotationAt(_port);
+    if (rotation == nullptr) return PROS_ERR;
+    // resets the position to the absolute angle of the shaft
+    const double sign = rotation->reversed ? -1 : 1;
+    double angle = std::fmod(sign * rotation->sample.position, 36000);
+    if (angle < 0) angle += 36000;
+    rotation->zero = rotation->sample.position - sign * angle;
+    return 1;
+}
+
+std::int32_t Rotation::set_data_rate(std::uint32_t rate) const {
+    sim::Rotation* rotation = rotationAt(_port);
+    if (rotation == nullptr) return PROS_ERR;
+    // rounded down to a multiple of 5, with 5 ms as the minimum
+    rotation->dataRate = rate < 5 ? 5 : rate - rate % 5;
+    return 1;
+}
+
+std::int32_t Rotation::set_position(std::uint32_t position) {
+    sim::Rotation* rotation = rotationAt(_port);
+    if (rotation == nullptr) return PROS_ERR;
+    const double target = rotation->reversed ? -double(position) : double(position);
+    rotation->zero = rotation->sample.position - target;
+    return 1;
+}
+
+std::int32_t Rotation::reset_position(void) { return set_position(0); }
+
+std::int32_t Rotation::get_position() {
+    sim::Rotation* rotation = rotationAt(_port);
+    if (rotation == nullptr) return PROS_ERR;
+    return std::int32_t(std::lround(reported(*rotation)));
+}
+
+std::int32_t Rotation::get_velocity() {
+    sim::Rotation* rotation = rotationAt(_port);
+    if (rotation == nullptr) return PROS_ERR;
+    return std::int32_t(std::lround(rotation->reversed ? -rotation->sample.velocity : rotation->sample.velocity));
+}
+
+std::int32_t Rotation::get_angle() {
+    sim::Rotation* rotation = rotationAt(_port);
+    if (rotation == nullptr) return PROS_ERR;
+    const double angle = std::fmod(rotation->reversed ? -rotation->sample.position : rotation->sample.position, 36000);
+    return std::int32_t(std::lround(angle < 0 ? angle + 36000 : angle));
+}
+
+std::int32_t Rotation::set_reversed(bool value) {
+    sim::Rotation* rotation = rotationAt(_port);
+    if (rotation == nullptr) return PROS_ERR;
+    rotation->reversed = value;
+    return 1;
+}
+
+std::int32_t Rotation::reverse() {
+    sim::Rotation* rotation = rotationAt(_port);
+    if (rotation == nullptr) return PROS_ERR;
+    rotation->reversed = !rotation->reversed;
+    return 1;
+}
+
+std::int32_t Rotation::get_reversed() {
+    sim::Rotation* rotation = rotationAt(_port);
+    if (rotation == nullptr) return PROS_ERR;
+    return rotation->reversed;
+}
+} // namespace pros
@@ -0,0 +1,234 @@
+/**
+ * @file sim/src/pros/rtos.cpp
+ * @brief Simulated PROS RTOS facilities, backed by the virtual-time scheduler
+ */
+
+#include <cstring>
+#include "pros/rtos.hpp"
+#include "sim/scheduler.hpp"
+
+using sim::Scheduler;
+
+namespace {
+sim::Task* toTask(pros::task_t task) {
+    if (task == nullptr) return Scheduler::get().current();
+    return static_cast<sim::Task*>(task);
+}
+} // namespace
+
+namespace pros {
+namespace c {
+uint32_t millis(void) { return Scheduler::get().now(); }
+
+uint64_t micros(void) { return uint64_t(Scheduler::get().now()) * 1000; }
+
+task_t task_create(task_fn_t function, void* const parameters, uint32_t prio, const uint16_t stack_depth,
+                   const char* const name) {
+    return Scheduler::get().create(function, parameters, prio, name);
+}
+
+void task_delete(task_t task) { Scheduler::get().remove(toTask(task)); }
+
+void task_delay(const uint32_t milliseconds) {
+    Scheduler& scheduler = Scheduler::get();
+    if (milliseconds == 0) scheduler.yield();
+    else scheduler.sleepUntil(scheduler.now() + milliseconds + scheduler.delayJitter());
+}
+
+void delay(const uint32_t milliseconds) { task_delay(milliseconds); }
+
+void task_delay_until(uint32_t* const prev_time, const uint32_t delta) {
+    Scheduler& scheduler = Scheduler::get();
+    const uint32_t wakeTime = *prev_time + delta;
+    *prev_time = wakeTime;
+    // like FreeRTOS, a deadline that has already passed does not block
+    if (wakeTime > scheduler.now()) scheduler.sleepUntil(wakeTime);
+}
+
+uint32_t task_get_priority(task_t task) { return toTask(task)->priority; }
+
+void task_set_priority(task_t task, uint32_t prio) {
+    toTask(task)->priority = prio;
+    Scheduler::get().yield();
+}
+
+task_state_e_t task_get_state(task_t task) {
+    sim::Task* t = toTask(task);
+    if (t == Scheduler::get().current()) return E_TASK_STATE_RUNNING;
+    switch (t->state) {
+        case sim::Task::State::READY: return E_TASK_STATE_READY;
+        case sim::Task::State::BLOCKED: return E_TASK_STATE_BLOCKED;
+        case sim::Task::State::SUSPENDED: return E_TASK_STATE_SUSPENDED;
+        case sim::Task::State::DELETED: return E_TASK_STATE_DELETED;
+    }
+    return E_TASK_STATE_INVALID;
+}
+
+void task_suspend(task_t task) { Scheduler::get().suspend(toTask(task)); }
+
+void task_resume(task_t task) { Scheduler::get().resume(toTask(task)); }
+
+uint32_t task_get_count(void) {
+    uint32_t count = 0;
+    for (sim::Task* task : Scheduler::get().tasks()) {
+        if (task->state != sim::Task::State::DELETED) count++;
+    }
+    return count;
+}
+
+char* task_get_name(task_t task) { return const_cast<char*>(toTask(task)->name.c_str()); }
+
+task_t task_get_by_name(const char* name) {
+    for (sim::Task* task : Scheduler::get().tasks()) {
+        if (task->state != sim::Task::State::DELETED && task->name == name) return task;
+    }
+    return nullptr;
+}
+
+task_t task_get_current() { return Scheduler::get().current(); }
+
+uint32_t task_notify(task_t task) { return task_notify_ext(task, 1, E_NOTIFY_ACTION_INCR, nullptr); }
+
+void task_join(task_t task) {
+    sim::Task* t = toTask(task);
+    if (t->state != sim::Task::State::DELETED) Scheduler::get().block(t, TIMEOUT_MAX);
+}
+
+uint32_t task_notify_ext(task_t task, uint32_t value, notify_action_e_t action, uint32_t* prev_value) {
+    sim::Task* t = toTask(task);
+    if (prev_value != nullptr) *prev_value = t->notifyValue;
+    uint32_t result = 1;
+    switch (action) {
+        case E_NOTIFY_ACTION_NONE: break;
+        case E_NOTIFY_ACTION_BITS: t->notifyValue |= value; break;
+        case E_NOTIFY_ACTION_INCR: t->notifyValue++; break;
+        case E_NOTIFY_ACTION_OWRITE: t->notifyValue = value; break;
+        case E_NOTIFY_ACTION_NO_OWRITE:
+            if (t->notifyWaiting) result = 0;
+            else t->notifyValue = value;
+            break;
+    }
+    t->notifyWaiting = true;
+    if (t->state == sim::Task::State::BLOCKED && t->waitingOn == &t->notifyValue) Scheduler::get().wake(t);
+    return result;
+}
+
+uint32_t task_notify_take(bool clear_on_exit, uint32_t timeout) {
+    sim::Task* t = Scheduler::get().current();
+    if (t->notifyValue == 0) Scheduler::get().block(&t->notifyValue, timeout);
+    const uint32_t value = t->notifyValue;
+    if (value != 0) t->notifyValue = clear_on_exit ? 0 : value - 1;
+    t->notifyWaiting = false;
+    return value;
+}
+
+bool task_notify_clear(task_t task) {
+    sim::Task* t = toTask(task);
+    const bool pending = t->notifyWaiting;
+    t->notifyWaiting = false;
+    return pending;
+}
+
+mutex_t mutex_create(void) { return new sim::Mutex(); }
+
+bool mutex_take(mutex_t mutex, uint32_t timeout) {
+    Scheduler& scheduler = Scheduler::get();
+    sim::Mutex* m = static_cast<sim::Mutex*>(mutex);
+    const uint32_t start = scheduler.now();
+    while (m->owner != nullptr) {
+        uint32_t remaining = TIMEOUT_MAX;
+        if (timeout != TIMEOUT_MAX) {
+            const uint32_t elapsed = scheduler.now() - start;
+            if (elapsed >= timeout) return false;
+            remaining = timeout - elapsed;
+        }
+        if (!scheduler.block(m, remaining)) return false;
+    }
+    m->owner = scheduler.current();
+    return true;
+}
+
+bool mutex_give(mutex_t mutex) {
+    sim::Mutex* m = static_cast<sim::Mutex*>(mutex);
+    if (m->owner != Scheduler::get().current()) return false;
+    m->owner = nullptr;
+    Scheduler::get().wakeOne(m);
+    return true;
+}
+
+void mutex_delete(mutex_t mutex) { delete static_cast<sim::Mutex*>(mutex); }
+} // namespace c
+
+Task::Task(task_fn_t function, void* parameters, std::uint32_t prio, std::uint16_t stack_depth, const char* name) {
+    task = c::task_create(function, parameters, prio, stack_depth, name);
+}
+
+Task::Task(task_fn_t function, void* parameters, const char* name)
+    : Task(function, parameters, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, name) {}
+
+Task::Task(task_t task)
+    : task(task) {}
+
+Task Task::current() { return Task(c::task_get_current()); }
+
+Task& Task::operator=(task_t in) {
+    task = in;
+    return *this;
+}
+
+void Task::remove() { c::task_delete(task); }
+
+std::uint32_t Task::get_priority() { return c::task_get_priority(task); }
+
+void Task::set_priority(std::uint32_t prio) { c::task_set_priority(task, prio); }
+
+std::uint32_t Task::get_state() { return c::task_get_state(task); }
+
+void Task::suspend() { c::task_suspend(task); }
+
+void Task::resume() { c::task_resume(task); }
+
+const char* Task::get_name() { return c::task_get_name(task); }
+
+std::uint32_t Task::notify() { return c::task_notify(task); }
+
+void Task::join() { c::task_join(task); }
+
+std::uint32_t Task::notify_ext(std::uint32_t value, notify_action_e_t action, std::uint32_t* prev_value) {
+    return c::task_notify_ext(task, value, action, prev_value);
+}
+
+std::uint32_t Task::notify_take(bool clear_on_exit, std::uint32_t timeout) {
+    return c::task_notify_take(clear_on_exit, timeout);
+}
+
+bool Task::notify_clear() { return c::task_notify_clear(task); }
+
+void Task::delay(const std::uint32_t milliseconds) { c::task_delay(milliseconds); }
+
+void Task::delay_until(std::uint32_t* const prev_time, const std::uint32_t delta) {
+    c::task_delay_until(prev_time, delta);
+}
+
+std::uint32_t Task::get_count() { return c::task_get_count(); }
+
+Clock::time_point Clock::now() { return time_point {duration {c::millis()}}; }
+
+Mutex::Mutex()
+    : mutex(c::mutex_create(), c::mutex_delete) {}
+
+bool Mutex::take() { return c::mutex_take(mutex.get(), TIMEOUT_MAX); }
+
+bool Mutex::take(std::uint32_t timeout) { return c::mutex_take(mutex.get(), timeout); }
+
+bool Mutex::give() { return c::mutex_give(mutex.get()); }
+
+void Mutex::lock() {
+    while (!take(TIMEOUT_MAX))
+        ;
+}
+
+void Mutex::unlock() { give(); }
+
+bool Mutex::try_lock() { return take(0); }
+} // namespace pros
@@ -0,0 +1,268 @@
+#include <algorithm>
+#include <cmath>
+#include "sim/devices.hpp"
+#include "sim/robot.hpp"
+
+namespace sim {
+/** @brief time a free spinning mechanism motor takes to reach 63% of its target speed, in seconds */
+constexpr double FREE_TAU = 0.05;
+/** @brief time a coasting mechanism motor takes to lose 63% of its speed, in seconds */
+constexpr double COAST_TAU = 0.5;
+/** @brief stall torque of the 100 rpm cartridge, in Nm */
+constexpr double STALL_TORQUE_100 = 2.1;
+/** @brief stall current of a V5 motor, in mA */
+constexpr double STALL_CURRENT = 2500;
+/** @brief number of integration steps per call to step() */
+constexpr int SUBSTEPS = 4;
+/** @brief meters per inch */
+constexpr double METERS = 0.0254;
+/** @brief gravitational acceleration, in m/s^2 */
+constexpr double GRAVITY = 9.81;
+/** @brief angular speed below which scrub fades out, so the robot can come to rest, in rad/s */
+constexpr double SCRUB_VELOCITY = 0.2;
+/** @brief speed below which rolling resistance fades out, in m/s */
+constexpr double ROLLING_VELOCITY = 0.01;
+/** @brief distance from the center of the field to the inside of each wall, in inches */
+constexpr double FIELD_HALF_SIZE = 70.2;
+/** @brief how close to a wall the robot has to be to push against it, in inches */
+constexpr double CONTACT = 0.1;
+
+namespace {
+/**
+ * @brief Distance from a point to the field walls along a heading
+ *
+ * @return double in inches, negative if the ray misses every wall
+ */
+double wallDistance(double x, double y, double theta) {
+    const double dx = std::sin(theta);
+    const double dy = std::cos(theta);
+    double nearest = -1;
+    // each wall is the line x = +-FIELD_HALF_SIZE or y = +-FIELD_HALF_SIZE, between the corners
+    for (double wall : {-FIELD_HALF_SIZE, FIELD_HALF_SIZE}) {
+        if (dx != 0) {
+            const double t = (wall - x) / dx;
+            if (t > 0 && std::fabs(y + t * dy) <= FIELD_HALF_SIZE && (nearest < 0 || t < nearest)) nearest = t;
+        }
+        if (dy != 0) {
+            const double t = (wall - y) / dy;
+            if (t > 0 && std::fabs(x + t * dx) <= FIELD_HALF_SIZE && (nearest < 0 || t < nearest)) nearest = t;
+        }
+    }
+    return nearest;
+}
+
+bool coasting(const Motor& motor) {
+    return motor.mode == Motor::Mode::BRAKE && motor.brakeMode == pros::E_MOTOR_BRAKE_COAST;
+}
+
+/**
+ * @brief Apply the torque/speed curve of a V5 motor at its current velocity
+ *
+ * The motor is modelled as a DC motor: current is proportional to the voltage left over after back-emf, clamped
+ * to the current limit, and torque is proportional to current. Stall torque scales with the cartridge ratio.
+ *
+ * @param motor the motor. Its voltage, current and torque are updated
+ * @param batteryVoltage terminal voltage of the battery, in mV
+ * @return double fraction of stall torque the motor produces, signed in the direction of the user frame
+ */
+double applyCurve(Motor& motor, double batteryVoltage) {
+    if (coasting(motor)) {
+        motor.voltage = 0;
+        motor.current = 0;
+        motor.torque = 0;
+        return 0;
+    }
+    const double free = cartridgeRpm(motor.gearset);
+    // the motor switches the battery across its windings for the commanded fraction of 12 V, so it applies that
+    // fraction of whatever the battery has: a motor is faster on a full battery than on a sagging one
+    motor.voltage = motor.commandedVoltage() / 12000 * batteryVoltage;
+    const double limit = std::min<double>(motor.currentLimit, STALL_CURRENT) / STALL_CURRENT;
+    const double fraction = std::clamp(motor.voltage / 12000 - motor.velocity / free, -limit, limit);
+    motor.current = fraction * STALL_CURRENT;
+    motor.torque = fraction * STALL_TORQUE_100 * 100 / free;
+    return fraction;
+}
+
+/**
+ * @brief Current a motor draws from the battery, in A. Braking current is dissipated in the motor, not returned
+ */
+double batteryDraw(const Motor& motor, double batteryVoltage) {
+    return std::max(0.0, motor.voltage * motor.current / 1000) / batteryVoltage;
+}
+} // namespace
+
+Robot::Robot(DrivetrainConfig config)
+    : config(config),
+      encoderRemainder(config.trackingWheels.size(), 0) {
+    robotState.minBatteryVoltage = devices().battery.voltage;
+}
+
+double Robot::sideForce(const std::vector<std::uint8_t>& ports, double wheelSpeed) {
+    const double batteryVoltage = devices().battery.voltage;
+    const double radius = config.wheelDiameter / 2 * METERS;
+    double force = 0;
+    for (std::uint8_t port : ports) {
+        Motor& motor = devices().motors[port];
+        const double free = cartridgeRpm(motor.gearset);
+        // every motor on a side is geared to the same wheels
+        const double gearRatio = free / config.wheelRpm;
+        motor.velocity = wheelSpeed / radius * 60 / (2 * M_PI) * gearRatio;
+        applyCurve(motor, batteryVoltage);
+        force += motor.torque * gearRatio / radius;
+    }
+    return force;
+}
+
+void Robot::integrate(double dt) {
+    const double halfTrack = config.trackWidth / 2 * METERS;
+    const double weight = config.mass * GRAVITY;
+
+    const double leftForce = sideForce(config.leftPorts, leftSpeed);
+    const double rightForce = sideForce(config.rightPorts, rightSpeed);
+
+    // friction between the treads and the tiles develops with slip, up to the friction limit
+    const double maxFriction = config.friction * weight / 2;
+    const double leftGround = v + omega * halfTrack;
+    const double rightGround = v - omega * halfTrack;
+    const double leftFriction = maxFriction * std::tanh((leftSpeed - leftGround) / config.slipVelocity);
+    const double rightFriction = maxFriction * std::tanh((rightSpeed - rightGround) / config.slipVelocity);
+
+    const double rolling = config.rollingResistance * weight * std::tanh(v / ROLLING_VELOCITY);
+    const double scrub = config.scrubTorque * std::tanh(omega / SCRUB_VELOCITY);
+
+    leftSpeed += (leftForce - leftFriction) / config.sideMass * dt;
+    rightSpeed += (rightForce - rightFriction) / config.sideMass * dt;
+    v += (leftFriction + rightFriction - rolling) / config.mass * dt;
+    omega += ((leftFriction - rightFriction) * halfTrack - scrub) / config.inertia * dt;
+}
+
+void Robot::step(double dt) {
+    Devices& devs = devices();
+    const double batteryVoltage = devs.battery.voltage;
+    batteryCurrent = 0;
+
+    // motors that aren't part of the drivetrain spin freely
+    for (int port = 1; port <= NUM_PORTS; port++) {
+        if (std::count(config.leftPorts.begin(), config.leftPorts.end(), port) ||
+            std::count(config.rightPorts.begin(), config.rightPorts.end(), port))
+            continue;
+        Motor& motor = devs.motors[port];
+        const double free = cartridgeRpm(motor.gearset);
+        const double fraction = applyCurve(motor, batteryVoltage);
+        motor.velocity += (fraction * free / FREE_TAU - motor.velocity / COAST_TAU) * dt;
+        motor.position += motor.velocity * 6 * dt;
+        batteryCurrent += batteryDraw(motor, batteryVoltage);
+    }
+
+    const double previousV = v;
+    const double previousTheta = robotState.theta * M_PI / 180;
+    double left = 0, right = 0, forward = 0, turn = 0;
+    for (int i = 0; i < SUBSTEPS; i++) {
+        integrate(dt / SUBSTEPS);
+        left += leftSpeed * dt / SUBSTEPS;
+        right += rightSpeed * dt / SUBSTEPS;
+        forward += v * dt / SUBSTEPS;
+        turn += omega * dt / SUBSTEPS;
+    }
+
+    // motor encoders follow the wheels, including any slip
+    const double radius = config.wheelDiameter / 2 * METERS;
+    for (auto [ports, travel] : {std::pair {&config.leftPorts, left}, std::pair {&config.rightPorts, right}}) {
+        for (std::uint8_t port : *ports) {
+            Motor& motor = devs.motors[port];
+            motor.position += travel / radius * 180 / M_PI * cartridgeRpm(motor.gearset) / config.wheelRpm;
+            batteryCurrent += batteryDraw(motor, batteryVoltage);
+        }
+    }
+
+    // integrate the pose along an arc at the midpoint heading
+    const double midTheta = previousTheta + turn / 2;
+    robotState.x += forward * std::sin(midTheta) / METERS;
+    robotState.y += forward * std::cos(midTheta) / METERS;
+    robotState.theta += turn * 180 / M_PI;
+
+    // the walls stop the robot if it drives into them, but not if it drives away or turns against them. A robot
+    // pushing into a wall stays against it as it turns, rather than opening a gap to lurch into
+    const double heading = robotState.theta * M_PI / 180;
+    const double extent = config.halfSize * (std::fabs(std::sin(heading)) + std::fabs(std::cos(heading)));
+    const double limit = FIELD_HALF_SIZE - extent;
+    bool blocked = false;
+    if (std::fabs(robotState.x) > limit - CONTACT) {
+        const bool pushing = v * std::sin(heading) * robotState.x > 0;
+        if (pushing || std::fabs(robotState.x) > limit) robotState.x = std::copysign(limit, robotState.x);
+        blocked |= pushing;
+    }
+    if (std::fabs(robotState.y) > limit - CONTACT) {
+        const bool pushing = v * std::cos(heading) * robotState.y > 0;
+        if (pushing || std::fabs(robotState.y) > limit) robotState.y = std::copysign(limit, robotState.y);
+        blocked |= pushing;
+    }
+    if (blocked) v = 0;
+
+    robotState.velocity = v / METERS;
+    robotState.angularVelocity = omega * 180 / M_PI;
+    robotState.distance += std::fabs(forward) / METERS;
+    robotState.leftWheel = leftSpeed / METERS;
+    robotState.rightWheel = rightSpeed / METERS;
+
+    // every inertial sensor is mounted on the robot, so they all see the robot's motion
+    for (Imu& imu : devs.imus) {
+        imu.rotation += turn * 180 / M_PI;
+        imu.gyroZ = robotState.angularVelocity;
+        imu.accelY = (v - previousV) / dt / GRAVITY;
+        imu.accelX = v * omega / GRAVITY;
+        imu.accelXSum += imu.accelX;
+        imu.accelYSum += imu.accelY;
+        imu.accelCount++;
+    }
+
+    for (Gps& gps : devs.gps) {
+        gps.x = robotState.x * METERS;
+        gps.y = robotState.y * METERS;
+        gps.heading = robotState.theta;
+    }
+
+    const double theta = robotState.theta * M_PI / 180;
+    for (const DistanceSensorConfig& sensor : config.distanceSensors) {
+        const double x = robotState.x + sensor.x * std::cos(theta) + sensor.y * std::sin(theta);
+        const double y = robotState.y - sensor.x * std::sin(theta) + sensor.y * std::cos(theta);
+        const double distance = wallDistance(x, y, theta + sensor.angle * M_PI / 180);
+        devs.distances[sensor.port].distance = distance < 0 ? -1 : distance * 25.4;
+    }
+
+    // tracking wheels roll with the tiles, so they measure the true motion of the robot
+    for (size_t i = 0; i < config.trackingWheels.size(); i++) {
+        const TrackingWheelConfig& wheel = config.trackingWheels[i];
+        // a tracking wheel never slips sideways, and the drivetrain doesn't either
+        const double travel = (wheel.horizontal ? 0 : forward) - turn * wheel.offset * METERS;
+        const double rotations = travel / METERS / (M_PI * wheel.diameter) / wheel.ratio;
+        if (wheel.adiPort == 0) {
+            Rotation& rotation = devs.rotations[wheel.port];
+            rotation.position += rotations * 36000;
+            rotation.velocity = rotations * 36000 / dt;
+        } else {
+            // quadrature encoders report whole ticks, 360 per revolution
+            encoderRemainder[i] += rotations * 360;
+            const double ticks = std::trunc(encoderRemainder[i]);
+            encoderRemainder[i] -= ticks;
+            devs.adi[wheel.port].value[wheel.adiPort - 1] += int32_t(ticks);
+        }
+    }
+
+    // the battery sags under load, from 12.8 V full to about 12 V empty
+    Battery& battery = devs.battery;
+    battery.capacity = std::max(0.0, battery.capacity - batteryCurrent * dt / 3600 / config.batteryCapacity * 100);
+    const double openCircuit = 12000 + 800 * battery.capacity / 100;
+    battery.current = batteryCurrent * 1000;
+    battery.voltage = openCircuit - batteryCurrent * config.batteryResistance * 1000;
+    robotState.minBatteryVoltage = std::min(robotState.minBatteryVoltage, battery.voltage);
+}
+
+void Robot::setPose(double x, double y, double theta) {
+    robotState.x = x;
+    robotState.y = y;
+    robotState.theta = theta;
+}
+
+const RobotState& Robot::state() const { return robotState; }
+} // namespace sim
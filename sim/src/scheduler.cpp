@@ -0,0 +1,255 @@
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include "sim/scheduler.hpp"
+
+namespace sim {
+uint64_t threadCpuNs() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+Scheduler& Scheduler::get() {
+    // intentionally leaked, tasks may still be parked on it when the process exits
+    static Scheduler* scheduler = new Scheduler();
+    return *scheduler;
+}
+
+Scheduler::Scheduler() {
+    // adopt the calling thread as the main task
+    Task* main = new Task();
+    main->id = nextId++;
+    main->name = "main";
+    main->readySeq = readyCounter++;
+    allTasks.push_back(main);
+    running = main;
+    startSlice(main);
+}
+
+// only the running task reads these, and it was handed the processor under the scheduler mutex
+uint32_t Scheduler::now() const { return time; }
+
+Task* Scheduler::current() const { return running; }
+
+const std::deque<Task*>& Scheduler::tasks() const { return allTasks; }
+
+Task* Scheduler::create(pros::task_fn_t function, void* parameters, uint32_t priority, const char* name) {
+    std::unique_lock<std::mutex> lock(mutex);
+    Task* task = new Task();
+    task->id = nextId++;
+    task->name = (name != nullptr && name[0] != '\0') ? name : "task " + std::to_string(task->id);
+    task->priority = priority;
+    task->createdAt = time;
+    allTasks.push_back(task);
+    makeReady(task);
+    task->thread = std::thread([this, task, function, parameters]() {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            waitForTurn(task, lock);
+        }
+        function(parameters);
+        // the task function returned, so the task deletes itself and the thread exits
+        std::unique_lock<std::mutex> lock(mutex);
+        markDeleted(task);
+        switchFrom(task, lock);
+    });
+    task->thread.detach();
+    // a higher priority task preempts its creator
+    if (priority > running->priority) {
+        makeReady(running);
+        switchFrom(running, lock);
+    }
+    return task;
+}
+
+void Scheduler::remove(Task* task) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (task->state == Task::State::DELETED) return;
+    markDeleted(task);
+    if (task == running) {
+        switchFrom(task, lock);
+        // a removed task never runs again
+        task->cv.wait(lock, [] { return false; });
+    }
+}
+
+void Scheduler::sleepUntil(uint32_t wakeTime) {
+    std::unique_lock<std::mutex> lock(mutex);
+    Task* task = running;
+    if (wakeTime <= time) return;
+    task->state = Task::State::BLOCKED;
+    task->waitingOn = nullptr;
+    task->wakeTime = wakeTime;
+    switchFrom(task, lock);
+}
+
+void Scheduler::yield() {
+    std::unique_lock<std::mutex> lock(mutex);
+    makeReady(running);
+    switchFrom(running, lock);
+}
+
+bool Scheduler::block(const void* object, uint32_t timeout) {
+    if (timeout == 0) return false;
+    std::unique_lock<std::mutex> lock(mutex);
+    Task* task = running;
+    task->state = Task::State::BLOCKED;
+    task->waitingOn = object;
+    task->readySeq = readyCounter++;
+    task->wakeTime = (timeout == TIMEOUT_MAX || uint64_t(time) + timeout >= UINT32_MAX) ? UINT32_MAX : time + timeout;
+    switchFrom(task, lock);
+    // waitingOn is cleared when the task is woken by an event, and left set when it times out
+    const bool woken = task->waitingOn == nullptr;
+    task->waitingOn = nullptr;
+    return woken;
+}
+
+Task* Scheduler::wakeOne(const void* object) {
+    std::unique_lock<std::mutex> lock(mutex);
+    Task* best = nullptr;
+    for (Task* task : allTasks) {
+        if (task->state != Task::State::BLOCKED || task->waitingOn != object) continue;
+        if (best == nullptr || task->priority > best->priority ||
+            (task->priority == best->priority && task->readySeq < best->readySeq))
+            best = task;
+    }
+    if (best == nullptr) return nullptr;
+    best->waitingOn = nullptr;
+    makeReady(best);
+    if (best->priority > running->priority) {
+        makeReady(running);
+        switchFrom(running, lock);
+    }
+    return best;
+}
+
+void Scheduler::wake(Task* task) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (task->state != Task::State::BLOCKED) return;
+    task->waitingOn = nullptr;
+    makeReady(task);
+    if (task->priority > running->priority) {
+        makeReady(running);
+        switchFrom(running, lock);
+    }
+}
+
+void Scheduler::suspend(Task* task) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (task->state == Task::State::DELETED) return;
+    task->state = Task::State::SUSPENDED;
+    if (task == running) switchFrom(task, lock);
+}
+
+void Scheduler::resume(Task* task) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (task->state != Task::State::SUSPENDED) return;
+    makeReady(task);
+    if (task->priority > running->priority) {
+        makeReady(running);
+        switchFrom(running, lock);
+    }
+}
+
+void Scheduler::addTickHook(std::function<void(uint32_t)> hook) {
+    std::lock_guard<std::mutex> lock(mutex);
+    tickHooks.push_back(hook);
+}
+
+void Scheduler::addExitHook(std::function<void(Task*)> hook) {
+    std::lock_guard<std::mutex> lock(mutex);
+    exitHooks.push_back(hook);
+}
+
+void Scheduler::setDeadlockHandler(std::function<void()> handler) {
+    std::lock_guard<std::mutex> lock(mutex);
+    deadlockHandler = handler;
+}
+
+void Scheduler::setDelayJitter(uint32_t maxJitter, uint64_t seed) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->maxJitter = maxJitter;
+    jitterRng.seed(seed);
+}
+
+uint32_t Scheduler::delayJitter() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (maxJitter == 0) return 0;
+    return std::uniform_int_distribution<uint32_t>(0, maxJitter)(jitterRng);
+}
+
+void Scheduler::switchFrom(Task* self, std::unique_lock<std::mutex>& lock) {
+    endSlice(self);
+    Task* next = pickNext();
+    if (next == self) {
+        startSlice(self);
+        return;
+    }
+    running = next;
+    next->cv.notify_one();
+    if (self->state != Task::State::DELETED) waitForTurn(self, lock);
+}
+
+Task* Scheduler::pickNext() {
+    while (true) {
+        // pick the highest priority ready task, round-robin between equal priorities
+        Task* best = nullptr;
+        for (Task* task : allTasks) {
+            if (task->state != Task::State::READY) continue;
+            if (best == nullptr || task->priority > best->priority ||
+                (task->priority == best->priority && task->readySeq < best->readySeq))
+                best = task;
+        }
+        if (best != nullptr) return best;
+
+        // nothing is ready, so advance virtual time to the next timeout
+        uint32_t nextWake = UINT32_MAX;
+        for (Task* task : allTasks) {
+            if (task->state == Task::State::BLOCKED && task->wakeTime < nextWake) nextWake = task->wakeTime;
+        }
+        if (nextWake == UINT32_MAX) {
+            if (deadlockHandler) deadlockHandler();
+            std::fprintf(stderr, "sim: every task is blocked forever at t=%u ms\n", time);
+            std::exit(1);
+        }
+        while (time < nextWake) {
+            time++;
+            for (auto& hook : tickHooks) hook(time);
+        }
+        for (Task* task : allTasks) {
+            if (task->state == Task::State::BLOCKED && task->wakeTime <= time) makeReady(task);
+        }
+    }
+}
+
+void Scheduler::makeReady(Task* task) {
+    task->state = Task::State::READY;
+    task->wakeTime = UINT32_MAX;
+    task->readySeq = readyCounter++;
+}
+
+void Scheduler::markDeleted(Task* task) {
+    task->state = Task::State::DELETED;
+    // wake any tasks joining the deleted task
+    for (Task* other : allTasks) {
+        if (other->state == Task::State::BLOCKED && other->waitingOn == task) {
+            other->waitingOn = nullptr;
+            makeReady(other);
+        }
+    }
+    for (auto& hook : exitHooks) hook(task);
+}
+
+void Scheduler::waitForTurn(Task* self, std::unique_lock<std::mutex>& lock) {
+    self->cv.wait(lock, [this, self] { return running == self; });
+    startSlice(self);
+}
+
+void Scheduler::startSlice(Task* task) { task->sliceStart = threadCpuNs(); }
+
+void Scheduler::endSlice(Task* task) {
+    task->cpuNs += threadCpuNs() - task->sliceStart;
+    task->slices++;
+}
+} // namespace sim
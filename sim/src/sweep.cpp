@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "sim/sweep.hpp"
+#include "sim/threadPool.hpp"
+
+extern char** environ;
+
+namespace sim {
+void writeRunRecord(std::FILE* file, const RunRecord& record) {
+    std::fprintf(file, "run %" PRIu64 " %u %d\n", record.seed, record.routeMs, record.timedOut ? 1 : 0);
+    for (const MotionRecord& motion : record.motions) {
+        std::fprintf(file, "motion %u %u %.4f %.4f %.4f %.4f %.4f %.4f %u\n", motion.start, motion.end, motion.x,
+                     motion.y, motion.theta, motion.odomX, motion.odomY, motion.odomTheta, motion.saved);
+    }
+    std::fprintf(file, "end\n");
+}
+
+RunRecord parseRunRecord(const std::string& text) {
+    RunRecord record;
+    std::istringstream stream(text);
+    std::string line;
+    bool started = false;
+    while (std::getline(stream, line)) {
+        std::istringstream fields(line);
+        std::string kind;
+        fields >> kind;
+        if (kind == "run") {
+            int timedOut = 0;
+            fields >> record.seed >> record.routeMs >> timedOut;
+            record.timedOut = timedOut;
+            record.motions.clear();
+            started = !fields.fail();
+        } else if (kind == "motion" && started) {
+            MotionRecord motion;
+            fields >> motion.start >> motion.end >> motion.x >> motion.y >> motion.theta >> motion.odomX >>
+                motion.odomY >> motion.odomTheta >> motion.saved;
+            if (!fields.fail()) record.motions.push_back(motion);
+        } else if (kind == "end" && started) {
+            record.valid = true;
+        }
+    }
+    return record;
+}
+
+namespace {
+/**
+ * @brief Run the simulator in a child process and collect its record
+ *
+ */
+RunRecord runChild(const SweepOptions& options, uint64_t seed) {
+    RunRecord failed;
+    failed.seed = seed;
+    // close-on-exec, so children spawned by the other pool threads at the same time don't inherit this pipe and keep
+    // it open past this run's child exiting. The dup2 onto stdout clears the flag on the child's copy
+    int pipeFds[2];
+    if (pipe2(pipeFds, O_CLOEXEC) != 0) return failed;
+
+    const std::string timeLimit = std::to_string(options.timeLimit);
+    const std::string seedText = std::to_string(seed);
+    std::vector<const char*> argv = {options.program.c_str(), "--auton",  options.auton.c_str(), "--time-limit",
+                                     timeLimit.c_str(),       "--seed",   seedText.c_str(),      "--record"};
+    for (const std::string& arg : options.extraArgs) argv.push_back(arg.c_str());
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, pipeFds[0]);
+    posix_spawn_file_actions_addclose(&actions, pipeFds[1]);
+    pid_t pid;
+    const int error = posix_spawn(&pid, options.program.c_str(), &actions, nullptr,
+                                  const_cast<char* const*>(argv.data()), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(pipeFds[1]);
+    if (error != 0) {
+        close(pipeFds[0]);
+        return failed;
+    }
+
+    std::string output;
+    char buffer[4096];
+    ssize_t count;
+    while ((count = read(pipeFds[0], buffer, sizeof(buffer))) > 0) output.append(buffer, count);
+    close(pipeFds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+
+    RunRecord record = parseRunRecord(output);
+    if (!record.valid) return failed;
+    return record;
+}
+
+/**
+ * @brief Nearest-rank percentile of a sorted list
+ *
+ */
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return NAN;
+    const size_t rank = size_t(std::ceil(p / 100 * sorted.size()));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+std::vector<double> sorted(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values;
+}
+} // namespace
+
+int runSweep(const SweepOptions& options) {
+    const auto wallStart = std::chrono::steady_clock::now();
+
+    // the nominal run is the reference every randomized run is compared against
+    const RunRecord nominal = runChild(options, 0);
+    if (!nominal.valid) {
+        std::fprintf(stderr, "sweep: the nominal run of %s failed\n", options.auton.c_str());
+        return 1;
+    }
+
+    std::vector<RunRecord> runs(options.runs);
+    ThreadPool pool(options.jobs);
+    for (int i = 0; i < options.runs; i++) {
+        pool.submit([&options, &runs, i] { runs[i] = runChild(options, i + 1); });
+    }
+    pool.wait();
+    const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    int failed = 0;
+    int timedOut = 0;
+    std::vector<double> routeTimes;
+    for (const RunRecord& run : runs) {
+        if (!run.valid) {
+            failed++;
+            continue;
+        }
+        if (run.timedOut) timedOut++;
+        routeTimes.push_back(run.routeMs / 1000.0);
+    }
+    routeTimes = sorted(routeTimes);
+
+    std::printf("sweep:       %s, %d runs on %zu threads, %.1f s wall\n", options.auton.c_str(), options.runs,
+                pool.size(), wallSeconds);
+    std::printf("nominal:     %.3f s, %zu motions\n", nominal.routeMs / 1000.0, nominal.motions.size());
+    std::printf("route time:  p5 %.3f  p50 %.3f  p95 %.3f  max %.3f s\n", percentile(routeTimes, 5),
+                percentile(routeTimes, 50), percentile(routeTimes, 95), percentile(routeTimes, 100));
+    std::printf("timed out:   %d, failed to run: %d\n\n", timedOut, failed);
+
+    // motions are matched by their order in the routine
+    std::printf("%-6s %-5s %-22s %-26s %-18s %-16s\n", "motion", "runs", "time p50/p95/max (s)",
+                "pose error p50/p95/p99 (in)", "heading p95 (deg)", "odom p50/p95 (in)");
+    for (size_t m = 0; m < nominal.motions.size(); m++) {
+        const MotionRecord& reference = nominal.motions[m];
+        std::vector<double> times, errors, headings, odomErrors;
+        for (const RunRecord& run : runs) {
+            if (!run.valid || m >= run.motions.size()) continue;
+            const MotionRecord& motion = run.motions[m];
+            times.push_back((motion.end - motion.start) / 1000.0);
+            errors.push_back(std::hypot(motion.x - reference.x, motion.y - reference.y));
+            headings.push_back(std::fabs(std::remainder(motion.theta - reference.theta, 360)));
+            odomErrors.push_back(std::hypot(motion.x - motion.odomX, motion.y - motion.odomY));
+        }
+        times = sorted(times);
+        errors = sorted(errors);
+        headings = sorted(headings);
+        odomErrors = sorted(odomErrors);
+        std::printf("%-6zu %-5zu %6.3f %6.3f %6.3f      %6.2f %6.2f %6.2f         %6.2f             %6.2f %6.2f\n",
+                    m + 1, times.size(), percentile(times, 50), percentile(times, 95), percentile(times, 100),
+                    percentile(errors, 50), percentile(errors, 95), percentile(errors, 99), percentile(headings, 95),
+                    percentile(odomErrors, 50), percentile(odomErrors, 95));
+    }
+    return failed == 0 ? 0 : 1;
+}
+} // namespace sim
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <chrono>
+#include "sim/threadPool.hpp"
+
+namespace sim {
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < threads; i++) workers.push_back(std::make_unique<Worker>());
+    for (unsigned i = 0; i < threads; i++) this->threads.emplace_back([this, i] { run(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (std::thread& thread : threads) thread.join();
+}
+
+void ThreadPool::submit(std::function<void()> job) {
+    Worker& worker = *workers[nextWorker++ % workers.size()];
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        pending++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.jobs.push_back(std::move(job));
+    }
+    workAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    allDone.wait(lock, [this] { return pending == 0; });
+}
+
+size_t ThreadPool::size() const { return workers.size(); }
+
+bool ThreadPool::take(size_t self, std::function<void()>& job) {
+    {
+        Worker& own = *workers[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.front());
+            own.jobs.pop_front();
+            return true;
+        }
+    }
+    // steal from the opposite end, where the owner isn't working
+    for (size_t i = 1; i < workers.size(); i++) {
+        Worker& victim = *workers[(self + i) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.back());
+            victim.jobs.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run(size_t self) {
+    while (true) {
+        std::function<void()> job;
+        if (take(self, job)) {
+            job();
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (--pending == 0) allDone.notify_all();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(stateMutex);
+        if (stopping) return;
+        // a job can be queued between the failed take and this wait, so don't sleep on the notification alone
+        workAvailable.wait_for(lock, std::chrono::milliseconds(10));
+    }
+}
+} // namespace sim
@@ -0,0 +1,46 @@
+/**
+ * @file sim/tools/sysidFit.cpp
+ * @brief Fits feedforward constants to a log saved by Chassis::characterize
+ *
+ * Prints kS, kV and kA for driving straight and for turning, in volts and in the motor power ControllerSettings takes,
+ * along with how well the model fits. A fit that explains less than about 95% of the variation usually means the
+ * robot hit something, or a wheel slipped, during the tests.
+ *
+ * Usage: sysid-fit log
+ */
+
+#include <cstdio>
+#include "lemlib/sysId.hpp"
+
+namespace {
+/** @brief motor power per volt */
+constexpr float POWER_PER_VOLT = 127.0f / 12;
+
+void print(const char* name, const char* velocityUnit, const lemlib::SysIdModel& model) {
+    if (model.samples == 0) {
+        std::printf("%s: not enough samples to fit\n", name);
+        return;
+    }
+    std::printf("%s, fit to %d samples, r^2 %.4f\n", name, model.samples, model.rSquared);
+    std::printf("  volts:       kS %.4f  kV %.5f per %s  kA %.5f per %s/s\n", model.kS, model.kV, velocityUnit,
+                model.kA, velocityUnit);
+    std::printf("  motor power: kS %.3f  kV %.4f  kA %.4f\n", model.kS * POWER_PER_VOLT, model.kV * POWER_PER_VOLT,
+                model.kA * POWER_PER_VOLT);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: %s log\n", argv[0]);
+        return 2;
+    }
+    lemlib::SysIdLog log;
+    if (!log.load(argv[1])) {
+        std::fprintf(stderr, "%s: can't read a characterization log from %s\n", argv[0], argv[1]);
+        return 1;
+    }
+    std::printf("%zu samples, track width %.2f in\n\n", log.getSamples().size(), log.getTrackWidth());
+    print("lateral", "in/s", lemlib::fitLinear(log));
+    print("angular", "deg/s", lemlib::fitAngular(log));
+    return 0;
+}
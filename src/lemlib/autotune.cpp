@@ -0,0 +1,136 @@
+/**
+ * @file src/lemlib/autotune.cpp
+ * @author LemLib Team
+ * @brief Relay feedback experiments, and PID gains from their results
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <algorithm>
+#include <math.h>
+#include "lemlib/autotune.hpp"
+
+/**
+ * @brief Find PID gains from the ultimate gain and period of a loop
+ *
+ * @param ultimateGain gain at which the loop oscillates
+ * @param ultimatePeriod period of the oscillation, in seconds
+ * @param rule the tuning rule
+ * @param dt time between updates of the PID, in seconds
+ * @return PIDGains
+ */
+lemlib::PIDGains lemlib::tunePID(float ultimateGain, float ultimatePeriod, TuningRule rule, float dt) {
+    // each rule gives a proportional gain and the integral and derivative times
+    float kP;
+    float integralTime;
+    float derivativeTime;
+    switch (rule) {
+        case TuningRule::ZIEGLER_NICHOLS:
+            kP = 0.6 * ultimateGain;
+            integralTime = ultimatePeriod / 2;
+            derivativeTime = ultimatePeriod / 8;
+            break;
+        case TuningRule::TYREUS_LUYBEN:
+            kP = ultimateGain / 2.2;
+            integralTime = 2.2 * ultimatePeriod;
+            derivativeTime = ultimatePeriod / 6.3;
+            break;
+        case TuningRule::ASTROM_HAGGLUND:
+        default: {
+            // the phase margin comes from the derivative leading by that much more than the integral lags, with the
+            // integral time 4 times the derivative time
+            const float margin = M_PI / 4;
+            const float frequency = 2 * M_PI / ultimatePeriod;
+            kP = ultimateGain * cosf(margin);
+            derivativeTime = (tanf(margin) + sqrtf(1 + tanf(margin) * tanf(margin))) / (2 * frequency);
+            integralTime = 4 * derivativeTime;
+            break;
+        }
+    }
+    // the PID class sums and differences the error once per update, rather than integrating over time
+    PIDGains gains;
+    gains.kP = kP;
+    gains.kI = integralTime > 0 ? kP * dt / integralTime : 0;
+    gains.kD = kP * derivativeTime / dt;
+    return gains;
+}
+
+/**
+ * @brief Start an experiment
+ *
+ * @param amplitude output of the relay
+ * @param hysteresis how far the error has to cross zero before the relay switches
+ */
+lemlib::RelayExperiment::RelayExperiment(float amplitude, float hysteresis)
+    : amplitude(fabsf(amplitude)),
+      hysteresis(fabsf(hysteresis)),
+      output(0) {}
+
+/**
+ * @brief Feed the experiment the latest error, and get the output of the relay
+ *
+ * @param error setpoint minus measurement
+ * @param time time of the measurement, in seconds
+ * @return float the output
+ */
+float lemlib::RelayExperiment::update(float error, float time) {
+    // the relay starts pushing towards the setpoint
+    if (output == 0) {
+        output = error < 0 ? -amplitude : amplitude;
+        cycleMax = cycleMin = error;
+        return output;
+    }
+    cycleMax = std::max(cycleMax, error);
+    cycleMin = std::min(cycleMin, error);
+
+    if (output > 0 && error < -hysteresis) {
+        output = -amplitude;
+    } else if (output < 0 && error > hysteresis) {
+        // switching positive ends an oscillation. The first one is left out, since it starts from rest
+        output = amplitude;
+        rises++;
+        if (rises >= 3) {
+            periodSum += time - cycleStart;
+            amplitudeSum += (cycleMax - cycleMin) / 2;
+        }
+        cycleStart = time;
+        cycleMax = cycleMin = error;
+    }
+    return output;
+}
+
+/**
+ * @brief Get the number of complete oscillations, not counting the first one
+ *
+ * @return int
+ */
+int lemlib::RelayExperiment::getCycles() const { return std::max(rises - 2, 0); }
+
+/**
+ * @brief Get the ultimate gain, from the average amplitude of the oscillations
+ *
+ * The describing function of a relay with hysteresis, 4 * d / (pi * sqrt(a^2 - e^2)), is its gain for an oscillation
+ * of amplitude a
+ *
+ * @return float 0 before there are any
+ */
+float lemlib::RelayExperiment::getUltimateGain() const {
+    const int cycles = getCycles();
+    if (cycles == 0) return 0;
+    const float oscillation = amplitudeSum / cycles;
+    if (oscillation <= hysteresis) return 0;
+    return 4 * amplitude / (M_PI * sqrtf(oscillation * oscillation - hysteresis * hysteresis));
+}
+
+/**
+ * @brief Get the ultimate period, the average period of the oscillations
+ *
+ * @return float in seconds. 0 before there are any
+ */
+float lemlib::RelayExperiment::getUltimatePeriod() const {
+    const int cycles = getCycles();
+    return cycles == 0 ? 0 : periodSum / cycles;
+}
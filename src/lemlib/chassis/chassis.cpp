@@ -0,0 +1,894 @@
+/**
+ * @file src/lemlib/chassis/chassis.cpp
+ * @author LemLib Team
+ * @brief definitions for the chassis class
+ * @version 0.4.5
+ * @date 2023-01-27
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "pros/imu.hpp"
+#include "pros/misc.hpp"
+#include "pros/rtos.hpp"
+#include "lemlib/util.hpp"
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/chassis/trackingWheel.hpp"
+#include "lemlib/logger/logger.hpp"
+
+/**
+ * @brief The constants are stored in a struct so that they can be easily passed to the chassis class
+ * The variables are pointers so that they can be set to nullptr if they are not used
+ * Otherwise the chassis class would have to have a constructor for each possible combination of sensors
+ *
+ * @param vertical1 pointer to the first vertical tracking wheel
+ * @param vertical2 pointer to the second vertical tracking wheel
+ * @param horizontal1 pointer to the first horizontal tracking wheel
+ * @param horizontal2 pointer to the second horizontal tracking wheel
+ * @param imu pointer to the IMU
+ * @param imuForward axis of the IMU that points to the front of the robot. Y by default
+ */
+lemlib::OdomSensors::OdomSensors(TrackingWheel* vertical1, TrackingWheel* vertical2, TrackingWheel* horizontal1,
+                                 TrackingWheel* horizontal2, pros::Imu* imu, ImuAxis imuForward)
+    : vertical1(vertical1),
+      vertical2(vertical2),
+      horizontal1(horizontal1),
+      horizontal2(horizontal2),
+      imu(imu),
+      imuForward(imuForward) {}
+
+/**
+ * @brief The constants are stored in a struct so that they can be easily passed to the chassis class
+ * Set a constant to 0 and it will be ignored
+ *
+ * @param leftMotors pointer to the left motors
+ * @param rightMotors pointer to the right motors
+ * @param trackWidth the track width of the robot
+ * @param wheelDiameter the diameter of the wheel used on the drivetrain
+ * @param rpm the rpm of the wheels
+ * @param chasePower higher values make the robot move faster but causes more overshoot on turns
+ */
+lemlib::Drivetrain::Drivetrain(pros::MotorGroup* leftMotors, pros::MotorGroup* rightMotors, float trackWidth,
+                               float wheelDiameter, float rpm, float chasePower)
+    : leftMotors(leftMotors),
+      rightMotors(rightMotors),
+      trackWidth(trackWidth),
+      wheelDiameter(wheelDiameter),
+      rpm(rpm),
+      chasePower(chasePower) {}
+
+/**
+ * @brief  Default drive curve. Modifies  the input with an exponential curve. If the input is 127, the function
+ * will always output 127, no matter the value of scale, likewise for -127. This curve was inspired by team
+ * 5225, the Pilons. A Desmos graph of this curve can be found here:
+ * https://www.desmos.com/calculator/rcfjjg83zx
+ * @param input value from -127 to 127
+ * @param scale how steep the curve should be.
+ * @return The new value to be used.
+ */
+float lemlib::defaultDriveCurve(float input, float scale) {
+    if (scale != 0) {
+        return (powf(2.718, -(scale / 10)) + powf(2.718, (fabs(input) - 127) / 10) * (1 - powf(2.718, -(scale / 10)))) *
+               input;
+    }
+    return input;
+}
+
+/**
+ * @brief Construct a new Chassis
+ *
+ * @param drivetrain drivetrain to be used for the chassis
+ * @param lateralSettings settings for the lateral controller
+ * @param angularSettings settings for the angular controller
+ * @param sensors sensors to be used for odometry
+ * @param driveCurve drive curve to be used. defaults to `defaultDriveCurve`
+ */
+lemlib::Chassis::Chassis(Drivetrain drivetrain, ControllerSettings linearSettings, ControllerSettings angularSettings,
+                         OdomSensors sensors, DriveCurveFunction_t driveCurve)
+    : lateralSettings(linearSettings),
+      angularSettings(angularSettings),
+      drivetrain(drivetrain),
+      sensors(sensors),
+      driveCurve(driveCurve),
+      defaultCurve(driveCurve.target<float (*)(float, float)>() != nullptr &&
+                   *driveCurve.target<float (*)(float, float)>() == &defaultDriveCurve),
+      leftPorts(drivetrain.leftMotors->get_ports()),
+      rightPorts(drivetrain.rightMotors->get_ports()),
+      lateralPID(linearSettings.kP, linearSettings.kI, linearSettings.kD, linearSettings.windupRange, true),
+      angularPID(angularSettings.kP, angularSettings.kI, angularSettings.kD, angularSettings.windupRange, true),
+      lateralLargeExit(lateralSettings.largeError, lateralSettings.largeErrorTimeout),
+      lateralSmallExit(lateralSettings.smallError, lateralSettings.smallErrorTimeout),
+      angularLargeExit(angularSettings.largeError, angularSettings.largeErrorTimeout),
+      angularSmallExit(angularSettings.smallError, angularSettings.smallErrorTimeout) {}
+
+/**
+ * @brief Calibrate the chassis sensors
+ *
+ * @param calibrateIMU whether the IMU should be calibrated. true by default
+ */
+void lemlib::Chassis::calibrate(bool calibrateImu) {
+    // calibrate the IMU if it exists and the user doesn't specify otherwise
+    if (sensors.imu != nullptr && calibrateImu) {
+        int attempt = 1;
+        // calibrate inertial, and if calibration fails, then repeat 5 times or until successful
+        while (attempt <= 5) {
+            sensors.imu->reset();
+            // wait until IMU is calibrated
+            do pros::delay(10);
+            while (sensors.imu->get_status() != 0xFF && sensors.imu->is_calibrating());
+            // exit if imu has been calibrated
+            if (!std::isnan(sensors.imu->get_heading()) && !std::isinf(sensors.imu->get_heading())) break;
+            // indicate error
+            pros::c::controller_rumble(pros::E_CONTROLLER_MASTER, "---");
+            infoSink()->warn("IMU failed to calibrate! Attempt #{}", attempt);
+            attempt++;
+        }
+        // check if calibration attempts were successful
+        if (attempt > 5) {
+            sensors.imu = nullptr;
+            infoSink()->error("IMU calibration failed, defaulting to tracking wheels / motor encoders");
+        }
+    }
+    // initialize odom
+    if (sensors.vertical1 == nullptr)
+        sensors.vertical1 = new lemlib::TrackingWheel(drivetrain.leftMotors, drivetrain.wheelDiameter,
+                                                      -(drivetrain.trackWidth / 2), drivetrain.rpm);
+    if (sensors.vertical2 == nullptr)
+        sensors.vertical2 = new lemlib::TrackingWheel(drivetrain.rightMotors, drivetrain.wheelDiameter,
+                                                      drivetrain.trackWidth / 2, drivetrain.rpm);
+    sensors.vertical1->reset();
+    sensors.vertical2->reset();
+    if (sensors.horizontal1 != nullptr) sensors.horizontal1->reset();
+    if (sensors.horizontal2 != nullptr) sensors.horizontal2->reset();
+    setSensors(sensors, drivetrain);
+    init([this] { publishState(); });
+    // start the task that runs the motions
+    this->mutex.take(TIMEOUT_MAX);
+    startMotionTask();
+    this->mutex.give();
+    // rumble to controller to indicate success
+    pros::c::controller_rumble(pros::E_CONTROLLER_MASTER, ".");
+}
+
+/**
+ * @brief Set the pose of the chassis
+ *
+ * @param x new x value
+ * @param y new y value
+ * @param theta new theta value
+ * @param radians true if theta is in radians, false if not. False by default
+ */
+void lemlib::Chassis::setPose(float x, float y, float theta, bool radians) {
+    setPose(lemlib::Pose(x, y, theta), radians);
+}
+
+/**
+ * @brief Set the pose of the chassis
+ *
+ * @param Pose the new pose
+ * @param radians whether pose theta is in radians (true) or not (false). false by default
+ */
+void lemlib::Chassis::setPose(Pose pose, bool radians) {
+    lemlib::setPose(pose, radians);
+    // so the next getPose() doesn't return where the robot was before
+    publishState();
+}
+
+/**
+ * @brief Get the pose of the chassis
+ *
+ * @param radians whether theta should be in radians (true) or degrees (false). false by default
+ * @param standardPos whether theta should be in standard form (0 is right, increases counter-clockwise)
+ * @return Pose
+ */
+lemlib::Pose lemlib::Chassis::getPose(bool radians, bool standardPos) {
+    Pose pose = state.read().pose;
+    if (standardPos) pose.theta = M_PI_2 - pose.theta;
+    if (!radians) pose.theta = radToDeg(pose.theta);
+    return pose;
+}
+
+/**
+ * @brief Get the pose, speed and motion status of the chassis, all from the same odometry update
+ *
+ * @return ChassisState
+ */
+lemlib::ChassisState lemlib::Chassis::getState() const { return state.read(); }
+
+/**
+ * @brief Capture the current state for readers of getState()
+ *
+ */
+void lemlib::Chassis::publishState() {
+    ChassisState current;
+    current.time = pros::millis();
+    current.pose = lemlib::getPose(true);
+    current.speed = lemlib::getSpeed(true);
+    current.localSpeed = lemlib::getLocalSpeed(true);
+    current.groundSpeed = lemlib::getGroundSpeed();
+    current.inMotion = isInMotion();
+    current.motionId = runningId;
+    current.stalls = stalls;
+    current.settleSaved = settleSaved;
+    current.distTravelled = distTravelled;
+    stateMutex.take();
+    state.publish(current);
+    stateMutex.give();
+}
+
+/**
+ * @brief Limit the lateral motion of moveToPoint and moveToPose with a motion profile
+ *
+ * @param constraints limits in inches and seconds. A max velocity of 0 turns profiling off, which is the default
+ */
+void lemlib::Chassis::setLateralProfile(ProfileConstraints constraints) { lateralProfile = constraints; }
+
+/**
+ * @brief Chain moveToPose and moveToPoint into the next motion in the queue, carrying speed through the corner
+ * between them instead of stopping
+ *
+ * @param settings how to chain. An exit distance of 0 turns chaining off, which is the default
+ */
+void lemlib::Chassis::setChainSettings(ChainSettings settings) { chainSettings = settings; }
+
+/**
+ * @brief End moveToPose, moveToPoint and follow early once the robot is stuck against something, instead of pushing
+ * until the timeout
+ *
+ * @param settings how to detect a stall. A time of 0 turns stall detection off, which is the default
+ */
+void lemlib::Chassis::setStallSettings(StallSettings settings) { stallSettings = settings; }
+
+/**
+ * @brief End turns and moves as soon as the robot has stopped within the small error, instead of waiting out the
+ * exit countdowns in the controller settings
+ *
+ * @param lateral settle settings for moveToPoint and moveToPose, in inches
+ * @param angular settle settings for turnTo and moveToPose, in degrees
+ */
+void lemlib::Chassis::setSettleSettings(SettleSettings lateral, SettleSettings angular) {
+    // only inside the small error, since stopping at the peak of an overshoot can pass for settling
+    lateralSmallExit.setSettle(lateral);
+    angularSmallExit.setSettle(angular);
+}
+
+/**
+ * @brief Set how the lateral and angular PIDs handle the time between updates: derivative filtering,
+ * derivative on measurement and output limits
+ *
+ * @param lateral settings for the lateral PID. Its measurement is how far the robot has driven forwards
+ * @param angular settings for the angular PID. Its measurement is the heading
+ */
+void lemlib::Chassis::setPIDSettings(PIDSettings lateral, PIDSettings angular) {
+    lateralPID.setSettings(lateral);
+    angularPID.setSettings(angular);
+}
+
+/**
+ * @brief Look the gains and static feedforward of the lateral and angular PIDs up from gain schedules every
+ * update, instead of using the ones in the controller settings
+ *
+ * @param lateral schedule for the lateral PID, in inches. An empty schedule goes back to the settings
+ * @param angular schedule for the angular PID, in degrees. An empty schedule goes back to the settings
+ */
+void lemlib::Chassis::setGainSchedules(GainSchedule lateral, GainSchedule angular) {
+    lateralSchedule = lateral;
+    angularSchedule = angular;
+    if (lateral.empty()) lateralPID.setGains(lateralSettings.kP, lateralSettings.kI, lateralSettings.kD);
+    if (angular.empty()) angularPID.setGains(angularSettings.kP, angularSettings.kI, angularSettings.kD);
+}
+
+/**
+ * @brief Plan the speed of follow from the drivetrain instead of the velocities in the path file
+ *
+ * @param constraints limits in inches and seconds. A max acceleration of 0 turns planning off, which is the default
+ */
+void lemlib::Chassis::setPathConstraints(TrajectoryConstraints constraints) { pathConstraints = constraints; }
+
+/**
+ * @brief Set the gains follow uses for RAMSETE
+ *
+ * @param settings the gains
+ */
+void lemlib::Chassis::setRamseteSettings(RamseteSettings settings) { ramseteSettings = settings; }
+
+/**
+ * @brief Set the gains of the lateral PID, in place of the ones in its ControllerSettings and its gain schedule
+ *
+ * Don't call this while a motion is running
+ *
+ * @param gains the gains
+ */
+void lemlib::Chassis::setLateralGains(PIDGains gains) {
+    lateralSettings.kP = gains.kP;
+    lateralSettings.kI = gains.kI;
+    lateralSettings.kD = gains.kD;
+    lateralSchedule = GainSchedule();
+    lateralPID.setGains(gains.kP, gains.kI, gains.kD);
+}
+
+/**
+ * @brief Set the gains of the angular PID, in place of the ones in its ControllerSettings and its gain schedule
+ *
+ * Don't call this while a motion is running
+ *
+ * @param gains the gains
+ */
+void lemlib::Chassis::setAngularGains(PIDGains gains) {
+    angularSettings.kP = gains.kP;
+    angularSettings.kI = gains.kI;
+    angularSettings.kD = gains.kD;
+    angularSchedule = GainSchedule();
+    angularPID.setGains(gains.kP, gains.kI, gains.kD);
+}
+
+/**
+ * @brief Save the lateral and angular PID gains, so a later run can load them without a recompile
+ *
+ * The file is text, one line per controller: its name, then kP, kI and kD
+ *
+ * @param path the file. Files on the SD card start with /usd/
+ * @return true if the gains were saved
+ */
+bool lemlib::Chassis::saveGains(const char* path) const {
+    FILE* file = fopen(path, "w");
+    if (file == nullptr) return false;
+    const bool written =
+        fprintf(file, "lateral %g %g %g\n", lateralSettings.kP, lateralSettings.kI, lateralSettings.kD) > 0 &&
+        fprintf(file, "angular %g %g %g\n", angularSettings.kP, angularSettings.kI, angularSettings.kD) > 0;
+    return fclose(file) == 0 && written;
+}
+
+/**
+ * @brief Load gains saved with saveGains
+ *
+ * Call this in initialize. If there is no file, for example because there is no SD card, the gains in the
+ * ControllerSettings stay
+ *
+ * @param path the file. Files on the SD card start with /usd/
+ * @return true if both controllers were loaded
+ */
+bool lemlib::Chassis::loadGains(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) return false;
+    bool lateral = false;
+    bool angular = false;
+    char name[16];
+    PIDGains gains;
+    while (fscanf(file, "%15s %f %f %f", name, &gains.kP, &gains.kI, &gains.kD) == 4) {
+        if (std::strcmp(name, "lateral") == 0) {
+            setLateralGains(gains);
+            lateral = true;
+        } else if (std::strcmp(name, "angular") == 0) {
+            setAngularGains(gains);
+            angular = true;
+        }
+    }
+    fclose(file);
+    return lateral && angular;
+}
+
+/**
+ * @brief Drive each side of the drivetrain at a voltage, made up for the battery sagging
+ *
+ * Motions output power out of 127 of the nominal 12 V. The motors apply that share of whatever the battery has, so
+ * the voltage is scaled by 12 V over the battery voltage, and the gains work the same on a full battery as on a flat
+ * one.
+ *
+ * @param leftPower power of the left side, from -127 to 127
+ * @param rightPower power of the right side, from -127 to 127
+ */
+void lemlib::Chassis::moveVoltage(float leftPower, float rightPower) {
+    // if the battery can't be read, there is nothing to make up for
+    const int32_t battery = pros::battery::get_voltage();
+    const float scale = battery > 0 && battery != PROS_ERR ? 12000.0f / battery : 1;
+    const VoltageOutput millivolts {scale};
+    leftPorts.moveVoltage(millivolts(leftPower));
+    rightPorts.moveVoltage(millivolts(rightPower));
+    this->leftPower = leftPower;
+    this->rightPower = rightPower;
+}
+
+/**
+ * @brief Wait until the robot has traveled a certain distance along the path
+ *
+ * Waits on the last motion queued, which may not have started yet. Returns once it has finished, even if it never got
+ * that far. The motion wakes the calling task on the control cycle it gets there, rather than the calling task
+ * checking every so often
+ *
+ * @note Units are in inches if current motion is moveTo or follow, degrees if using turnTo
+ *
+ * @param dist the distance the robot needs to travel before returning
+ */
+void lemlib::Chassis::waitUntil(float dist) {
+    this->mutex.take(TIMEOUT_MAX);
+    const uint32_t id = this->lastQueuedId;
+    while (this->lastDoneId < id && (this->runningId != id || distTravelled <= dist)) sleepUntilNotified(id, dist);
+    this->mutex.give();
+}
+
+/**
+ * @brief Wait until the robot has completed the path
+ *
+ * Waits for every motion queued so far to finish or be cancelled
+ */
+void lemlib::Chassis::waitUntilDone() { waitForMotion(this->lastQueuedId); }
+
+/**
+ * @brief Run an action once the last motion queued has travelled a distance, without waiting for it
+ *
+ * The motion task runs the action on the control cycle the robot gets there, so keep it short, like setting a piston
+ * or a motor. If the motion finishes before it gets that far, the action runs when it finishes. It
+ * doesn't run if the motion is cancelled.
+ *
+ * @note Units are in inches if the motion is moveTo or follow, degrees if it is turnTo
+ *
+ * @param dist the distance
+ * @param action the action
+ * @return false if there is no motion to attach it to, or too many actions are waiting already
+ */
+bool lemlib::Chassis::atDistance(float dist, std::function<void()> action) {
+    return addAction(dist, false, std::move(action));
+}
+
+/**
+ * @brief Run an action once the last motion queued is some way through, without waiting for it
+ *
+ * Works like atDistance, with the distance a percentage of how far the motion expects to travel when it starts
+ *
+ * @param percent how far through the motion, from 0 to 100
+ * @param action the action
+ * @return false if there is no motion to attach it to, or too many actions are waiting already
+ */
+bool lemlib::Chassis::atProgress(float percent, std::function<void()> action) {
+    return addAction(percent, true, std::move(action));
+}
+
+/**
+ * @brief Attach an action to the last motion queued
+ *
+ * @param at distance at which to run it, or percentage of the motion if progress is true
+ * @param progress whether at is a percentage
+ * @param action the action
+ * @return false if there is no motion to attach it to, or too many actions are waiting already
+ */
+bool lemlib::Chassis::addAction(float at, bool progress, std::function<void()> action) {
+    this->mutex.take(TIMEOUT_MAX);
+    const uint32_t id = this->lastQueuedId;
+    // actions left on motions that were dropped from the queue never ran, so their slots are free too
+    auto slot = std::find_if(this->motionActions.begin(), this->motionActions.end(), [this](const MotionAction& a) {
+        return !a.action || (a.id <= this->lastDoneId && a.id != this->runningId);
+    });
+    const bool added = id > this->lastDoneId && slot != this->motionActions.end();
+    if (added) *slot = {id, at, progress, std::move(action)};
+    this->mutex.give();
+    if (!added) infoSink()->warn("Action not added, {}", id > this->lastDoneId ? "too many" : "no motion queued");
+    return added;
+}
+
+/**
+ * @brief Add a motion to the back of the queue, for the motion task to run
+ *
+ * @param command the motion
+ * @param async false to wait for the motion to finish
+ */
+void lemlib::Chassis::queueMotion(MotionCommand command, bool async) {
+    this->mutex.take(TIMEOUT_MAX);
+    // calibrate starts the task, but a motion queued without calibrating first would otherwise never run
+    startMotionTask();
+    // the queue only fills up if a script queues motions far ahead of the robot. Wait for room rather than drop one
+    while (this->queueSize == MOTION_QUEUE_SIZE) sleepUntilNotified();
+    command.id = ++this->lastQueuedId;
+    this->motionQueue[(this->queueHead + this->queueSize) % MOTION_QUEUE_SIZE] = command;
+    this->queueSize++;
+    this->mutex.give();
+    if (this->motionTask != nullptr) this->motionTask->notify();
+    if (!async) waitForMotion(command.id);
+}
+
+/**
+ * @brief Start the task that runs the motions, if it isn't running yet. The mutex has to be held
+ *
+ */
+void lemlib::Chassis::startMotionTask() {
+    if (this->motionTask == nullptr) this->motionTask = new pros::Task {[this] { runMotions(); }, "lemlib motions"};
+}
+
+/**
+ * @brief Body of the motion task, which runs the queued motions one at a time
+ *
+ */
+void lemlib::Chassis::runMotions() {
+    while (true) {
+        this->mutex.take(TIMEOUT_MAX);
+        // wait for a motion, unless one started with beginMotion is running
+        if (this->queueSize == 0 || this->runningId != 0) {
+            // a motion that chained into one that was then cancelled left the drivetrain moving
+            if (this->queueSize == 0 && this->runningId == 0 && this->chainVelocity != 0) {
+                this->chainVelocity = 0;
+                drivetrain.leftMotors->move(0);
+                drivetrain.rightMotors->move(0);
+            }
+            this->mutex.give();
+            pros::Task::notify_take(true, TIMEOUT_MAX);
+            continue;
+        }
+        const MotionCommand command = this->motionQueue[this->queueHead];
+        this->queueHead = (this->queueHead + 1) % MOTION_QUEUE_SIZE;
+        this->queueSize--;
+        this->runningId = command.id;
+        this->motionRunning = true;
+        this->motionLength = 0;
+        // there's room in the queue now
+        notifyWaiters();
+        this->mutex.give();
+        publishState();
+
+        switch (command.type) {
+            case MotionType::TURN_TO:
+                runTurnTo(command.x, command.y, command.timeout, command.forwards, command.maxSpeed);
+                break;
+            case MotionType::MOVE_TO_POINT:
+                runMoveToPoint(command.x, command.y, command.timeout, command.forwards, command.maxSpeed);
+                break;
+            case MotionType::MOVE_TO_POSE:
+                runMoveToPose(command.x, command.y, command.theta, command.timeout, command.params);
+                break;
+            case MotionType::FOLLOW:
+                runFollow(*command.path, command.lookahead, command.timeout, command.forwards, command.follower);
+                break;
+        }
+
+        finishActions(command.id, this->motionRunning);
+        this->mutex.take(TIMEOUT_MAX);
+        this->lastDoneId = std::max({this->lastDoneId, command.id, this->droppedId});
+        this->runningId = 0;
+        notifyWaiters();
+        this->mutex.give();
+        publishState();
+    }
+}
+
+/**
+ * @brief Block the calling task until a motion has finished or been cancelled, woken by task notifications
+ *
+ * @param id the motion
+ */
+void lemlib::Chassis::waitForMotion(uint32_t id) {
+    this->mutex.take(TIMEOUT_MAX);
+    while (this->lastDoneId < id) sleepUntilNotified();
+    this->mutex.give();
+}
+
+/**
+ * @brief Wake the tasks waiting in waitForMotion or for room in the queue, so they check again
+ *
+ */
+void lemlib::Chassis::notifyWaiters() {
+    for (const MotionWaiter& waiter : this->waiters) {
+        if (waiter.task != nullptr) pros::c::task_notify(waiter.task);
+    }
+}
+
+/**
+ * @brief Wake the tasks waiting for the running motion to travel as far as it has. Called by the motions every time
+ * they update distTravelled
+ *
+ */
+void lemlib::Chassis::notifyProgress() {
+    std::array<std::function<void()>, MAX_MOTION_ACTIONS> due;
+    std::size_t dueCount = 0;
+    this->mutex.take(TIMEOUT_MAX);
+    for (const MotionWaiter& waiter : this->waiters) {
+        if (waiter.task == nullptr || waiter.id == 0 || waiter.id != this->runningId) continue;
+        if (distTravelled > waiter.distance) pros::c::task_notify(waiter.task);
+    }
+    for (MotionAction& action : this->motionActions) {
+        if (!action.action || action.id != this->runningId) continue;
+        if (action.progress && this->motionLength <= 0) continue;
+        const float at = action.progress ? this->motionLength * action.at / 100 : action.at;
+        if (distTravelled <= at) continue;
+        due[dueCount++] = std::move(action.action);
+        action.action = nullptr;
+    }
+    this->mutex.give();
+    // outside the mutex, so the actions can use the chassis
+    for (std::size_t i = 0; i < dueCount; i++) due[i]();
+}
+
+/**
+ * @brief Take the actions left on a motion once it has ended, and run them unless it was cancelled
+ *
+ * @param id the motion
+ * @param run whether to run them
+ */
+void lemlib::Chassis::finishActions(uint32_t id, bool run) {
+    std::array<std::function<void()>, MAX_MOTION_ACTIONS> left;
+    std::size_t leftCount = 0;
+    this->mutex.take(TIMEOUT_MAX);
+    for (MotionAction& action : this->motionActions) {
+        if (!action.action || action.id != id) continue;
+        left[leftCount++] = std::move(action.action);
+        action.action = nullptr;
+    }
+    this->mutex.give();
+    if (run) {
+        for (std::size_t i = 0; i < leftCount; i++) left[i]();
+    }
+}
+
+/**
+ * @brief Give the mutex back until notifyWaiters is called, then take it again. Call with the mutex held
+ *
+ * Registers the calling task before giving the mutex back, so it can't miss the notification. Polls if too many tasks
+ * are waiting already
+ *
+ * @param id also wake once this motion has travelled further than distance. 0 for only notifyWaiters
+ * @param distance the distance, in the units of distTravelled
+ */
+void lemlib::Chassis::sleepUntilNotified(uint32_t id, float distance) {
+    auto slot = std::find_if(this->waiters.begin(), this->waiters.end(),
+                             [](const MotionWaiter& waiter) { return waiter.task == nullptr; });
+    const bool registered = slot != this->waiters.end();
+    if (registered) *slot = {pros::c::task_get_current(), id, distance};
+    this->mutex.give();
+    if (registered) pros::Task::notify_take(true, TIMEOUT_MAX);
+    else pros::delay(10);
+    this->mutex.take(TIMEOUT_MAX);
+    if (registered) *slot = MotionWaiter();
+}
+
+/**
+ * @brief Start a motion that runs in the calling task instead of the motion task
+ *
+ * Waits for the queued motions to finish, then keeps the motion task from starting any more until endMotion. For
+ * motions that block and return a result, like characterize
+ */
+void lemlib::Chassis::beginMotion() {
+    this->mutex.take(TIMEOUT_MAX);
+    while (this->queueSize != 0 || this->runningId != 0) sleepUntilNotified();
+    this->runningId = ++this->lastQueuedId;
+    this->motionRunning = true;
+    this->mutex.give();
+    publishState();
+}
+
+/**
+ * @brief Finish a motion started with beginMotion, and let the motion task carry on with the queue
+ *
+ */
+void lemlib::Chassis::endMotion() {
+    this->mutex.take(TIMEOUT_MAX);
+    this->lastDoneId = std::max({this->lastDoneId, this->runningId, this->droppedId});
+    this->runningId = 0;
+    notifyWaiters();
+    this->mutex.give();
+    publishState();
+    if (this->motionTask != nullptr) this->motionTask->notify();
+}
+
+/**
+ * @brief Cancels the currently running motion.
+ * If there is a queued motion, then that queued motion will run.
+ *
+ */
+void lemlib::Chassis::cancelMotion() { this->motionRunning = false; }
+
+/**
+ * @brief Cancels all motions, even those that are queued.
+ * After this, the chassis will not be in motion.
+ *
+ */
+void lemlib::Chassis::cancelAllMotions() {
+    this->mutex.take(TIMEOUT_MAX);
+    // drop the queue, and count everything in it as done
+    this->queueSize = 0;
+    this->droppedId = this->lastQueuedId;
+    if (this->runningId == 0) this->lastDoneId = this->lastQueuedId;
+    this->motionRunning = false;
+    notifyWaiters();
+    this->mutex.give();
+    // to stop the drivetrain, if a motion chained into one of the dropped ones
+    if (this->motionTask != nullptr) this->motionTask->notify();
+}
+
+/**
+ * @return whether a motion is waiting in the queue
+ */
+bool lemlib::Chassis::hasQueuedMotion() const { return this->queueSize != 0; }
+
+/**
+ * @brief Look ahead to the next motion in the queue, to see if the running motion can chain into it
+ *
+ * @param target target of the running motion in standard form, with theta the direction of travel at it
+ * @param forwards whether the running motion drives forwards
+ * @return ChainPlan
+ */
+lemlib::Chassis::ChainPlan lemlib::Chassis::planChain(const Pose& target, bool forwards) {
+    ChainPlan plan;
+    if (chainSettings.exitDistance <= 0 || lateralProfile.maxVelocity <= 0 || !hasQueuedMotion()) return plan;
+    this->mutex.take(TIMEOUT_MAX);
+    const bool queued = this->queueSize != 0;
+    const MotionCommand next = this->motionQueue[this->queueHead];
+    this->mutex.give();
+    if (!queued || next.forwards != forwards) return plan;
+    if (next.type != MotionType::MOVE_TO_POINT && next.type != MotionType::MOVE_TO_POSE) return plan;
+    // the next motion heads for its first carrot point, which is its target for moveToPoint
+    Pose nextTarget(next.x, next.y);
+    float lead = 0;
+    if (next.type == MotionType::MOVE_TO_POSE) {
+        nextTarget.theta = M_PI_2 - degToRad(next.theta);
+        if (!forwards) nextTarget.theta += M_PI;
+        lead = next.params.lead;
+    }
+    const Pose entry = nextTarget - Pose(cos(nextTarget.theta), sin(nextTarget.theta)) * lead *
+                                        target.distance(nextTarget);
+    // too short a leg to hand over on
+    if (target.distance(entry) <= chainSettings.exitDistance) return plan;
+    const float direction = target.angle(entry);
+    const float turn = fabs(angleError(direction, target.theta));
+    if (turn > degToRad(chainSettings.maxTurn)) return plan;
+    // round the corner with an arc meeting both legs exitDistance from it, as fast as the robot can go around it
+    // without accelerating sideways any harder than the profile accelerates forwards
+    const float radius = chainSettings.exitDistance / tan(turn / 2);
+    plan.chain = true;
+    plan.exitVelocity = std::fmin(lateralProfile.maxVelocity, sqrt(lateralProfile.maxAcceleration * radius));
+    plan.direction = direction;
+    return plan;
+}
+
+/**
+ * @brief Update a motion's stall detector from the drivetrain motors and the IMU
+ *
+ * @param detector the motion's stall detector
+ * @return true if the robot has stalled, and the motion should end
+ */
+bool lemlib::Chassis::checkStall(StallDetector& detector) {
+    if (stallSettings.time <= 0) return false;
+    const float freeVelocity = drivetrain.rpm * M_PI * drivetrain.wheelDiameter / 60;
+    float current = 0;
+    int motors = 0;
+    for (pros::Motor_Group* side : {drivetrain.leftMotors, drivetrain.rightMotors}) {
+        for (std::int32_t draw : side->get_current_draws()) {
+            current += std::abs(draw);
+            motors++;
+        }
+    }
+    if (motors > 0) current /= motors;
+    float acceleration = 0;
+    if (sensors.imu != nullptr) {
+        const pros::c::imu_accel_s_t accel = sensors.imu->get_accel();
+        if (!std::isinf(accel.x) && !std::isinf(accel.y)) acceleration = std::hypot(accel.x, accel.y);
+    }
+    // the wheels keep turning as they slip against a wall, so the speed comes from the IMU
+    const ChassisState now = state.read();
+    if (detector.update((leftPower + rightPower) / 2, now.groundSpeed, now.localSpeed.y, freeVelocity, current,
+                        acceleration))
+        stalls++;
+    return detector.getExit();
+}
+
+/**
+ * @brief Count how much sooner settle detection ended a motion than the exit countdowns would have
+ *
+ * @param countdownEnd when the countdowns would have ended the motion, in ms. -1 if they wouldn't have
+ */
+void lemlib::Chassis::recordSettle(int countdownEnd) {
+    const int now = pros::millis();
+    if (countdownEnd > now) settleSaved += countdownEnd - now;
+}
+
+/**
+ * @brief Set the gains of the PIDs from the gain schedules, if there are any, for this update
+ *
+ * @param lateralError error of the lateral PID, in inches
+ * @param angularError error of the angular PID, in degrees
+ */
+void lemlib::Chassis::scheduleGains(float lateralError, float angularError) {
+    lateralKS = lateralSettings.kS;
+    angularKS = angularSettings.kS;
+    if (lateralSchedule.empty() && angularSchedule.empty()) return;
+    const Pose speed = state.read().localSpeed;
+    if (!lateralSchedule.empty()) {
+        const GainPoint gains =
+            lateralSchedule.at(lateralSchedule.getKey() == ScheduleKey::SPEED ? speed.y : lateralError);
+        lateralPID.setGains(gains.kP, gains.kI, gains.kD);
+        lateralKS = gains.kS;
+    }
+    if (!angularSchedule.empty()) {
+        const GainPoint gains =
+            angularSchedule.at(angularSchedule.getKey() == ScheduleKey::SPEED ? radToDeg(speed.theta) : angularError);
+        angularPID.setGains(gains.kP, gains.kI, gains.kD);
+        angularKS = gains.kS;
+    }
+}
+
+/**
+ * @return whether a motion is currently running or queued
+ */
+bool lemlib::Chassis::isInMotion() const { return this->runningId != 0 || this->queueSize != 0; }
+
+/**
+ * @brief Drive tank, arcade and curvature through a drive curve table, instead of the drive curve function
+ *
+ * The table has its own curve baked in, so their curveGain is ignored
+ *
+ * @param table the table, which has to outlive the chassis, like a constexpr one at namespace scope
+ */
+void lemlib::Chassis::setDriveCurve(const DriveCurveTable& table) { curveTable = &table; }
+
+/**
+ * @brief Control the robot during the driver control period using the tank drive control scheme. In this control
+ * scheme one joystick axis controls one half of the robot, and another joystick axis controls another.
+ * @param left speed of the left side of the drivetrain. Takes an input from -127 to 127.
+ * @param right speed of the right side of the drivetrain. Takes an input from -127 to 127.
+ * @param curveGain control how steep the drive curve is. The larger the number, the steeper the curve. A value
+ * of 0 disables the curve entirely.
+ */
+void lemlib::Chassis::tank(int left, int right, float curveGain) { driveSides(left, right, curveGain); }
+
+/**
+ * @brief Control the robot during the driver using the arcade drive control scheme. In this control scheme one
+ * joystick axis controls the forwards and backwards movement of the robot, while the other joystick axis
+ * controls  the robot's turning
+ * @param throttle speed to move forward or backward. Takes an input from -127 to 127.
+ * @param turn speed to turn. Takes an input from -127 to 127.
+ * @param curveGain the scale inputted into the drive curve function. If you are using the default drive
+ * curve, refer to the `defaultDriveCurve` documentation.
+ */
+void lemlib::Chassis::arcade(int throttle, int turn, float curveGain) {
+    driveSides(throttle + turn, throttle - turn, curveGain);
+}
+
+/**
+ * @brief Control the robot during the driver using the curvature drive control scheme. This control scheme is
+ * very similar to arcade drive, except the second joystick axis controls the radius of the curve that the
+ * drivetrain makes, rather than the speed. This means that the driver can accelerate in a turn without changing
+ * the radius of that turn. This control scheme defaults to arcade when forward is zero.
+ * @param throttle speed to move forward or backward. Takes an input from -127 to 127.
+ * @param turn speed to turn. Takes an input from -127 to 127.
+ * @param curveGain the scale inputted into the drive curve function. If you are using the default drive
+ * curve, refer to the `defaultDriveCurve` documentation.
+ */
+void lemlib::Chassis::curvature(int throttle, int turn, float curveGain) {
+    // If we're not moving forwards change to arcade drive
+    if (throttle == 0) {
+        arcade(throttle, turn, curveGain);
+        return;
+    }
+
+    float leftPower = throttle + (std::abs(throttle) * turn) / 127.0;
+    float rightPower = throttle - (std::abs(throttle) * turn) / 127.0;
+
+    driveSides(leftPower, rightPower, curveGain);
+}
+
+/**
+ * @brief Drive each side of the drivetrain at a power from a driver control scheme, through the drive curve
+ *
+ * @param leftPower power of the left side, before the drive curve
+ * @param rightPower power of the right side, before the drive curve
+ * @param curveGain the scale inputted into the drive curve function
+ */
+void lemlib::Chassis::driveSides(float leftPower, float rightPower, float curveGain) {
+    // a custom curve function can't be baked into a table, so it goes through its std::function
+    if (curveTable == nullptr && !defaultCurve) {
+        leftPorts.move(drivePipeline.output(driveCurve(leftPower, curveGain)));
+        rightPorts.move(drivePipeline.output(driveCurve(rightPower, curveGain)));
+        return;
+    }
+    // the default curve is baked again only when the gain changes, which it doesn't in a normal opcontrol loop
+    if (curveTable == nullptr && curveGain != defaultCurveGain) {
+        defaultCurveTable = DriveCurveTable(ExpoCurve {curveGain});
+        defaultCurveGain = curveGain;
+    }
+    drivePipeline.shaping.table = curveTable != nullptr ? curveTable : &defaultCurveTable;
+    leftPorts.move(drivePipeline.update(leftPower));
+    rightPorts.move(drivePipeline.update(rightPower));
+}
@@ -0,0 +1,205 @@
+/**
+ * @file src/lemlib/chassis/ekf.cpp
+ * @author LemLib Team
+ * @brief Extended Kalman filter for estimating the pose of a differential drive
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <math.h>
+#include "lemlib/chassis/ekf.hpp"
+
+// indices of each state
+constexpr std::size_t X = 0;
+constexpr std::size_t Y = 1;
+constexpr std::size_t THETA = 2;
+constexpr std::size_t FORWARD = 3;
+constexpr std::size_t SIDEWAYS = 4;
+constexpr std::size_t ANGULAR = 5;
+
+/**
+ * @brief Construct a new Ekf at the origin, at rest
+ *
+ * @param settings the tuning
+ */
+lemlib::Ekf::Ekf(EkfSettings settings)
+    : settings(settings) {
+    // the starting pose is set by the user, so it's only off by how carefully the robot was placed
+    covariance(X, X) = 1;
+    covariance(Y, Y) = 1;
+    covariance(THETA, THETA) = 0.001;
+    covariance(FORWARD, FORWARD) = 0.01;
+    covariance(SIDEWAYS, SIDEWAYS) = 0.01;
+    covariance(ANGULAR, ANGULAR) = 0.0001;
+}
+
+/**
+ * @brief Get the tuning
+ *
+ * @return const EkfSettings&
+ */
+const lemlib::EkfSettings& lemlib::Ekf::getSettings() const { return settings; }
+
+/**
+ * @brief Move the estimate without changing the velocity or its uncertainty
+ *
+ * @param pose the new pose, theta in radians
+ */
+void lemlib::Ekf::setPose(Pose pose) {
+    state(X, 0) = pose.x;
+    state(Y, 0) = pose.y;
+    state(THETA, 0) = pose.theta;
+}
+
+/**
+ * @brief Advance the estimate in time
+ *
+ * @param dt time since the last prediction, in seconds
+ */
+void lemlib::Ekf::predict(float dt) {
+    if (dt <= 0) return;
+    const float theta = state(THETA, 0);
+    const float forward = state(FORWARD, 0);
+    const float sideways = state(SIDEWAYS, 0);
+    const float s = sin(theta);
+    const float c = cos(theta);
+
+    // constant velocity in the robot's frame
+    state(X, 0) += (forward * s - sideways * c) * dt;
+    state(Y, 0) += (forward * c + sideways * s) * dt;
+    state(THETA, 0) += state(ANGULAR, 0) * dt;
+
+    // jacobian of the prediction
+    Matrix<STATES, STATES> f = Matrix<STATES, STATES>::identity();
+    f(X, THETA) = (forward * c + sideways * s) * dt;
+    f(X, FORWARD) = s * dt;
+    f(X, SIDEWAYS) = -c * dt;
+    f(Y, THETA) = (-forward * s + sideways * c) * dt;
+    f(Y, FORWARD) = c * dt;
+    f(Y, SIDEWAYS) = s * dt;
+    f(THETA, ANGULAR) = dt;
+
+    // accelerations the model can't predict show up as uncertainty in the velocities
+    Matrix<STATES, STATES> q;
+    q(FORWARD, FORWARD) = powf(settings.forwardAccelNoise * dt, 2);
+    q(SIDEWAYS, SIDEWAYS) = powf(settings.sidewaysAccelNoise * dt, 2);
+    q(ANGULAR, ANGULAR) = powf(settings.angularAccelNoise * dt, 2);
+
+    covariance = f * covariance * f.transpose() + q;
+    // keep rounding errors from making the covariance lopsided
+    covariance = (covariance + covariance.transpose()) * 0.5;
+}
+
+/**
+ * @brief Fold in a scalar measurement that depends linearly on the state
+ *
+ * @param h how the measurement depends on each state
+ * @param residual measurement minus its prediction
+ * @param noise standard deviation of the measurement
+ */
+void lemlib::Ekf::correct(const Matrix<1, STATES>& h, float residual, float noise) {
+    const Matrix<STATES, 1> ph = covariance * h.transpose();
+    const float innovation = (h * ph)(0, 0) + noise * noise;
+    const Matrix<STATES, 1> gain = ph * (1 / innovation);
+    state = state + gain * residual;
+    covariance = covariance - gain * ph.transpose();
+}
+
+/**
+ * @brief Fold in the velocity measured by a wheel
+ *
+ * @param velocity velocity of the wheel tread, in inches per second
+ * @param offset offset of the wheel from the tracking center, using the TrackingWheel convention
+ * @param horizontal whether the wheel measures sideways motion
+ * @param noise standard deviation of the measurement, in inches per second
+ */
+void lemlib::Ekf::updateWheel(float velocity, float offset, bool horizontal, float noise) {
+    // a wheel measures the velocity along it, minus the part of the rotation it sees
+    const std::size_t along = horizontal ? SIDEWAYS : FORWARD;
+    Matrix<1, STATES> h;
+    h(0, along) = 1;
+    h(0, ANGULAR) = -offset;
+    correct(h, velocity - (state(along, 0) - offset * state(ANGULAR, 0)), noise);
+}
+
+/**
+ * @brief Fold in a heading measurement
+ *
+ * @param heading the heading, in radians. Wrapped to the nearest turn of the estimate
+ * @param noise standard deviation of the measurement, in radians
+ */
+void lemlib::Ekf::updateHeading(float heading, float noise) {
+    Matrix<1, STATES> h;
+    h(0, THETA) = 1;
+    correct(h, remainderf(heading - state(THETA, 0), 2 * M_PI), noise);
+}
+
+/**
+ * @brief Fold in an angular velocity measurement
+ *
+ * @param angularVelocity clockwise positive, in radians per second
+ * @param noise standard deviation of the measurement, in radians per second
+ */
+void lemlib::Ekf::updateAngularVelocity(float angularVelocity, float noise) {
+    Matrix<1, STATES> h;
+    h(0, ANGULAR) = 1;
+    correct(h, angularVelocity - state(ANGULAR, 0), noise);
+}
+
+/**
+ * @brief Fold in a position measurement
+ *
+ * @param x x position, in inches
+ * @param y y position, in inches
+ * @param noise standard deviation of the measurement on each axis, in inches
+ */
+void lemlib::Ekf::updatePosition(float x, float y, float noise) {
+    // the axes are independent, so they can go in one after the other
+    Matrix<1, STATES> hx;
+    hx(0, X) = 1;
+    correct(hx, x - state(X, 0), noise);
+    Matrix<1, STATES> hy;
+    hy(0, Y) = 1;
+    correct(hy, y - state(Y, 0), noise);
+}
+
+/**
+ * @brief Get the estimated pose
+ *
+ * @return Pose theta in radians
+ */
+lemlib::Pose lemlib::Ekf::getPose() const { return Pose(state(X, 0), state(Y, 0), state(THETA, 0)); }
+
+/**
+ * @brief Get the estimated speed in field coordinates
+ *
+ * @return Pose in inches and radians per second
+ */
+lemlib::Pose lemlib::Ekf::getSpeed() const {
+    const float theta = state(THETA, 0);
+    const float forward = state(FORWARD, 0);
+    const float sideways = state(SIDEWAYS, 0);
+    return Pose(forward * sin(theta) - sideways * cos(theta), forward * cos(theta) + sideways * sin(theta),
+                state(ANGULAR, 0));
+}
+
+/**
+ * @brief Get the estimated speed relative to the robot
+ *
+ * @return Pose x sideways, y forwards, in inches and radians per second
+ */
+lemlib::Pose lemlib::Ekf::getLocalSpeed() const {
+    return Pose(state(SIDEWAYS, 0), state(FORWARD, 0), state(ANGULAR, 0));
+}
+
+/**
+ * @brief Get the covariance of the state
+ *
+ * @return const Matrix<STATES, STATES>&
+ */
+const lemlib::Matrix<lemlib::Ekf::STATES, lemlib::Ekf::STATES>& lemlib::Ekf::getCovariance() const {
+    return covariance;
+}
@@ -0,0 +1,148 @@
+#include <cmath>
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+
+/** @brief time between updates of the motion PIDs, in seconds */
+constexpr float PID_PERIOD = 0.01;
+/** @brief how long to keep watching a test step after its motion ends, to catch the robot coasting, in ms */
+constexpr int COAST_TIME = 250;
+
+namespace {
+/**
+ * @brief Watch a test step to measure its overshoot and settle time
+ *
+ * @param chassis the chassis, already running the step
+ * @param smallError how close to the target counts as settled
+ * @param remaining gets how far the step has left to go. Negative once it has gone past the target
+ * @param result where to store the overshoot and settle time
+ */
+template <typename F> void watchStep(lemlib::Chassis& chassis, float smallError, F remaining,
+                                     lemlib::AutotuneResult& result) {
+    const uint32_t start = pros::millis();
+    int settledSince = -1;
+    uint32_t end = 0;
+    result.overshoot = 0;
+    while (end == 0 || pros::millis() - end < COAST_TIME) {
+        if (end == 0 && !chassis.isInMotion()) end = pros::millis();
+        const float error = remaining();
+        result.overshoot = std::fmax(result.overshoot, -error);
+        if (std::fabs(error) > smallError) settledSince = -1;
+        else if (settledSince < 0) settledSince = pros::millis() - start;
+        pros::delay(10);
+    }
+    result.settleTime = settledSince;
+}
+} // namespace
+
+/**
+ * @brief Tune the lateral PID with a relay feedback experiment, driving forwards and backwards
+ *
+ * The relay drives the robot back and forth about where it started, holding its heading with the angular PID, so
+ * tune the angular PID first. If the experiment works, the new gains are set, and if the settings have a test
+ * distance, the robot then drives that far to measure them. This function blocks until it is done.
+ *
+ * @param settings how to run the experiment
+ * @return AutotuneResult
+ */
+lemlib::AutotuneResult lemlib::Chassis::autotuneLateral(AutotuneSettings settings) {
+    this->beginMotion();
+    const Pose start = getPose();
+    const float startTheta = degToRad(start.theta);
+    RelayExperiment relay(settings.relayPower, settings.hysteresis);
+    Timer timer(settings.timeout);
+    const uint32_t startTime = pros::millis();
+    angularPID.reset();
+    distTravelled = 0;
+
+    while (!timer.isDone() && this->motionRunning && relay.getCycles() < settings.cycles) {
+        const Pose pose = getPose();
+        // how far the robot is behind where it started, along the heading it started at
+        const float error = -((pose.x - start.x) * std::sin(startTheta) + (pose.y - start.y) * std::cos(startTheta));
+        const float lateralOut = relay.update(error, (pros::millis() - startTime) / 1000.0);
+        const float angularOut = angularPID.update(angleError(start.theta, pose.theta, false));
+        moveVoltage(lateralOut + angularOut, lateralOut - angularOut);
+        pros::delay(10);
+    }
+
+    // stop the drivetrain
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    AutotuneResult result;
+    result.ultimateGain = relay.getUltimateGain();
+    result.ultimatePeriod = relay.getUltimatePeriod();
+    result.success = this->motionRunning && relay.getCycles() >= settings.cycles && result.ultimateGain > 0;
+    // set distTravelled to -1 to indicate that the function has finished
+    distTravelled = -1;
+    this->endMotion();
+    if (!result.success) return result;
+    result.gains = tunePID(result.ultimateGain, result.ultimatePeriod, settings.rule, PID_PERIOD);
+    setLateralGains(result.gains);
+
+    // check the new gains by driving to a point straight ahead
+    if (settings.testDistance != 0) {
+        const Pose from = getPose();
+        const float theta = degToRad(from.theta);
+        const Pose target(from.x + settings.testDistance * std::sin(theta),
+                          from.y + settings.testDistance * std::cos(theta));
+        moveToPoint(target.x, target.y, 4000, settings.testDistance > 0);
+        watchStep(*this, lateralSettings.smallError, [&]() {
+            const Pose pose = getPose();
+            const float ahead = (target.x - pose.x) * std::sin(theta) + (target.y - pose.y) * std::cos(theta);
+            return settings.testDistance > 0 ? ahead : -ahead;
+        }, result);
+    }
+    return result;
+}
+
+/**
+ * @brief Tune the angular PID with a relay feedback experiment, turning in place
+ *
+ * The relay turns the robot back and forth about the heading it started at. If the experiment works, the new gains
+ * are set, and if the settings have a test distance, the robot then turns that many degrees to measure them. This
+ * function blocks until it is done.
+ *
+ * @param settings how to run the experiment
+ * @return AutotuneResult
+ */
+lemlib::AutotuneResult lemlib::Chassis::autotuneAngular(AutotuneSettings settings) {
+    this->beginMotion();
+    const float startTheta = getPose().theta;
+    RelayExperiment relay(settings.relayPower, settings.hysteresis);
+    Timer timer(settings.timeout);
+    const uint32_t startTime = pros::millis();
+    distTravelled = 0;
+
+    while (!timer.isDone() && this->motionRunning && relay.getCycles() < settings.cycles) {
+        const float error = angleError(startTheta, getPose().theta, false);
+        const float output = relay.update(error, (pros::millis() - startTime) / 1000.0);
+        moveVoltage(output, -output);
+        pros::delay(10);
+    }
+
+    // stop the drivetrain
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    AutotuneResult result;
+    result.ultimateGain = relay.getUltimateGain();
+    result.ultimatePeriod = relay.getUltimatePeriod();
+    result.success = this->motionRunning && relay.getCycles() >= settings.cycles && result.ultimateGain > 0;
+    // set distTravelled to -1 to indicate that the function has finished
+    distTravelled = -1;
+    this->endMotion();
+    if (!result.success) return result;
+    result.gains = tunePID(result.ultimateGain, result.ultimatePeriod, settings.rule, PID_PERIOD);
+    setAngularGains(result.gains);
+
+    // check the new gains by turning to face a point far away
+    if (settings.testDistance != 0) {
+        const Pose from = getPose();
+        const float target = from.theta + settings.testDistance;
+        turnTo(from.x + 100 * std::sin(degToRad(target)), from.y + 100 * std::cos(degToRad(target)), 4000);
+        watchStep(*this, angularSettings.smallError, [&]() {
+            const float error = angleError(target, getPose().theta, false);
+            return settings.testDistance > 0 ? error : -error;
+        }, result);
+    }
+    return result;
+}
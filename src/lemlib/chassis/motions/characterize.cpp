@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/util.hpp"
+
+namespace {
+/**
+ * @brief The average of what the motors on one side measured
+ *
+ */
+struct SideSample {
+        float voltage;
+        float velocity;
+        float current;
+};
+
+/**
+ * @brief Read the motors on one side
+ *
+ * @param motors the motors
+ * @param wheelRpm rpm of the wheels when the motors spin at the free speed of their cartridge
+ * @param wheelDiameter diameter of the wheels, in inches
+ * @param timestamp where to store the time the first motor took its sample, in ms. The others sample within 10 ms
+ * of it
+ */
+SideSample readSide(pros::Motor_Group* motors, float wheelRpm, float wheelDiameter, std::uint32_t& timestamp) {
+    const int count = motors->size();
+    std::vector<std::uint32_t> times(count, 0);
+    std::vector<std::uint32_t*> timestamps;
+    for (std::uint32_t& time : times) timestamps.push_back(&time);
+    motors->get_raw_positions(timestamps);
+    const std::vector<pros::motor_gearset_e_t> gearsets = motors->get_gearing();
+    const std::vector<double> velocities = motors->get_actual_velocities();
+    // the voltage is signed, even though PROS returns it unsigned
+    const std::vector<std::uint32_t> voltages = motors->get_voltages();
+    const std::vector<std::int32_t> currents = motors->get_current_draws();
+
+    SideSample side {0, 0, 0};
+    timestamp = count > 0 ? times[0] : 0;
+    for (int i = 0; i < count; i++) {
+        float cartridgeRpm;
+        switch (gearsets[i]) {
+            case pros::E_MOTOR_GEARSET_36: cartridgeRpm = 100; break;
+            case pros::E_MOTOR_GEARSET_06: cartridgeRpm = 600; break;
+            default: cartridgeRpm = 200; break;
+        }
+        side.voltage += std::int32_t(voltages[i]) / 1000.0f;
+        side.velocity += velocities[i] * (wheelRpm / cartridgeRpm) * M_PI * wheelDiameter / 60;
+        side.current += currents[i] / 1000.0f;
+    }
+    if (count > 0) {
+        side.voltage /= count;
+        side.velocity /= count;
+        side.current /= count;
+    }
+    return side;
+}
+
+/**
+ * @brief Which way each side drives during a test
+ *
+ * @return std::pair<int, int> 1 forwards and -1 backwards, for the left then the right side
+ */
+std::pair<int, int> directions(lemlib::SysIdTest test) {
+    switch (test) {
+        case lemlib::SysIdTest::QUASISTATIC_FORWARD:
+        case lemlib::SysIdTest::DYNAMIC_FORWARD: return {1, 1};
+        case lemlib::SysIdTest::QUASISTATIC_BACKWARD:
+        case lemlib::SysIdTest::DYNAMIC_BACKWARD: return {-1, -1};
+        case lemlib::SysIdTest::QUASISTATIC_CLOCKWISE:
+        case lemlib::SysIdTest::DYNAMIC_CLOCKWISE: return {1, -1};
+        default: return {-1, 1};
+    }
+}
+
+bool isQuasistatic(lemlib::SysIdTest test) {
+    return test == lemlib::SysIdTest::QUASISTATIC_FORWARD || test == lemlib::SysIdTest::QUASISTATIC_BACKWARD ||
+           test == lemlib::SysIdTest::QUASISTATIC_CLOCKWISE || test == lemlib::SysIdTest::QUASISTATIC_COUNTERCLOCKWISE;
+}
+} // namespace
+
+/**
+ * @brief Characterize the drivetrain, and save what the motors measured for fitting feedforward constants
+ *
+ * Runs each SysIdTest in order, driving the motors with raw voltages and recording their voltage, velocity and
+ * current every time they take a sample. The samples are kept in memory and saved once the tests are done, so the SD
+ * card doesn't slow down the tests. Fit the log on a computer with the sysid-fit tool of the simulator, or on the
+ * brain with fitLinear and fitAngular. This function blocks until the tests are done.
+ *
+ * @param path where to save the log. Files on the SD card start with /usd/
+ * @param settings how to run the tests
+ * @return true if the tests finished and the log was saved
+ */
+bool lemlib::Chassis::characterize(const char* path, SysIdSettings settings) {
+    this->beginMotion();
+    distTravelled = 0;
+    SysIdLog log(drivetrain.trackWidth);
+    std::uint32_t lastSample = 0;
+
+    for (int i = 0; i <= int(SysIdTest::DYNAMIC_COUNTERCLOCKWISE) && this->motionRunning; i++) {
+        const SysIdTest test = SysIdTest(i);
+        const bool quasistatic = isQuasistatic(test);
+        const auto [leftDirection, rightDirection] = directions(test);
+        const float duration = quasistatic ? settings.quasistaticTime : settings.dynamicTime;
+        const std::uint32_t start = pros::millis();
+
+        // the motors sample every 10 ms, so checking twice as often catches every sample
+        while (this->motionRunning) {
+            const float elapsed = (pros::millis() - start) / 1000.0;
+            if (elapsed > duration) break;
+            const float voltage = quasistatic ? settings.rampRate * elapsed : settings.stepVoltage;
+            drivetrain.leftMotors->move_voltage(leftDirection * voltage * 1000);
+            drivetrain.rightMotors->move_voltage(rightDirection * voltage * 1000);
+
+            // one sample each time the first left motor takes one
+            std::uint32_t time;
+            std::uint32_t rightTime;
+            const SideSample left = readSide(drivetrain.leftMotors, drivetrain.rpm, drivetrain.wheelDiameter, time);
+            const SideSample right =
+                readSide(drivetrain.rightMotors, drivetrain.rpm, drivetrain.wheelDiameter, rightTime);
+            if (time != lastSample) {
+                lastSample = time;
+                log.add({time, test, left.voltage, right.voltage, left.velocity, right.velocity, left.current,
+                         right.current});
+            }
+            pros::delay(5);
+        }
+
+        // let the robot stop before the next test
+        drivetrain.leftMotors->move_voltage(0);
+        drivetrain.rightMotors->move_voltage(0);
+        if (this->motionRunning) pros::delay(settings.restTime * 1000);
+    }
+
+    const bool finished = this->motionRunning;
+    // set distTravelled to -1 to indicate that the function has finished
+    distTravelled = -1;
+    this->endMotion();
+    return finished && log.save(path);
+}
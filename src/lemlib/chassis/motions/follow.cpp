@@ -0,0 +1,311 @@
+/**
+ * @file src/lemlib/chassis/motions/follow.cpp
+ * @author LemLib Team
+ * @brief Pure Pursuit motion algorithm
+ * @version 0.4.5
+ * @date 2023-01-27
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include "pros/rtos.hpp"
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/util.hpp"
+
+/**
+ * @brief function that returns elements in a file line, separated by a delimeter
+ *
+ * @param input the raw string
+ * @param delimeter string separating the elements in the line
+ * @return std::vector<std::string> array of elements read from the file
+ */
+std::vector<std::string> splitString(const std::string& input, const std::string& delimiter) {
+    std::string token;
+    std::string s = input;
+    std::vector<std::string> output;
+    size_t pos = 0;
+
+    // main loop
+    while ((pos = s.find(delimiter)) != std::string::npos) { // while there are still delimiters in the string
+        token = s.substr(0, pos); // processed substring
+        output.push_back(token);
+        s.erase(0, pos + delimiter.length()); // remove the read substring
+    }
+
+    output.push_back(s); // add the last element to the returned string
+
+    return output;
+}
+
+/**
+ * @brief Parse a path asset into a list of path points
+ *
+ * @param path the path asset to parse
+ * @return std::vector<lemlib::Pose> the path. The theta value of each pose is the target velocity
+ */
+std::vector<lemlib::Pose> getData(const asset& path) {
+    std::vector<lemlib::Pose> robotPath;
+    std::vector<std::string> pathData = splitString(std::string(reinterpret_cast<char*>(path.buf), path.size), "\n");
+
+    for (std::string line : pathData) { // read file line by line
+        lemlib::Pose pathPoint(0, 0);
+        // check for end of data
+        if (line == "endData" || line == "endData\r") break;
+        std::vector<std::string> pointInput = splitString(line, ", "); // parse line
+        pathPoint.x = std::stof(pointInput.at(0)); // x position
+        pathPoint.y = std::stof(pointInput.at(1)); // y position
+        pathPoint.theta = std::stof(pointInput.at(2)); // velocity
+        robotPath.push_back(pathPoint); // save data
+    }
+
+    return robotPath;
+}
+
+/**
+ * @brief find the closest point on the path to the robot
+ *
+ * @param pose the current pose of the robot
+ * @param path the path to follow
+ * @return int index to the closest point
+ */
+int findClosest(lemlib::Pose pose, std::vector<lemlib::Pose> path) {
+    int closestPoint = 0;
+    float closestDist = 1000000;
+    float dist;
+
+    // loop through all path points
+    for (int i = 0; i < int(path.size()); i++) {
+        dist = pose.distance(path.at(i));
+        if (dist < closestDist) { // new closest point
+            closestDist = dist;
+            closestPoint = i;
+        }
+    }
+
+    return closestPoint;
+}
+
+/**
+ * @brief Function that finds the intersection point between a circle and a line
+ *
+ * @param p1 start point of the line
+ * @param p2 end point of the line
+ * @param pos position of the robot
+ * @param path the path to follow
+ * @return float how far along the line the intersection is, -1 if there is no intersection
+ */
+float circleIntersect(lemlib::Pose p1, lemlib::Pose p2, lemlib::Pose pose, float lookaheadDist) {
+    // calculations
+    // uses the quadratic formula to calculate intersection points
+    lemlib::Pose d = p2 - p1;
+    lemlib::Pose f = p1 - pose;
+    float a = d * d;
+    float b = 2 * (f * d);
+    float c = (f * f) - lookaheadDist * lookaheadDist;
+    float discriminant = b * b - 4 * a * c;
+
+    // if a possible intersection was found
+    if (discriminant >= 0) {
+        discriminant = sqrt(discriminant);
+        float t1 = (-b - discriminant) / (2 * a);
+        float t2 = (-b + discriminant) / (2 * a);
+
+        // prioritize further down the path
+        if (t2 >= 0 && t2 <= 1) return t2;
+        else if (t1 >= 0 && t1 <= 1) return t1;
+    }
+
+    // no intersection found
+    return -1;
+}
+
+/**
+ * @brief returns the lookahead point
+ *
+ * @param lastLookahead - the last lookahead point
+ * @param pose - the current position of the robot
+ * @param path - the path to follow
+ * @param closest - the index of the closest point on the path
+ * @param lookaheadDist - the lookahead distance of the algorithm
+ */
+lemlib::Pose lookaheadPoint(lemlib::Pose lastLookahead, lemlib::Pose pose, std::vector<lemlib::Pose> path, int closest,
+                            float lookaheadDist) {
+    // optimizations applied:
+    // only consider intersections that have an index greater than or equal to the point closest
+    // to the robot
+    // and intersections that have an index greater than or equal to the index of the last
+    // lookahead point
+    const int start = std::max(closest, int(lastLookahead.theta));
+    for (int i = start; i < int(path.size()) - 1; i++) {
+        lemlib::Pose lastPathPose = path.at(i);
+        lemlib::Pose currentPathPose = path.at(i + 1);
+
+        float t = circleIntersect(lastPathPose, currentPathPose, pose, lookaheadDist);
+
+        if (t != -1) {
+            lemlib::Pose lookahead = lastPathPose.lerp(currentPathPose, t);
+            lookahead.theta = i;
+            return lookahead;
+        }
+    }
+
+    // robot deviated from path, use last lookahead point
+    return lastLookahead;
+}
+
+/**
+ * @brief Get the curvature of a circle that intersects the robot and the lookahead point
+ *
+ * @param pos the position of the robot
+ * @param heading the heading of the robot
+ * @param lookahead the lookahead point
+ * @return float curvature
+ */
+float findLookaheadCurvature(lemlib::Pose pose, float heading, lemlib::Pose lookahead) {
+    // calculate whether the robot is on the left or right side of the circle
+    float side = lemlib::sgn(std::sin(heading) * (lookahead.x - pose.x) - std::cos(heading) * (lookahead.y - pose.y));
+    // calculate center point and radius
+    float a = -std::tan(heading);
+    float c = std::tan(heading) * pose.x - pose.y;
+    float x = std::fabs(a * lookahead.x + lookahead.y + c) / std::sqrt((a * a) + 1);
+    float d = std::hypot(lookahead.x - pose.x, lookahead.y - pose.y);
+
+    // return curvature
+    return side * ((2 * x) / (d * d));
+}
+
+/**
+ * @brief Move the chassis along a path
+ *
+ * @param path the path asset to follow
+ * @param lookahead the lookahead distance. Units in inches. Larger values will make the robot move faster but
+ * will follow the path less accurately
+ * @param timeout the maximum time the robot can spend moving
+ * @param forwards whether the robot should follow the path going forwards. true by default
+ * @param async whether the function should be run asynchronously. true by default
+ * @param follower how to drive along the path. Pure pursuit by default. RAMSETE ignores the lookahead, and falls
+ * back to pure pursuit if the path can't be planned
+ */
+void lemlib::Chassis::follow(const asset& path, float lookahead, int timeout, bool forwards, bool async,
+                             PathFollower follower) {
+    MotionCommand command;
+    command.type = MotionType::FOLLOW;
+    command.timeout = timeout;
+    command.forwards = forwards;
+    command.path = &path;
+    command.lookahead = lookahead;
+    command.follower = follower;
+    queueMotion(command, async);
+}
+
+/**
+ * @brief Run a follow motion, in the motion task
+ *
+ * @param path the path asset to follow
+ * @param lookahead the lookahead distance. Units in inches
+ * @param timeout the maximum time the robot can spend moving
+ * @param forwards whether the robot should follow the path going forwards
+ * @param follower how to drive along the path
+ */
+void lemlib::Chassis::runFollow(const asset& path, float lookahead, int timeout, bool forwards,
+                                PathFollower follower) {
+    std::vector<lemlib::Pose> pathPoints = getData(path); // get list of path points
+    if (pathPoints.size() == 0) return;
+    // plan the speed along the path from the drivetrain, if planning is on
+    TrajectoryConstraints constraints = pathConstraints;
+    const float freeSpeed = drivetrain.rpm * M_PI * drivetrain.wheelDiameter / 60;
+    if (constraints.maxVelocity <= 0) constraints.maxVelocity = freeSpeed;
+    const bool planned = constraints.maxAcceleration > 0;
+    const Trajectory trajectory = planned ? Trajectory(pathPoints, drivetrain.trackWidth, constraints) : Trajectory();
+    // motor power per inch per second
+    const float kV = lateralSettings.kV > 0 ? lateralSettings.kV : 127 / freeSpeed;
+    if (follower == PathFollower::RAMSETE && planned) {
+        ramsete(trajectory, timeout, forwards, kV);
+        return;
+    }
+
+    Pose pose = this->getPose(true);
+    Pose lastPose = pose;
+    Pose lookaheadPose(0, 0, 0);
+    Pose lastLookahead = pathPoints.at(0);
+    lastLookahead.theta = 0;
+    float curvature;
+    float targetVel;
+    float prevVel = 0;
+    int closestPoint;
+    distTravelled = 0;
+    motionLength = 0;
+    for (std::size_t i = 1; i < pathPoints.size(); i++) motionLength += pathPoints[i].distance(pathPoints[i - 1]);
+
+    StallDetector stall(stallSettings);
+
+    // loop until the robot is within the end tolerance
+    for (int i = 0; i < timeout / 10 && this->motionRunning; i++) {
+        // get the current position of the robot
+        pose = this->getPose(true);
+        if (!forwards) pose.theta -= M_PI;
+
+        // update completion vars
+        distTravelled += pose.distance(lastPose);
+        notifyProgress();
+        // give up if the robot is stuck against something
+        if (checkStall(stall)) break;
+        lastPose = pose;
+
+        // find the closest point on the path to the robot
+        closestPoint = findClosest(pose, pathPoints);
+        // if the robot is at the end of the path, then stop
+        if (pathPoints.at(closestPoint).theta == 0) break;
+
+        // find the lookahead point
+        lookaheadPose = lookaheadPoint(lastLookahead, pose, pathPoints, closestPoint, lookahead);
+        lastLookahead = lookaheadPose; // update last lookahead position
+
+        // get the curvature of the arc between the robot and the lookahead point
+        float curvatureHeading = M_PI / 2 - pose.theta;
+        curvature = findLookaheadCurvature(pose, curvatureHeading, lookaheadPose);
+
+        // get the target velocity of the robot
+        if (planned) {
+            // where the trajectory will be by the time the motors respond, as motor power
+            const TrajectoryPoint target = trajectory.sample(trajectory.at(closestPoint).time + 0.01);
+            targetVel = kV * target.velocity + lateralSettings.kA * target.acceleration;
+            if (target.velocity > 0) targetVel += lateralSettings.kS;
+            targetVel = std::fmax(targetVel, 0);
+        } else {
+            targetVel = pathPoints.at(closestPoint).theta;
+            targetVel = slew(targetVel, prevVel, lateralSettings.slew);
+        }
+        prevVel = targetVel;
+
+        // calculate target left and right velocities
+        float targetLeftVel = targetVel * (2 + curvature * drivetrain.trackWidth) / 2;
+        float targetRightVel = targetVel * (2 - curvature * drivetrain.trackWidth) / 2;
+
+        // ratio the speeds to respect the max speed
+        float ratio = std::max(std::fabs(targetLeftVel), std::fabs(targetRightVel)) / 127;
+        if (ratio > 1) {
+            targetLeftVel /= ratio;
+            targetRightVel /= ratio;
+        }
+
+        // move the drivetrain
+        if (forwards) {
+            moveVoltage(targetLeftVel, targetRightVel);
+        } else {
+            moveVoltage(-targetRightVel, -targetLeftVel);
+        }
+
+        pros::delay(10);
+    }
+
+    // stop the robot
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    // set distTravelled to -1 to indicate that the function has finished
+    distTravelled = -1;
+}
@@ -0,0 +1,211 @@
+#include <cmath>
+#include <algorithm>
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+
+/**
+ * @brief Move the chassis towards a target point
+ *
+ * @param x x location
+ * @param y y location
+ * @param timeout longest time the robot can spend moving
+ * @param forwards whether the robot should move forwards or backwards. true by default
+ * @param maxSpeed the maximum speed the robot can move at. 127 by default
+ * @param async whether the function should be run asynchronously. true by default
+ */
+void lemlib::Chassis::moveToPoint(float x, float y, int timeout, bool forwards, float maxSpeed, bool async) {
+    MotionCommand command;
+    command.type = MotionType::MOVE_TO_POINT;
+    command.x = x;
+    command.y = y;
+    command.timeout = timeout;
+    command.forwards = forwards;
+    command.maxSpeed = maxSpeed;
+    queueMotion(command, async);
+}
+
+/**
+ * @brief Run a moveToPoint motion, in the motion task
+ *
+ * @param x x location
+ * @param y y location
+ * @param timeout longest time the robot can spend moving
+ * @param forwards whether the robot should move forwards or backwards
+ * @param maxSpeed the maximum speed the robot can move at
+ */
+void lemlib::Chassis::runMoveToPoint(float x, float y, int timeout, bool forwards, float maxSpeed) {
+
+    // reset PIDs and exit conditions
+    lateralPID.reset();
+    lateralLargeExit.reset();
+    lateralSmallExit.reset();
+    angularPID.reset();
+
+    // initialize vars used between iterations
+    Pose lastPose = getPose(true, true);
+    distTravelled = 0;
+    float travelled = 0; // distance driven forwards along the heading
+    Timer timer(timeout);
+    uint64_t prevCycleTime = pros::micros();
+    StallDetector stall(stallSettings);
+    bool close = false;
+    float prevLateralOut = 0; // previous lateral power
+    float prevAngularOut = 0; // previous angular power
+
+    // calculate target pose in standard form
+    Pose target(x, y);
+    target.theta = lastPose.angle(target);
+    motionLength = lastPose.distance(target);
+
+    // plan the lateral motion, if profiling is on. It can't ask for more than maxSpeed
+    ProfileConstraints constraints = lateralProfile;
+    if (lateralSettings.kV > 0) {
+        constraints.maxVelocity = std::fmin(constraints.maxVelocity, maxSpeed / lateralSettings.kV);
+    }
+    // carry on at the speed the last motion handed over at, if it chained into this one
+    MotionProfile profile(lastPose.distance(target), constraints, chainVelocity);
+    chainVelocity = 0;
+    const float direction = forwards ? 1 : -1;
+    uint32_t start = pros::millis();
+    ChainPlan chain;
+    bool handedOver = false;
+
+    // main loop
+    while (!timer.isDone() && !lateralSmallExit.getExit() && !lateralLargeExit.getExit() && this->motionRunning) {
+        // update position
+        const Pose pose = getPose(true, true);
+        // time since the last update, for the PIDs
+        const uint64_t cycleTime = pros::micros();
+        const float dt = (cycleTime - prevCycleTime) / 1000000.0;
+        prevCycleTime = cycleTime;
+
+        // update distance travelled
+        distTravelled += pose.distance(lastPose);
+        notifyProgress();
+        // driving forwards shrinks the lateral error by as much, so it is the measurement for derivative on measurement
+        travelled += (pose.x - lastPose.x) * cos(pose.theta) + (pose.y - lastPose.y) * sin(pose.theta);
+        // give up if the robot is stuck against something
+        if (checkStall(stall)) break;
+        lastPose = pose;
+
+        // calculate distance to the target point
+        const float distTarget = pose.distance(target);
+
+        // once the next motion is queued, replan the rest of the profile to hand over to it at the speed the corner
+        // allows, short of the target
+        if (!chain.chain && !close) {
+            chain = planChain(target, forwards);
+            if (chain.chain) {
+                const float speed = fabs(profile.sample((pros::millis() - start) / 1000.0).velocity);
+                profile = MotionProfile(std::fmax(distTarget - chainSettings.exitDistance, 0), constraints, speed,
+                                        chain.exitVelocity);
+                start = pros::millis();
+            }
+        }
+        // hand over once the robot is within the exit distance of the target, or has driven past it nearby
+        const float heading = forwards ? pose.theta : pose.theta + M_PI;
+        const float along = (target.x - pose.x) * cos(heading) + (target.y - pose.y) * sin(heading);
+        const bool passed = along < 0 && distTarget < 2 * chainSettings.exitDistance;
+        if (chain.chain && (distTarget < chainSettings.exitDistance || passed) && hasQueuedMotion()) {
+            chainVelocity = fabs(profile.sample((pros::millis() - start) / 1000.0).velocity);
+            handedOver = true;
+            break;
+        }
+
+        // check if the robot is close enough to the target to start settling
+        if (distTarget < 7.5 && close == false && !chain.chain) {
+            close = true;
+            maxSpeed = fmax(fabs(prevLateralOut), 60);
+        }
+
+        // round the corner into the next motion by aiming past the target, towards it
+        Pose aim = target;
+        if (chain.chain) {
+            const float exitDistance = chainSettings.exitDistance;
+            const float blend = std::clamp(2 * exitDistance - distTarget, 0.0f, exitDistance);
+            aim = target + Pose(cos(chain.direction), sin(chain.direction)) * blend;
+        }
+
+        // calculate error
+        const float adjustedRobotTheta = forwards ? pose.theta : pose.theta + M_PI;
+        const float angularError = angleError(adjustedRobotTheta, pose.angle(aim));
+        float lateralError = pose.distance(target) * cos(angleError(pose.theta, pose.angle(target)));
+
+        // update exit conditions
+        const float lateralVelocity = state.read().localSpeed.y;
+        lateralSmallExit.update(lateralError, lateralVelocity);
+        lateralLargeExit.update(lateralError, lateralVelocity);
+
+        // pick the gains for how far off the robot is
+        scheduleGains(lateralError, radToDeg(angularError));
+
+        // get output from PIDs. While the profile runs, the lateral PID only corrects for being behind or ahead of it.
+        // A chained motion keeps to the end of its profile, exitDistance short of the target, until it hands over
+        const float elapsed = (pros::millis() - start) / 1000.0;
+        const bool profiled = elapsed < profile.getDuration() || chain.chain;
+        float lateralOut;
+        if (profiled) {
+            const ProfileState setpoint = profile.sample(elapsed);
+            const float remaining =
+                profile.getDistance() - setpoint.position + (chain.chain ? chainSettings.exitDistance : 0);
+            // static friction only needs overcoming while the profile moves, not while it holds still on target
+            const float friction = setpoint.velocity == 0 ? 0 : lateralKS * sgn(setpoint.velocity);
+            const float feedforward =
+                friction + lateralSettings.kV * setpoint.velocity + lateralSettings.kA * setpoint.acceleration;
+            const float profileError = lateralError - direction * remaining;
+            lateralOut = direction * feedforward + lateralPID.update(profileError, dt, travelled);
+        } else {
+            lateralOut = lateralPID.update(lateralError, dt, travelled);
+        }
+        // the angular error is the heading minus the target
+        float angularOut = angularPID.update(radToDeg(angularError), dt, -radToDeg(pose.theta));
+        if (close) angularOut = 0;
+
+        // apply restrictions on angular speed
+        angularOut = std::clamp(angularOut, -maxSpeed, maxSpeed);
+        angularOut = slew(angularOut, prevAngularOut, angularSettings.slew);
+
+        // apply restrictions on lateral speed
+        lateralOut = std::clamp(lateralOut, -maxSpeed, maxSpeed);
+        // constrain lateral output by max accel
+        // but not for decelerating, since that would interfere with settling, or when the profile limits it
+        if (!close && !profiled) lateralOut = slew(lateralOut, prevLateralOut, lateralSettings.slew);
+
+        // prevent moving in the wrong direction
+        if (forwards && !close) lateralOut = std::fmax(lateralOut, 0);
+        else if (!forwards && !close) lateralOut = std::fmin(lateralOut, 0);
+
+        // update previous output
+        prevAngularOut = angularOut;
+        prevLateralOut = lateralOut;
+
+        // ratio the speeds to respect the max speed
+        float leftPower = lateralOut + angularOut;
+        float rightPower = lateralOut - angularOut;
+        const float ratio = std::max(std::fabs(leftPower), std::fabs(rightPower)) / maxSpeed;
+        if (ratio > 1) {
+            leftPower /= ratio;
+            rightPower /= ratio;
+        }
+
+        // move the drivetrain
+        moveVoltage(leftPower, rightPower);
+
+        // delay to save resources
+        pros::delay(10);
+    }
+
+    // count how long the exit countdowns would have kept the robot here
+    if (lateralLargeExit.getExit() || lateralSmallExit.getExit()) {
+        recordSettle(firstCountdownEnd(lateralLargeExit, lateralSmallExit));
+    }
+
+    // stop the drivetrain, unless the next motion carries on from here
+    if (!handedOver) {
+        drivetrain.leftMotors->move(0);
+        drivetrain.rightMotors->move(0);
+    }
+    // set distTraveled to -1 to indicate that the function has finished
+    distTravelled = -1;
+}
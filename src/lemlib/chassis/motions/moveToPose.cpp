@@ -0,0 +1,264 @@
+#include <cmath>
+#include <algorithm>
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+
+/**
+ * @brief Move the chassis towards the target pose
+ *
+ * Uses the boomerang controller
+ *
+ * @param x x location
+ * @param y y location
+ * @param theta target heading in degrees.
+ * @param timeout longest time the robot can spend moving
+ * @param params struct to simulate named parameters
+ * @param async whether the function should be run asynchronously. true by default
+ */
+void lemlib::Chassis::moveToPose(float x, float y, float theta, int timeout, MoveToPoseParams params, bool async) {
+    MotionCommand command;
+    command.type = MotionType::MOVE_TO_POSE;
+    command.x = x;
+    command.y = y;
+    command.theta = theta;
+    command.timeout = timeout;
+    command.forwards = params.forwards;
+    command.maxSpeed = params.maxSpeed;
+    command.params = params;
+    queueMotion(command, async);
+}
+
+/**
+ * @brief Run a moveToPose motion, in the motion task
+ *
+ * @param x x location
+ * @param y y location
+ * @param theta target heading in degrees.
+ * @param timeout longest time the robot can spend moving
+ * @param params struct to simulate named parameters
+ */
+void lemlib::Chassis::runMoveToPose(float x, float y, float theta, int timeout, MoveToPoseParams params) {
+    // calculate target pose in standard form
+    Pose target(x, y, M_PI_2 - degToRad(theta));
+    if (!params.forwards) target.theta = fmod(target.theta + M_PI, 2 * M_PI); // backwards movement
+
+    // reset PIDs and exit conditions
+    lateralPID.reset();
+    lateralLargeExit.reset();
+    lateralSmallExit.reset();
+    angularPID.reset();
+    angularLargeExit.reset();
+    angularSmallExit.reset();
+
+    // use global chasePower is chasePower is 0
+    if (params.chasePower == 0) params.chasePower = drivetrain.chasePower;
+
+    // initialize vars used between iterations
+    Pose lastPose = getPose(true, true);
+    distTravelled = 0;
+    float travelled = 0; // distance driven forwards along the heading
+
+    // plan the lateral motion, if profiling is on. The boomerang path stays inside the triangle between the start,
+    // the first carrot point and the target, so the length of its two sides is a slight overestimate of the path
+    const float startDistance = lastPose.distance(target);
+    const Pose firstCarrot = target - Pose(cos(target.theta), sin(target.theta)) * params.lead * startDistance;
+    float pathLength = lastPose.distance(firstCarrot) + firstCarrot.distance(target);
+    const float lengthRatio = startDistance > 0 ? pathLength / startDistance : 1;
+    motionLength = pathLength;
+    ProfileConstraints constraints = lateralProfile;
+    if (lateralSettings.kV > 0) {
+        constraints.maxVelocity = std::fmin(constraints.maxVelocity, params.maxSpeed / lateralSettings.kV);
+    }
+    // carry on at the speed the last motion handed over at, if it chained into this one
+    MotionProfile profile(pathLength, constraints, chainVelocity);
+    chainVelocity = 0;
+    const float direction = params.forwards ? 1 : -1;
+    uint32_t start = pros::millis();
+    ChainPlan chain;
+    bool handedOver = false;
+
+    Timer timer(timeout);
+    uint64_t prevCycleTime = pros::micros();
+    StallDetector stall(stallSettings);
+    bool close = false;
+    bool lateralSettled = false;
+    bool prevSameSide = false;
+    float prevLateralOut = 0; // previous lateral power
+
+    // main loop
+    while (!timer.isDone() &&
+           ((!lateralSettled || (!angularLargeExit.getExit() && !angularSmallExit.getExit())) || !close) &&
+           this->motionRunning) {
+        // update position
+        const Pose pose = getPose(true, true);
+        // time since the last update, for the PIDs
+        const uint64_t cycleTime = pros::micros();
+        const float dt = (cycleTime - prevCycleTime) / 1000000.0;
+        prevCycleTime = cycleTime;
+
+        // update distance travelled
+        distTravelled += pose.distance(lastPose);
+        notifyProgress();
+        // driving forwards shrinks the lateral error by as much, so it is the measurement for derivative on measurement
+        travelled += (pose.x - lastPose.x) * cos(pose.theta) + (pose.y - lastPose.y) * sin(pose.theta);
+        // give up if the robot is stuck against something
+        if (checkStall(stall)) break;
+        lastPose = pose;
+
+        // calculate distance to the target point
+        const float distTarget = pose.distance(target);
+
+        // once the next motion is queued, replan the rest of the profile to hand over to it at the speed the corner
+        // allows, short of the target
+        if (!chain.chain && !close) {
+            chain = planChain(target, params.forwards);
+            if (chain.chain) {
+                const float speed = fabs(profile.sample((pros::millis() - start) / 1000.0).velocity);
+                pathLength = std::fmax(distTarget * lengthRatio - chainSettings.exitDistance, 0);
+                profile = MotionProfile(pathLength, constraints, speed, chain.exitVelocity);
+                start = pros::millis();
+            }
+        }
+        // hand over once the robot is within the exit distance of the target, or has driven past it nearby
+        const float heading = params.forwards ? pose.theta : pose.theta + M_PI;
+        const float along = (target.x - pose.x) * cos(heading) + (target.y - pose.y) * sin(heading);
+        const bool passed = along < 0 && distTarget < 2 * chainSettings.exitDistance;
+        if (chain.chain && (distTarget < chainSettings.exitDistance || passed) && hasQueuedMotion()) {
+            chainVelocity = fabs(profile.sample((pros::millis() - start) / 1000.0).velocity);
+            handedOver = true;
+            break;
+        }
+
+        // check if the robot is close enough to the target to start settling
+        if (distTarget < 7.5 && close == false && !chain.chain) {
+            close = true;
+            params.maxSpeed = fmax(fabs(prevLateralOut), 60);
+        }
+
+        // check if the lateral controller has settled, or has stopped on target
+        if ((lateralLargeExit.getExit() && lateralSmallExit.getExit()) || lateralSmallExit.getSaved() > 0) {
+            lateralSettled = true;
+        }
+
+        // calculate the carrot point
+        Pose carrot = target - Pose(cos(target.theta), sin(target.theta)) * params.lead * distTarget;
+        if (close) carrot = target; // settling behavior
+        // round the corner into the next motion by bending the carrot towards it
+        if (chain.chain) {
+            const float exitDistance = chainSettings.exitDistance;
+            const float blend = std::clamp(2 * exitDistance - distTarget, 0.0f, exitDistance);
+            carrot = carrot + Pose(cos(chain.direction), sin(chain.direction)) * blend;
+        }
+
+        // calculate if the robot is on the same side as the carrot point
+        const bool robotSide =
+            (pose.y - target.y) * -sin(target.theta) <= (pose.x - target.x) * cos(target.theta) + params.earlyExitRange;
+        const bool carrotSide = (carrot.y - target.y) * -sin(target.theta) <=
+                                (carrot.x - target.x) * cos(target.theta) + params.earlyExitRange;
+        const bool sameSide = robotSide == carrotSide;
+        // exit if close
+        if (!sameSide && prevSameSide && close && params.minSpeed != 0) break;
+        prevSameSide = sameSide;
+
+        // calculate error
+        const float adjustedRobotTheta = params.forwards ? pose.theta : pose.theta + M_PI;
+        const float angularError =
+            close ? angleError(adjustedRobotTheta, target.theta) : angleError(adjustedRobotTheta, pose.angle(carrot));
+        float lateralError = pose.distance(carrot);
+        // only use cos when settling
+        // otherwise just multiply by the sign of cos
+        // maxSlipSpeed takes care of lateralOut
+        if (close) lateralError *= cos(angleError(pose.theta, pose.angle(carrot)));
+        else lateralError *= sgn(cos(angleError(pose.theta, pose.angle(carrot))));
+
+        // update exit conditions
+        const Pose velocity = state.read().localSpeed;
+        lateralSmallExit.update(lateralError, velocity.y);
+        lateralLargeExit.update(lateralError, velocity.y);
+        angularSmallExit.update(radToDeg(angularError), radToDeg(velocity.theta));
+        angularLargeExit.update(radToDeg(angularError), radToDeg(velocity.theta));
+
+        // pick the gains for how far off the robot is
+        scheduleGains(lateralError, radToDeg(angularError));
+
+        // get output from PIDs. While the profile runs, the lateral PID only corrects for being behind or ahead of
+        // it, judged by how much of the path is left compared to how much the profile has left. A chained motion keeps
+        // to the end of its profile until it hands over
+        const float elapsed = (pros::millis() - start) / 1000.0;
+        const bool profiled = elapsed < profile.getDuration() || chain.chain;
+        float lateralOut;
+        if (profiled) {
+            const ProfileState setpoint = profile.sample(elapsed);
+            const float remaining = pathLength - setpoint.position;
+            const float pathRemaining = distTarget * lengthRatio - (chain.chain ? chainSettings.exitDistance : 0);
+            const float behind = pathRemaining > 0 ? 1 - remaining / pathRemaining : 0;
+            // static friction only needs overcoming while the profile moves, not while it holds still on target
+            const float friction = setpoint.velocity == 0 ? 0 : lateralKS * sgn(setpoint.velocity);
+            const float feedforward =
+                friction + lateralSettings.kV * setpoint.velocity + lateralSettings.kA * setpoint.acceleration;
+            lateralOut = direction * feedforward + lateralPID.update(lateralError * behind, dt, travelled);
+        } else {
+            lateralOut = lateralPID.update(lateralError, dt, travelled);
+        }
+        // the angular error is the heading minus the target
+        float angularOut = angularPID.update(radToDeg(angularError), dt, -radToDeg(pose.theta));
+
+        // apply restrictions on angular speed
+        angularOut = std::clamp(angularOut, -params.maxSpeed, params.maxSpeed);
+
+        // apply restrictions on lateral speed
+        lateralOut = std::clamp(lateralOut, -params.maxSpeed, params.maxSpeed);
+        // constrain lateral output by max accel, unless the profile already does
+        if (!close && !profiled) lateralOut = slew(lateralOut, prevLateralOut, lateralSettings.slew);
+
+        // constrain lateral output by the max speed it can travel at without slipping
+        const float radius = 1 / fabs(getCurvature(pose, carrot));
+        const float maxSlipSpeed(sqrt(params.chasePower * radius * 9.8));
+        lateralOut = std::clamp(lateralOut, -maxSlipSpeed, maxSlipSpeed);
+        // prioritize angular movement over lateral movement
+        const float overturn = fabs(angularOut) + fabs(lateralOut) - params.maxSpeed;
+        if (overturn > 0) lateralOut -= lateralOut > 0 ? overturn : -overturn;
+
+        // prevent moving in the wrong direction
+        if (params.forwards && !close) lateralOut = std::fmax(lateralOut, 0);
+        else if (!params.forwards && !close) lateralOut = std::fmin(lateralOut, 0);
+
+        // constrain lateral output by the minimum speed
+        if (params.forwards && lateralOut < fabs(params.minSpeed) && lateralOut > 0) lateralOut = fabs(params.minSpeed);
+        if (!params.forwards && -lateralOut < fabs(params.minSpeed) && lateralOut < 0)
+            lateralOut = -fabs(params.minSpeed);
+
+        // update previous output
+        prevLateralOut = lateralOut;
+
+        // ratio the speeds to respect the max speed
+        float leftPower = lateralOut + angularOut;
+        float rightPower = lateralOut - angularOut;
+        const float ratio = std::max(std::fabs(leftPower), std::fabs(rightPower)) / params.maxSpeed;
+        if (ratio > 1) {
+            leftPower /= ratio;
+            rightPower /= ratio;
+        }
+
+        // move the drivetrain
+        moveVoltage(leftPower, rightPower);
+
+        // delay to save resources
+        pros::delay(10);
+    }
+
+    // count how long the exit countdowns would have kept the robot here. Both lateral ones have to finish
+    if (lateralSettled && close && (angularLargeExit.getExit() || angularSmallExit.getExit())) {
+        recordSettle(std::max({lateralLargeExit.getCountdownEnd(), lateralSmallExit.getCountdownEnd(),
+                               firstCountdownEnd(angularLargeExit, angularSmallExit)}));
+    }
+
+    // stop the drivetrain, unless the next motion carries on from here
+    if (!handedOver) {
+        drivetrain.leftMotors->move(0);
+        drivetrain.rightMotors->move(0);
+    }
+    // set distTraveled to -1 to indicate that the function has finished
+    distTravelled = -1;
+}
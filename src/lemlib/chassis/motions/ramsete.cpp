@@ -0,0 +1,102 @@
+#include <cmath>
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+
+/**
+ * @brief Track a planned trajectory in time with RAMSETE, for follow
+ *
+ * Runs the rest of the follow motion
+ *
+ * @param trajectory the trajectory
+ * @param timeout the maximum time the robot can spend moving
+ * @param forwards whether the robot should follow the path going forwards
+ * @param kV motor power per inch per second
+ */
+void lemlib::Chassis::ramsete(const Trajectory& trajectory, int timeout, bool forwards, float kV) {
+    const float b = ramseteSettings.b;
+    const float zeta = ramseteSettings.zeta;
+    const float halfTrack = drivetrain.trackWidth / 2;
+    Pose lastPose = getPose(true, true);
+    distTravelled = 0;
+    motionLength = trajectory.size() > 0 ? trajectory.at(trajectory.size() - 1).distance : 0;
+    Timer timer(timeout);
+    StallDetector stall(stallSettings);
+    const uint32_t start = pros::millis();
+
+    // the trajectory ends at rest, so there is nothing left to track once its time is up
+    while (!timer.isDone() && this->motionRunning) {
+        const float elapsed = (pros::millis() - start) / 1000.0;
+        if (elapsed > trajectory.getDuration()) break;
+
+        // get the current position of the robot. Backwards, the back of the robot tracks the path
+        Pose pose = getPose(true, true);
+        distTravelled += pose.distance(lastPose);
+        notifyProgress();
+        // give up if the robot is stuck against something
+        if (checkStall(stall)) break;
+        lastPose = pose;
+        if (!forwards) pose.theta += M_PI;
+
+        // where the robot should be by the time the motors respond
+        const TrajectoryPoint target = trajectory.sample(elapsed + 0.01);
+        const float targetAngular = target.velocity * target.curvature;
+
+        // error in the frame of the robot
+        const float dx = target.x - pose.x;
+        const float dy = target.y - pose.y;
+        const float errorX = std::cos(pose.theta) * dx + std::sin(pose.theta) * dy;
+        const float errorY = -std::sin(pose.theta) * dx + std::cos(pose.theta) * dy;
+        const float errorTheta = angleError(target.theta, pose.theta);
+        const float sinc = std::fabs(errorTheta) < 1e-4 ? 1 : std::sin(errorTheta) / errorTheta;
+
+        // RAMSETE: track the reference velocities, steering back onto the trajectory with a gain that grows with
+        // speed
+        const float gain = 2 * zeta * std::sqrt(targetAngular * targetAngular + b * target.velocity * target.velocity);
+        const float linear = target.velocity * std::cos(errorTheta) + gain * errorX;
+        const float angular = targetAngular + gain * errorTheta + b * target.velocity * sinc * errorY;
+
+        // wheel velocities. Positive angular velocity turns left
+        const float leftVelocity = linear - angular * halfTrack;
+        const float rightVelocity = linear + angular * halfTrack;
+        const float leftAcceleration = target.acceleration * (1 - target.curvature * halfTrack);
+        const float rightAcceleration = target.acceleration * (1 + target.curvature * halfTrack);
+
+        // measured wheel velocities, to make up for what the feedforward misses, like the wheels scrubbing in turns
+        const Pose speed = getState().localSpeed;
+        const float measuredLinear = forwards ? speed.y : -speed.y;
+        const float measuredAngular = -speed.theta;
+        const float measuredLeft = measuredLinear - measuredAngular * halfTrack;
+        const float measuredRight = measuredLinear + measuredAngular * halfTrack;
+
+        // motor power from the feedforward, plus feedback on the wheel velocities. Friction only needs overcoming
+        // while a wheel should be turning
+        auto friction = [this](float velocity) { return velocity == 0 ? 0 : lateralSettings.kS * sgn(velocity); };
+        float leftPower = friction(leftVelocity) + kV * leftVelocity + lateralSettings.kA * leftAcceleration +
+                          ramseteSettings.kP * (leftVelocity - measuredLeft);
+        float rightPower = friction(rightVelocity) + kV * rightVelocity + lateralSettings.kA * rightAcceleration +
+                           ramseteSettings.kP * (rightVelocity - measuredRight);
+
+        // ratio the speeds to respect the max speed
+        const float ratio = std::max(std::fabs(leftPower), std::fabs(rightPower)) / 127;
+        if (ratio > 1) {
+            leftPower /= ratio;
+            rightPower /= ratio;
+        }
+
+        // move the drivetrain
+        if (forwards) {
+            moveVoltage(leftPower, rightPower);
+        } else {
+            moveVoltage(-rightPower, -leftPower);
+        }
+
+        pros::delay(10);
+    }
+
+    // stop the robot
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    // set distTravelled to -1 to indicate that the function has finished
+    distTravelled = -1;
+}
@@ -0,0 +1,108 @@
+#include <cmath>
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+
+/**
+ * @brief Turn the chassis so it is facing the target point
+ *
+ * The PID logging id is "angularPID"
+ *
+ * @param x x location
+ * @param y y location
+ * @param timeout longest time the robot can spend moving
+ * @param forwards whether the robot should turn to face the point with the front of the robot. true by default
+ * @param maxSpeed the maximum speed the robot can turn at. Default is 127
+ * @param async whether the function should be run asynchronously. true by default
+ */
+void lemlib::Chassis::turnTo(float x, float y, int timeout, bool forwards, float maxSpeed, bool async) {
+    MotionCommand command;
+    command.type = MotionType::TURN_TO;
+    command.x = x;
+    command.y = y;
+    command.timeout = timeout;
+    command.forwards = forwards;
+    command.maxSpeed = maxSpeed;
+    queueMotion(command, async);
+}
+
+/**
+ * @brief Run a turnTo motion, in the motion task
+ *
+ * @param x x location
+ * @param y y location
+ * @param timeout longest time the robot can spend moving
+ * @param forwards whether the robot should turn to face the point with the front of the robot
+ * @param maxSpeed the maximum speed the robot can turn at
+ */
+void lemlib::Chassis::runTurnTo(float x, float y, int timeout, bool forwards, float maxSpeed) {
+    float targetTheta;
+    float deltaX, deltaY, deltaTheta;
+    float motorPower;
+    float prevMotorPower = 0;
+    const Pose startPose = getPose();
+    // measured the same way as the heading in the loop, so a backwards turn starts at 0
+    const float startTheta = (forwards) ? fmod(startPose.theta, 360) : fmod(startPose.theta - 180, 360);
+    distTravelled = 0;
+    motionLength = fabs(angleError(radToDeg(M_PI_2 - atan2(y - startPose.y, x - startPose.x)), startTheta, false));
+    Timer timer(timeout);
+    angularLargeExit.reset();
+    angularSmallExit.reset();
+    angularPID.reset();
+    uint64_t prevCycleTime = pros::micros();
+
+    // main loop
+    while (!timer.isDone() && !angularLargeExit.getExit() && !angularSmallExit.getExit() && this->motionRunning) {
+        // update variables
+        Pose pose = getPose();
+        const float heading = pose.theta;
+        pose.theta = (forwards) ? fmod(pose.theta, 360) : fmod(pose.theta - 180, 360);
+
+        // update completion vars
+        distTravelled = fabs(angleError(pose.theta, startTheta, false));
+        notifyProgress();
+
+        deltaX = x - pose.x;
+        deltaY = y - pose.y;
+        targetTheta = fmod(radToDeg(M_PI_2 - atan2(deltaY, deltaX)), 360);
+
+        // calculate deltaTheta
+        deltaTheta = angleError(targetTheta, pose.theta, false);
+
+        // time since the last update, for the PIDs
+        const uint64_t cycleTime = pros::micros();
+        const float dt = (cycleTime - prevCycleTime) / 1000000.0;
+        prevCycleTime = cycleTime;
+
+        // calculate the speed
+        scheduleGains(0, deltaTheta);
+        motorPower = angularPID.update(deltaTheta, dt, heading);
+        const float angularVelocity = radToDeg(state.read().localSpeed.theta);
+        angularLargeExit.update(deltaTheta, angularVelocity);
+        angularSmallExit.update(deltaTheta, angularVelocity);
+        // overcome wheel scrub until the robot is close enough, so the turn doesn't stall short of it
+        if (fabs(deltaTheta) > angularSettings.smallError) motorPower += angularKS * sgn(motorPower);
+
+        // cap the speed
+        if (motorPower > maxSpeed) motorPower = maxSpeed;
+        else if (motorPower < -maxSpeed) motorPower = -maxSpeed;
+        if (fabs(deltaTheta) > 20) motorPower = slew(motorPower, prevMotorPower, angularSettings.slew);
+        prevMotorPower = motorPower;
+
+        // move the drivetrain
+        moveVoltage(motorPower, -motorPower);
+
+        pros::delay(10);
+    }
+
+    // count how long the exit countdowns would have kept the robot here
+    if (angularLargeExit.getExit() || angularSmallExit.getExit()) {
+        recordSettle(firstCountdownEnd(angularLargeExit, angularSmallExit));
+    }
+
+    // stop the drivetrain
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    // set distTraveled to -1 to indicate that the function has finished
+    distTravelled = -1;
+}
@@ -0,0 +1,604 @@
+/**
+ * @file src/lemlib/chassis/odom.cpp
+ * @author LemLib Team
+ * @brief This is the source file for the odometry system
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// The implementation below is mostly based off of
+// the document written by 5225A (Pilons)
+// Here is a link to the original document
+// http://thepilons.ca/wp-content/uploads/2018/10/Tracking.pdf
+
+#include <math.h>
+#include <cmath>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include "pros/rtos.hpp"
+#include "lemlib/util.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/chassis/poseHistory.hpp"
+#include "lemlib/chassis/ekf.hpp"
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/trackingWheel.hpp"
+
+// tracking thread
+pros::Task* trackingTask = nullptr;
+
+// global variables
+lemlib::OdomSensors odomSensors(nullptr, nullptr, nullptr, nullptr, nullptr); // the sensors to be used for odometry
+lemlib::Drivetrain drive(nullptr, nullptr, 0, 0, 0, 0); // the drivetrain to be used for odometry
+lemlib::Pose odomPose(0, 0, 0); // the pose of the robot
+lemlib::Pose odomSpeed(0, 0, 0); // the speed of the robot
+lemlib::Pose odomLocalSpeed(0, 0, 0); // the local speed of the robot
+float odomGroundSpeed = 0; // forward speed of the robot from the IMU, in inches per second
+float odomGroundBias = 0; // forward acceleration the IMU reads standing still, in g
+uint64_t prevGroundTime = 0; // time the ground speed was last updated, in microseconds
+constexpr float GRAVITY = 386.09; // in inches per second squared
+constexpr float GROUND_DRIFT_TIME = 1; // how long the ground speed takes to be pulled back to the wheels, in seconds
+constexpr float GROUND_BIAS_TIME = 2; // how long the bias takes to settle while standing still, in seconds
+constexpr float MAX_GROUND_BIAS = 0.1; // largest acceleration put down to tilt or bias, in g
+constexpr float STILL_SPEED = 0.5; // wheels below this count as standing still, in inches per second
+constexpr float STILL_TURN_RATE = 0.1; // and below this, in radians per second
+
+float prevVertical = 0;
+float prevVertical1 = 0;
+float prevVertical2 = 0;
+float prevHorizontal = 0;
+float prevHorizontal1 = 0;
+float prevHorizontal2 = 0;
+float prevImu = 0;
+
+// time of the sensor samples used by the last update, and of the last update that changed the speed
+uint32_t prevSampleTime = 0;
+uint32_t prevSpeedTime = 0;
+lemlib::Pose prevSpeedPose(0, 0, 0);
+// local motion since the speed was last updated
+lemlib::Pose pendingLocal(0, 0, 0);
+
+// poses from the last 1.28 seconds at 200 Hz, in radians
+lemlib::PoseHistory<256> poseHistory;
+// set by setPose, so the tracking thread clears the history. Only the task adding poses may clear it
+std::atomic<bool> historyReset {false};
+
+// corrections waiting for the tracking thread. They're only added under the mutex, and the tracking thread only
+// applies them if it can take the mutex without waiting
+struct Correction {
+        uint32_t time;
+        float x;
+        float y;
+        float theta;
+};
+
+pros::Mutex correctionMutex;
+std::array<Correction, 8> corrections;
+size_t correctionCount = 0;
+uint32_t poseSetTime = 0; // measurements from before the pose was last set no longer apply
+
+// pose estimator used instead of dead reckoning, if enabled
+bool ekfEnabled = false;
+lemlib::Ekf ekf;
+pros::Gps* ekfGps = nullptr;
+bool ekfStarted = false;
+uint64_t prevEkfTime = 0; // time of the last prediction, in microseconds
+lemlib::Pose ekfPose(0, 0, 0); // pose the filter last output, to notice when something else moves the robot
+float imuOffset = 0; // heading minus IMU rotation, in radians
+float prevGpsX = 0;
+float prevGpsY = 0;
+
+// previous reading of each tracking wheel, to turn distances into velocities
+struct WheelReading {
+        float distance;
+        uint32_t time;
+};
+
+std::array<WheelReading, 4> ekfWheels {};
+
+uint32_t updatePeriod = 10; // time between odom updates, in ms
+lemlib::OdomStats odomStats; // timing of the tracking thread
+uint64_t totalJitter = 0; // sum of the jitter of every update, in microseconds
+
+/**
+ * @brief Set the sensors to be used for odometry
+ *
+ * @param sensors the sensors to be used
+ * @param drivetrain drivetrain to be used
+ */
+void lemlib::setSensors(lemlib::OdomSensors sensors, lemlib::Drivetrain drivetrain) {
+    odomSensors = sensors;
+    drive = drivetrain;
+}
+
+/**
+ * @brief Have the sensors take a new sample every update
+ *
+ */
+static void setDataRates() {
+    if (odomSensors.imu != nullptr) odomSensors.imu->set_data_rate(updatePeriod);
+    for (lemlib::TrackingWheel* wheel :
+         {odomSensors.vertical1, odomSensors.vertical2, odomSensors.horizontal1, odomSensors.horizontal2}) {
+        if (wheel != nullptr) wheel->setDataRate(updatePeriod);
+    }
+}
+
+/**
+ * @brief Set how often odometry updates
+ *
+ * @param period time between updates, in ms. 10 by default
+ */
+void lemlib::setUpdatePeriod(uint32_t period) {
+    updatePeriod = std::max<uint32_t>(period, 1);
+    setDataRates();
+    resetStats();
+}
+
+/**
+ * @brief Estimate the pose with an extended Kalman filter instead of dead reckoning
+ *
+ * @param settings tuning for the filter
+ * @param gps GPS sensor to correct the position with. nullptr if there isn't one
+ */
+void lemlib::useEkf(EkfSettings settings, pros::Gps* gps) {
+    ekf = Ekf(settings);
+    ekfGps = gps;
+    ekfStarted = false;
+    ekfEnabled = true;
+}
+
+/**
+ * @brief Get the timing of the odometry loop
+ *
+ * @return OdomStats
+ */
+lemlib::OdomStats lemlib::getStats() {
+    OdomStats stats = odomStats;
+    stats.period = updatePeriod;
+    if (stats.updates != 0) stats.meanJitter = float(totalJitter) / stats.updates;
+    return stats;
+}
+
+/**
+ * @brief Reset the timing stats of the odometry loop
+ *
+ */
+void lemlib::resetStats() {
+    odomStats = OdomStats();
+    totalJitter = 0;
+}
+
+/**
+ * @brief Get the pose of the robot
+ *
+ * @param radians true for theta in radians, false for degrees. False by default
+ * @return Pose
+ */
+lemlib::Pose lemlib::getPose(bool radians) {
+    if (radians) return odomPose;
+    else return lemlib::Pose(odomPose.x, odomPose.y, radToDeg(odomPose.theta));
+}
+
+/**
+ * @brief Set the Pose of the robot
+ *
+ * @param pose the new pose
+ * @param radians true if theta is in radians, false if in degrees. False by default
+ */
+void lemlib::setPose(lemlib::Pose pose, bool radians) {
+    if (radians) odomPose = pose;
+    else odomPose = lemlib::Pose(pose.x, pose.y, degToRad(pose.theta));
+    // a jump in pose isn't motion
+    prevSpeedPose = odomPose;
+    historyReset.store(true);
+    correctionMutex.take();
+    correctionCount = 0;
+    poseSetTime = pros::millis();
+    correctionMutex.give();
+}
+
+/**
+ * @brief Get the pose the robot was at at a given time
+ *
+ * @param time the time, in ms since the program started
+ * @param radians true for theta in radians, false for degrees. False by default
+ * @return Pose
+ */
+lemlib::Pose lemlib::getPoseAt(uint32_t time, bool radians) {
+    Pose pose = odomPose;
+    poseHistory.poseAt(time, pose);
+    if (!radians) pose.theta = radToDeg(pose.theta);
+    return pose;
+}
+
+/**
+ * @brief Correct the pose of the robot with a measurement taken in the past
+ *
+ * @param time the time the measurement was taken, in ms since the program started
+ * @param pose the measured pose
+ * @param radians true if theta is in radians, false if in degrees. False by default
+ */
+void lemlib::correctPose(uint32_t time, Pose pose, bool radians) {
+    const Correction correction = {time, pose.x, pose.y, radians ? pose.theta : degToRad(pose.theta)};
+    correctionMutex.take();
+    if (time < poseSetTime) {
+        correctionMutex.give();
+        return;
+    }
+    // if the tracking thread has fallen behind, the newest measurement wins
+    if (correctionCount == corrections.size()) correctionCount--;
+    corrections[correctionCount++] = correction;
+    correctionMutex.give();
+}
+
+/**
+ * @brief Apply the corrections that have been measured since the last update, after clearing the history if the pose
+ * was set
+ *
+ */
+static void applyCorrections() {
+    if (historyReset.exchange(false)) poseHistory.clear();
+    if (!correctionMutex.take(0)) return;
+    for (size_t i = 0; i < correctionCount; i++) {
+        const Correction& correction = corrections[i];
+        lemlib::Pose then = odomPose;
+        poseHistory.poseAt(correction.time, then);
+        const lemlib::Pose delta(correction.x - then.x, correction.y - then.y, correction.theta - then.theta);
+        odomPose = odomPose + delta;
+        prevSpeedPose = prevSpeedPose + delta;
+        // later corrections are compared against the corrected history
+        poseHistory.shift(correction.time, delta);
+    }
+    correctionCount = 0;
+    correctionMutex.give();
+}
+
+/**
+ * @brief Get the speed of the robot
+ *
+ * @param radians true for theta in radians, false for degrees. False by default
+ * @return lemlib::Pose
+ */
+lemlib::Pose lemlib::getSpeed(bool radians) {
+    if (radians) return odomSpeed;
+    else return lemlib::Pose(odomSpeed.x, odomSpeed.y, radToDeg(odomSpeed.theta));
+}
+
+/**
+ * @brief Get the local speed of the robot
+ *
+ * @param radians true for theta in radians, false for degrees. False by default
+ * @return lemlib::Pose
+ */
+lemlib::Pose lemlib::getLocalSpeed(bool radians) {
+    if (radians) return odomLocalSpeed;
+    else return lemlib::Pose(odomLocalSpeed.x, odomLocalSpeed.y, radToDeg(odomLocalSpeed.theta));
+}
+
+/**
+ * @brief Get the forward speed of the robot from the IMU's acceleration, pulled back to the wheels over a second
+ *
+ * @return float speed in inches per second. The wheels' speed without an IMU
+ */
+float lemlib::getGroundSpeed() { return odomGroundSpeed; }
+
+/**
+ * @brief Read the IMU's acceleration towards the front of the robot
+ *
+ * @return float acceleration in g. Infinity without an IMU
+ */
+static float forwardAcceleration() {
+    if (odomSensors.imu == nullptr) return INFINITY;
+    const pros::c::imu_accel_s_t accel = odomSensors.imu->get_accel();
+    switch (odomSensors.imuForward) {
+        case lemlib::ImuAxis::X: return accel.x;
+        case lemlib::ImuAxis::NEGATIVE_X: return -accel.x;
+        case lemlib::ImuAxis::NEGATIVE_Y: return -accel.y;
+        default: return accel.y;
+    }
+}
+
+/**
+ * @brief Integrate the IMU's forward acceleration into the ground speed
+ *
+ */
+static void updateGroundSpeed() {
+    const uint64_t now = pros::micros();
+    const float dt = (now - prevGroundTime) / 1000000.0;
+    prevGroundTime = now;
+    const float acceleration = forwardAcceleration();
+    // without an IMU, or after a gap in the updates, the wheels are all there is
+    if (!std::isfinite(acceleration) || dt > 0.1) {
+        odomGroundSpeed = odomLocalSpeed.y;
+        return;
+    }
+    // standing still, the IMU should read nothing, so what it does read is tilt or bias
+    if (std::fabs(odomLocalSpeed.y) < STILL_SPEED && std::fabs(odomLocalSpeed.theta) < STILL_TURN_RATE &&
+        std::fabs(acceleration) < MAX_GROUND_BIAS) {
+        odomGroundBias += (acceleration - odomGroundBias) * std::fmin(dt / GROUND_BIAS_TIME, 1);
+    }
+    odomGroundSpeed += (acceleration - odomGroundBias) * GRAVITY * dt;
+    // the IMU drifts, so the wheels win out in the end, but slowly enough to still tell when they slip
+    odomGroundSpeed += (odomLocalSpeed.y - odomGroundSpeed) * std::fmin(dt / GROUND_DRIFT_TIME, 1);
+}
+
+/**
+ * @brief Estimate the pose of the robot after a certain amount of time
+ *
+ * @param time time in seconds
+ * @param radians False for degrees, true for radians. False by default
+ * @return lemlib::Pose
+ */
+lemlib::Pose lemlib::estimatePose(float time, bool radians) {
+    // get current position and speed
+    Pose curPose = getPose(true);
+    Pose localSpeed = getLocalSpeed(true);
+    // calculate the change in local position
+    Pose deltaLocalPose = localSpeed * time;
+
+    // calculate the future pose
+    float avgHeading = curPose.theta + deltaLocalPose.theta / 2;
+    Pose futurePose = curPose;
+    futurePose.x += deltaLocalPose.y * sin(avgHeading);
+    futurePose.y += deltaLocalPose.y * cos(avgHeading);
+    futurePose.x += deltaLocalPose.x * -cos(avgHeading);
+    futurePose.y += deltaLocalPose.x * sin(avgHeading);
+    if (!radians) futurePose.theta = radToDeg(futurePose.theta);
+
+    return futurePose;
+}
+
+/**
+ * @brief Update the pose with the filter
+ *
+ */
+static void updateEkf() {
+    const uint64_t now = pros::micros();
+    const lemlib::EkfSettings& settings = ekf.getSettings();
+    pros::Imu* imu = odomSensors.imu;
+    const float imuRaw = imu != nullptr ? lemlib::degToRad(imu->get_rotation()) : 0;
+
+    // setPose or a correction moved the robot, so the filter has to follow
+    if (!ekfStarted || odomPose.x != ekfPose.x || odomPose.y != ekfPose.y || odomPose.theta != ekfPose.theta) {
+        ekf.setPose(odomPose);
+        if (std::isfinite(imuRaw)) imuOffset = odomPose.theta - imuRaw;
+    }
+    if (ekfStarted) ekf.predict((now - prevEkfTime) / 1000000.0);
+    prevEkfTime = now;
+
+    // wheels are only folded in when they have a new sample, as the average velocity since the last one
+    lemlib::TrackingWheel* wheels[] = {odomSensors.vertical1, odomSensors.vertical2, odomSensors.horizontal1,
+                                       odomSensors.horizontal2};
+    for (size_t i = 0; i < 4; i++) {
+        if (wheels[i] == nullptr) continue;
+        uint32_t time = 0;
+        const float distance = wheels[i]->getDistanceTraveled(&time);
+        WheelReading& prev = ekfWheels[i];
+        if (ekfStarted && time != prev.time) {
+            const float dt = (time - prev.time) / 1000.0;
+            const float noise = wheels[i]->getType() ? settings.motorEncoderNoise : settings.trackingWheelNoise;
+            ekf.updateWheel((distance - prev.distance) / dt, wheels[i]->getOffset(), i >= 2, noise);
+            if (odomStats.minDt == 0 || dt < odomStats.minDt) odomStats.minDt = dt;
+            odomStats.maxDt = std::max(odomStats.maxDt, dt);
+        }
+        prev = {distance, time};
+    }
+
+    // the IMU is the best heading reference there is, so it's held to where it was when the pose was last set
+    if (imu != nullptr && std::isfinite(imuRaw)) {
+        ekf.updateHeading(imuRaw + imuOffset, settings.imuHeadingNoise);
+        const float rate = imu->get_gyro_rate().z;
+        if (std::isfinite(rate)) ekf.updateAngularVelocity(lemlib::degToRad(rate), settings.gyroNoise);
+    }
+
+    // the GPS reports in meters from the center of the field
+    if (ekfGps != nullptr) {
+        const float error = ekfGps->get_error() * 39.3701;
+        const pros::c::gps_status_s_t status = ekfGps->get_status();
+        const float x = status.x * 39.3701;
+        const float y = status.y * 39.3701;
+        if (std::isfinite(x) && std::isfinite(error) && error <= settings.gpsMaxError &&
+            (x != prevGpsX || y != prevGpsY)) {
+            // the reported error is never quite zero, and trusting it completely would throw away the wheels
+            ekf.updatePosition(x, y, std::max(error, 0.25f));
+            prevGpsX = x;
+            prevGpsY = y;
+        }
+    }
+
+    ekfStarted = true;
+    odomPose = ekf.getPose();
+    ekfPose = odomPose;
+    odomSpeed = ekf.getSpeed();
+    odomLocalSpeed = ekf.getLocalSpeed();
+    prevSpeedPose = odomPose;
+    poseHistory.push(pros::millis(), odomPose);
+}
+
+/**
+ * @brief Update the pose of the robot
+ *
+ */
+void lemlib::update() {
+    applyCorrections();
+    updateGroundSpeed();
+    if (ekfEnabled) {
+        updateEkf();
+        return;
+    }
+
+    // get the current sensor values
+    float vertical1Raw = 0;
+    float vertical2Raw = 0;
+    float horizontal1Raw = 0;
+    float horizontal2Raw = 0;
+    float imuRaw = 0;
+    // the update is as of the newest sample it uses
+    uint32_t sampleTime = 0;
+    auto read = [&sampleTime](lemlib::TrackingWheel* wheel) {
+        uint32_t timestamp = 0;
+        const float distance = wheel->getDistanceTraveled(&timestamp);
+        sampleTime = std::max(sampleTime, timestamp);
+        return distance;
+    };
+    if (odomSensors.vertical1 != nullptr) vertical1Raw = read(odomSensors.vertical1);
+    if (odomSensors.vertical2 != nullptr) vertical2Raw = read(odomSensors.vertical2);
+    if (odomSensors.horizontal1 != nullptr) horizontal1Raw = read(odomSensors.horizontal1);
+    if (odomSensors.horizontal2 != nullptr) horizontal2Raw = read(odomSensors.horizontal2);
+    if (odomSensors.imu != nullptr) imuRaw = degToRad(odomSensors.imu->get_rotation());
+
+    // calculate the change in sensor values
+    float deltaVertical1 = vertical1Raw - prevVertical1;
+    float deltaVertical2 = vertical2Raw - prevVertical2;
+    float deltaHorizontal1 = horizontal1Raw - prevHorizontal1;
+    float deltaHorizontal2 = horizontal2Raw - prevHorizontal2;
+    float deltaImu = imuRaw - prevImu;
+
+    // update the previous sensor values
+    prevVertical1 = vertical1Raw;
+    prevVertical2 = vertical2Raw;
+    prevHorizontal1 = horizontal1Raw;
+    prevHorizontal2 = horizontal2Raw;
+    prevImu = imuRaw;
+
+    // calculate the heading of the robot
+    // Priority:
+    // 1. Horizontal tracking wheels
+    // 2. Vertical tracking wheels
+    // 3. Inertial Sensor
+    // 4. Drivetrain
+    float heading = odomPose.theta;
+    // calculate the heading using the horizontal tracking wheels
+    if (odomSensors.horizontal1 != nullptr && odomSensors.horizontal2 != nullptr)
+        heading -= (deltaHorizontal1 - deltaHorizontal2) /
+                   (odomSensors.horizontal1->getOffset() - odomSensors.horizontal2->getOffset());
+    // else, if both vertical tracking wheels aren't substituted by the drivetrain, use the vertical tracking wheels
+    else if (!odomSensors.vertical1->getType() && !odomSensors.vertical2->getType())
+        heading -= (deltaVertical1 - deltaVertical2) /
+                   (odomSensors.vertical1->getOffset() - odomSensors.vertical2->getOffset());
+    // else, if the inertial sensor exists, use it
+    else if (odomSensors.imu != nullptr) heading += deltaImu;
+    // else, use the the substituted tracking wheels
+    else
+        heading -= (deltaVertical1 - deltaVertical2) /
+                   (odomSensors.vertical1->getOffset() - odomSensors.vertical2->getOffset());
+    float deltaHeading = heading - odomPose.theta;
+    float avgHeading = odomPose.theta + deltaHeading / 2;
+
+    // choose tracking wheels to use
+    // Prioritize non-powered tracking wheels
+    lemlib::TrackingWheel* verticalWheel = nullptr;
+    lemlib::TrackingWheel* horizontalWheel = nullptr;
+    if (!odomSensors.vertical1->getType()) verticalWheel = odomSensors.vertical1;
+    else if (!odomSensors.vertical2->getType()) verticalWheel = odomSensors.vertical2;
+    else verticalWheel = odomSensors.vertical1;
+    if (odomSensors.horizontal1 != nullptr) horizontalWheel = odomSensors.horizontal1;
+    else if (odomSensors.horizontal2 != nullptr) horizontalWheel = odomSensors.horizontal2;
+    float rawVertical = 0;
+    float rawHorizontal = 0;
+    uint32_t verticalTime = 0;
+    if (verticalWheel != nullptr) rawVertical = verticalWheel->getDistanceTraveled(&verticalTime);
+    if (horizontalWheel != nullptr) rawHorizontal = horizontalWheel->getDistanceTraveled();
+    float horizontalOffset = 0;
+    float verticalOffset = 0;
+    if (verticalWheel != nullptr) verticalOffset = verticalWheel->getOffset();
+    if (horizontalWheel != nullptr) horizontalOffset = horizontalWheel->getOffset();
+
+    // calculate change in x and y
+    float deltaX = 0;
+    float deltaY = 0;
+    if (verticalWheel != nullptr) deltaY = rawVertical - prevVertical;
+    if (horizontalWheel != nullptr) deltaX = rawHorizontal - prevHorizontal;
+    prevVertical = rawVertical;
+    prevHorizontal = rawHorizontal;
+
+    // calculate local x and y
+    float localX = 0;
+    float localY = 0;
+    if (deltaHeading == 0) { // prevent divide by 0
+        localX = deltaX;
+        localY = deltaY;
+    } else {
+        localX = 2 * sin(deltaHeading / 2) * (deltaX / deltaHeading + horizontalOffset);
+        localY = 2 * sin(deltaHeading / 2) * (deltaY / deltaHeading + verticalOffset);
+    }
+
+    // calculate global x and y
+    odomPose.x += localY * sin(avgHeading);
+    odomPose.y += localY * cos(avgHeading);
+    odomPose.x += localX * -cos(avgHeading);
+    odomPose.y += localX * sin(avgHeading);
+    odomPose.theta = heading;
+
+    // sensors without timestamps are read as of now
+    if (sampleTime == 0) sampleTime = pros::millis();
+    poseHistory.push(sampleTime, odomPose);
+
+    pendingLocal.x += localX;
+    pendingLocal.y += localY;
+    pendingLocal.theta += deltaHeading;
+
+    // the speed is only updated when the sensors have taken a new sample, using the time between the samples. The
+    // distance comes from the vertical wheel, so its time is the one to divide by: the other sensors sample at
+    // different times, and going by them would divide a whole sample of movement by a fraction of its period
+    const uint32_t speedTime = verticalTime != 0 ? verticalTime : sampleTime;
+    if (speedTime == prevSampleTime) return;
+    prevSampleTime = speedTime;
+    if (prevSpeedTime == 0) {
+        prevSpeedTime = speedTime;
+        prevSpeedPose = odomPose;
+        pendingLocal = lemlib::Pose(0, 0, 0);
+        return;
+    }
+    const float dt = (speedTime - prevSpeedTime) / 1000.0;
+    prevSpeedTime = speedTime;
+    if (odomStats.minDt == 0 || dt < odomStats.minDt) odomStats.minDt = dt;
+    odomStats.maxDt = std::max(odomStats.maxDt, dt);
+
+    // calculate speed
+    odomSpeed.x = ema((odomPose.x - prevSpeedPose.x) / dt, odomSpeed.x, 0.95);
+    odomSpeed.y = ema((odomPose.y - prevSpeedPose.y) / dt, odomSpeed.y, 0.95);
+    odomSpeed.theta = ema((odomPose.theta - prevSpeedPose.theta) / dt, odomSpeed.theta, 0.95);
+    prevSpeedPose = odomPose;
+
+    // calculate local speed
+    odomLocalSpeed.x = ema(pendingLocal.x / dt, odomLocalSpeed.x, 0.95);
+    odomLocalSpeed.y = ema(pendingLocal.y / dt, odomLocalSpeed.y, 0.95);
+    odomLocalSpeed.theta = ema(pendingLocal.theta / dt, odomLocalSpeed.theta, 0.95);
+    pendingLocal = lemlib::Pose(0, 0, 0);
+}
+
+/**
+ * @brief Initialize the odometry system
+ *
+ * @param onUpdate called by the tracking task after every update. Only the first call to init sets it
+ */
+void lemlib::init(std::function<void()> onUpdate) {
+    setDataRates();
+    if (trackingTask == nullptr) {
+        trackingTask = new pros::Task {[onUpdate] {
+            // scheduled against absolute wake times, so the time update() takes doesn't add up as drift
+            uint32_t wakeTime = pros::millis();
+            while (true) {
+                const uint64_t start = pros::micros();
+                const uint64_t scheduled = uint64_t(wakeTime) * 1000;
+                const uint32_t jitter = start > scheduled ? uint32_t(start - scheduled) : 0;
+                odomStats.maxJitter = std::max(odomStats.maxJitter, jitter);
+                totalJitter += jitter;
+                update();
+                if (onUpdate) onUpdate();
+                odomStats.updates++;
+                odomStats.maxUpdateTime = std::max(odomStats.maxUpdateTime, uint32_t(pros::micros() - start));
+                // if the update ran past the next wake time, skip ahead instead of running a burst of late updates
+                if (pros::millis() >= wakeTime + updatePeriod) {
+                    odomStats.overruns++;
+                    wakeTime = pros::millis();
+                }
+                pros::Task::delay_until(&wakeTime, updatePeriod);
+            }
+        }};
+    }
+}
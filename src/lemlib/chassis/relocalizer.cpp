@@ -0,0 +1,431 @@
+/**
+ * @file src/lemlib/chassis/relocalizer.cpp
+ * @author LemLib Team
+ * @brief Monte Carlo relocalization against the field walls with distance sensors
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <algorithm>
+#include <math.h>
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+#include "pros/error.h"
+#include "pros/rtos.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/chassis/relocalizer.hpp"
+#include "lemlib/util.hpp"
+
+/**
+ * @brief Get the inside of the field perimeter
+ *
+ * @param size distance between opposite walls, in inches. 140.4 for a standard VRC field
+ * @param centerX x coordinate of the center of the field, in inches
+ * @param centerY y coordinate of the center of the field, in inches
+ * @return FieldModel
+ */
+lemlib::FieldModel lemlib::FieldModel::perimeter(float size, float centerX, float centerY) {
+    const float left = centerX - size / 2;
+    const float right = centerX + size / 2;
+    const float bottom = centerY - size / 2;
+    const float top = centerY + size / 2;
+    FieldModel field;
+    field.addWall(left, bottom, right, bottom);
+    field.addWall(right, bottom, right, top);
+    field.addWall(right, top, left, top);
+    field.addWall(left, top, left, bottom);
+    return field;
+}
+
+/**
+ * @brief Add a wall, or any other flat surface tall enough for the sensors to see
+ *
+ * @param x1 x coordinate of one end, in inches
+ * @param y1 y coordinate of one end, in inches
+ * @param x2 x coordinate of the other end, in inches
+ * @param y2 y coordinate of the other end, in inches
+ */
+void lemlib::FieldModel::addWall(float x1, float y1, float x2, float y2) {
+    startX.push_back(x1);
+    startY.push_back(y1);
+    deltaX.push_back(x2 - x1);
+    deltaY.push_back(y2 - y1);
+}
+
+/**
+ * @brief Get the number of walls
+ *
+ * @return std::size_t
+ */
+std::size_t lemlib::FieldModel::size() const { return startX.size(); }
+
+/**
+ * @brief Find how far a ray travels before hitting a wall
+ *
+ * @param x x coordinate of the start of the ray, in inches
+ * @param y y coordinate of the start of the ray, in inches
+ * @param theta direction of the ray, in radians. 0 is +y and positive is clockwise
+ * @return float distance to the nearest wall, infinity if the ray misses every wall
+ */
+float lemlib::FieldModel::castRay(float x, float y, float theta) const {
+    const float s = sinf(theta);
+    const float c = cosf(theta);
+    float out;
+    castRays(1, &x, &y, &s, &c, &out);
+    return out;
+}
+
+/**
+ * @brief Cast a batch of rays
+ *
+ * Solves start + t * direction = wall start + u * wall delta for every ray and wall, and keeps the smallest t where
+ * the ray hits the wall between its ends (0 <= u <= 1) in front of the sensor (t > 0).
+ *
+ * @param count number of rays
+ * @param x x coordinate of the start of each ray
+ * @param y y coordinate of the start of each ray
+ * @param sin sine of the direction of each ray
+ * @param cos cosine of the direction of each ray
+ * @param out distance to the nearest wall along each ray, infinity on a miss
+ */
+void lemlib::FieldModel::castRays(std::size_t count, const float* x, const float* y, const float* sin,
+                                  const float* cos, float* out) const {
+    const std::size_t walls = startX.size();
+    std::size_t first = 0;
+#if defined(__ARM_NEON)
+    // four rays at a time against one wall at a time
+    const float32x4_t zero = vdupq_n_f32(0);
+    const float32x4_t one = vdupq_n_f32(1);
+    const float32x4_t miss = vdupq_n_f32(INFINITY);
+    const float32x4_t parallel = vdupq_n_f32(1e-6);
+    for (; first + 4 <= count; first += 4) {
+        const float32x4_t ox = vld1q_f32(x + first);
+        const float32x4_t oy = vld1q_f32(y + first);
+        const float32x4_t dx = vld1q_f32(sin + first);
+        const float32x4_t dy = vld1q_f32(cos + first);
+        float32x4_t nearest = miss;
+        for (std::size_t j = 0; j < walls; j++) {
+            const float32x4_t ex = vdupq_n_f32(deltaX[j]);
+            const float32x4_t ey = vdupq_n_f32(deltaY[j]);
+            const float32x4_t wx = vsubq_f32(vdupq_n_f32(startX[j]), ox);
+            const float32x4_t wy = vsubq_f32(vdupq_n_f32(startY[j]), oy);
+            const float32x4_t denominator = vmlsq_f32(vmulq_f32(dx, ey), dy, ex);
+            const float32x4_t tNumerator = vmlsq_f32(vmulq_f32(wx, ey), wy, ex);
+            const float32x4_t uNumerator = vmlsq_f32(vmulq_f32(wx, dy), wy, dx);
+            // ARMv7 NEON can't divide, so refine the reciprocal estimate with two Newton-Raphson steps
+            float32x4_t inverse = vrecpeq_f32(denominator);
+            inverse = vmulq_f32(vrecpsq_f32(denominator, inverse), inverse);
+            inverse = vmulq_f32(vrecpsq_f32(denominator, inverse), inverse);
+            const float32x4_t t = vmulq_f32(tNumerator, inverse);
+            const float32x4_t u = vmulq_f32(uNumerator, inverse);
+            uint32x4_t hit = vcagtq_f32(denominator, parallel);
+            hit = vandq_u32(hit, vcgtq_f32(t, zero));
+            hit = vandq_u32(hit, vcgeq_f32(u, zero));
+            hit = vandq_u32(hit, vcleq_f32(u, one));
+            nearest = vminq_f32(nearest, vbslq_f32(hit, t, miss));
+        }
+        vst1q_f32(out + first, nearest);
+    }
+#endif
+    // whatever is left over, or every ray without NEON. Rays are the inner loop so the compiler can vectorize it
+    for (std::size_t i = first; i < count; i++) out[i] = INFINITY;
+    for (std::size_t j = 0; j < walls; j++) {
+        const float ex = deltaX[j];
+        const float ey = deltaY[j];
+        const float ax = startX[j];
+        const float ay = startY[j];
+        for (std::size_t i = first; i < count; i++) {
+            const float wx = ax - x[i];
+            const float wy = ay - y[i];
+            const float denominator = sin[i] * ey - cos[i] * ex;
+            const float t = (wx * ey - wy * ex) / denominator;
+            const float u = (wx * cos[i] - wy * sin[i]) / denominator;
+            const bool hit = fabsf(denominator) > 1e-6f && t > 0 && u >= 0 && u <= 1;
+            out[i] = std::min(out[i], hit ? t : INFINITY);
+        }
+    }
+}
+
+/**
+ * @brief Construct a new Relocalizer
+ *
+ * @param field the walls the sensors can see
+ * @param sensors the distance sensors
+ * @param settings the tuning
+ */
+lemlib::Relocalizer::Relocalizer(FieldModel field, std::vector<RelocalizerSensor> sensors,
+                                 RelocalizerSettings settings)
+    : field(std::move(field)),
+      sensors(std::move(sensors)),
+      settings(settings),
+      x(settings.particles),
+      y(settings.particles),
+      theta(settings.particles),
+      weight(settings.particles, 1.0f / settings.particles),
+      likelihood(settings.particles),
+      scratchX(settings.particles),
+      scratchY(settings.particles),
+      scratchTheta(settings.particles),
+      rayX(settings.particles),
+      rayY(settings.particles),
+      raySin(settings.particles),
+      rayCos(settings.particles),
+      rayDistance(settings.particles) {}
+
+/**
+ * @brief Start updating in a task of its own
+ *
+ */
+void lemlib::Relocalizer::start() {
+    if (task != nullptr) return;
+    prevPose = getPose(true);
+    reset(prevPose, true);
+    stopping = false;
+    task = new pros::Task {[this] {
+        uint32_t wakeTime = pros::millis();
+        while (!stopping) {
+            update();
+            pros::Task::delay_until(&wakeTime, settings.period);
+        }
+    }};
+}
+
+/**
+ * @brief Stop the task started by start()
+ *
+ * Waits for the update under way to finish, so the task never dies holding odometry's locks
+ */
+void lemlib::Relocalizer::stop() {
+    if (task == nullptr) return;
+    stopping = true;
+    task->join();
+    delete task;
+    task = nullptr;
+}
+
+/**
+ * @brief Spread the particles around a pose
+ *
+ * @param pose the pose
+ * @param radians true if theta is in radians, false if in degrees. False by default
+ */
+void lemlib::Relocalizer::reset(Pose pose, bool radians) {
+    if (!radians) pose.theta = degToRad(pose.theta);
+    std::normal_distribution<float> gaussian(0, settings.initialSpread);
+    for (std::size_t i = 0; i < x.size(); i++) {
+        x[i] = pose.x + gaussian(rng);
+        y[i] = pose.y + gaussian(rng);
+        // the IMU is trusted far more than the sensors, so heading isn't spread
+        theta[i] = pose.theta;
+        weight[i] = 1.0f / x.size();
+    }
+    mean = pose;
+    spread = settings.initialSpread * sqrtf(2);
+}
+
+/**
+ * @brief Move every particle by a motion measured in the robot's frame
+ *
+ * @param delta motion since the last update, x sideways and y forwards, theta in radians
+ */
+void lemlib::Relocalizer::predict(Pose delta) {
+    const float distance = sqrtf(delta.x * delta.x + delta.y * delta.y);
+    std::normal_distribution<float> translation(
+        0, settings.translationNoise * distance + settings.turnNoise * fabsf(delta.theta) + settings.jitter);
+    std::normal_distribution<float> rotation(0, settings.rotationNoise * fabsf(delta.theta));
+    for (std::size_t i = 0; i < x.size(); i++) {
+        const float dx = delta.x + translation(rng);
+        const float dy = delta.y + translation(rng);
+        const float s = sinf(theta[i]);
+        const float c = cosf(theta[i]);
+        x[i] += dx * c + dy * s;
+        y[i] += -dx * s + dy * c;
+        theta[i] += delta.theta + rotation(rng);
+    }
+}
+
+/**
+ * @brief Weigh the particles with the latest distance readings
+ *
+ * @return true if at least one reading was usable
+ */
+bool lemlib::Relocalizer::weigh() {
+    const std::size_t count = x.size();
+    std::fill(likelihood.begin(), likelihood.end(), 0.0f);
+    bool used = false;
+
+    // the sine and cosine of each particle are shared by every sensor
+    for (std::size_t i = 0; i < count; i++) {
+        scratchX[i] = sinf(theta[i]);
+        scratchY[i] = cosf(theta[i]);
+    }
+
+    for (const RelocalizerSensor& sensor : sensors) {
+        const int32_t raw = sensor.sensor->get();
+        // nothing in range reads as 9999, and readings under 200 mm don't come with a confidence
+        if (raw == PROS_ERR || raw <= 0 || raw >= 9999) continue;
+        if (raw > 200 && sensor.sensor->get_confidence() < settings.minConfidence) continue;
+        const float reading = raw / 25.4f;
+        if (reading > settings.maxRange) continue;
+        used = true;
+
+        // cast a ray from where the sensor would be on each particle
+        const float mountSin = sinf(degToRad(sensor.angle));
+        const float mountCos = cosf(degToRad(sensor.angle));
+        for (std::size_t i = 0; i < count; i++) {
+            const float s = scratchX[i];
+            const float c = scratchY[i];
+            rayX[i] = x[i] + sensor.x * c + sensor.y * s;
+            rayY[i] = y[i] - sensor.x * s + sensor.y * c;
+            raySin[i] = s * mountCos + c * mountSin;
+            rayCos[i] = c * mountCos - s * mountSin;
+        }
+        field.castRays(count, rayX.data(), rayY.data(), raySin.data(), rayCos.data(), rayDistance.data());
+
+        // a gaussian around the expected reading, plus a floor for robots and game elements the model doesn't know
+        const float sigma = std::max(settings.minSensorNoise, settings.sensorNoise * reading);
+        const float scale = -0.5f / (sigma * sigma);
+        for (std::size_t i = 0; i < count; i++) {
+            const float error = std::min(reading - rayDistance[i], 4 * sigma);
+            likelihood[i] += logf(expf(scale * error * error) + 0.01f);
+        }
+    }
+    if (!used) return false;
+
+    // subtract the best log likelihood so exp doesn't underflow to all zeros
+    const float best = *std::max_element(likelihood.begin(), likelihood.end());
+    float total = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        weight[i] *= expf(likelihood[i] - best);
+        total += weight[i];
+    }
+    if (total <= 0 || !std::isfinite(total)) {
+        std::fill(weight.begin(), weight.end(), 1.0f / count);
+        return true;
+    }
+    for (std::size_t i = 0; i < count; i++) weight[i] /= total;
+    return true;
+}
+
+/**
+ * @brief Replace the particles by drawing from them in proportion to their weights
+ *
+ * Low variance resampling: one random number picks evenly spaced points along the cumulative weights, so a particle
+ * with weight w gets copied close to w * count times
+ */
+void lemlib::Relocalizer::resample() {
+    const std::size_t count = x.size();
+    const float step = 1.0f / count;
+    float target = std::uniform_real_distribution<float>(0, step)(rng);
+    float cumulative = weight[0];
+    std::size_t source = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        while (target > cumulative && source + 1 < count) cumulative += weight[++source];
+        scratchX[i] = x[source];
+        scratchY[i] = y[source];
+        scratchTheta[i] = theta[source];
+        target += step;
+    }
+    x.swap(scratchX);
+    y.swap(scratchY);
+    theta.swap(scratchTheta);
+    std::fill(weight.begin(), weight.end(), step);
+}
+
+/**
+ * @brief Compute the weighted mean and spread of the particles
+ *
+ */
+void lemlib::Relocalizer::estimate() {
+    float meanX = 0, meanY = 0, meanSin = 0, meanCos = 0;
+    for (std::size_t i = 0; i < x.size(); i++) {
+        meanX += weight[i] * x[i];
+        meanY += weight[i] * y[i];
+        meanSin += weight[i] * sinf(theta[i]);
+        meanCos += weight[i] * cosf(theta[i]);
+    }
+    float variance = 0;
+    for (std::size_t i = 0; i < x.size(); i++) {
+        variance += weight[i] * ((x[i] - meanX) * (x[i] - meanX) + (y[i] - meanY) * (y[i] - meanY));
+    }
+    mean = Pose(meanX, meanY, atan2f(meanSin, meanCos));
+    spread = sqrtf(variance);
+}
+
+/**
+ * @brief Move the particles with odometry, weigh them with the sensors, and correct odometry
+ *
+ */
+void lemlib::Relocalizer::update() {
+    const uint64_t start = pros::micros();
+    const uint32_t now = pros::millis();
+
+    // odometry is compared against where it was left after the last correction, so the particles only move by
+    // what odometry measured and not by the corrections they caused
+    const Pose after = getPose(true);
+    const float dx = after.x - prevPose.x;
+    const float dy = after.y - prevPose.y;
+    const float s = sinf(prevPose.theta);
+    const float c = cosf(prevPose.theta);
+    predict(Pose(dx * c - dy * s, dx * s + dy * c, after.theta - prevPose.theta));
+    prevPose = after;
+
+    // setPose, or odometry being way off for a while, leaves the particles somewhere else entirely
+    estimate();
+    if (after.distance(mean) > settings.resetDistance) {
+        reset(after, true);
+        stats.resets++;
+    }
+
+    if (fabsf(getSpeed(true).theta) < degToRad(settings.maxAngularVelocity) && weigh()) {
+        stats.updates++;
+        estimate();
+        float sumSquares = 0;
+        for (float w : weight) sumSquares += w * w;
+        // resample once most of the weight sits on a few particles
+        if (sumSquares * x.size() > 2) {
+            resample();
+            stats.resamples++;
+        }
+        if (spread < settings.maxSpread) {
+            prevPose = Pose(mean.x, mean.y, after.theta);
+            correctPose(now, prevPose, true);
+            stats.corrections++;
+        }
+    }
+
+    const uint32_t elapsed = pros::micros() - start;
+    stats.maxUpdateTime = std::max(stats.maxUpdateTime, elapsed);
+    totalUpdateTime += elapsed;
+    stats.meanUpdateTime = float(totalUpdateTime) / ++updateCalls;
+}
+
+/**
+ * @brief Get the weighted average of the particles
+ *
+ * @param radians true for theta in radians, false for degrees. False by default
+ * @return Pose
+ */
+lemlib::Pose lemlib::Relocalizer::getEstimate(bool radians) const {
+    Pose out = mean;
+    if (!radians) out.theta = radToDeg(out.theta);
+    return out;
+}
+
+/**
+ * @brief Get the standard deviation of the particle positions
+ *
+ * @return float in inches
+ */
+float lemlib::Relocalizer::getSpread() const { return spread; }
+
+/**
+ * @brief Get statistics about the updates so far
+ *
+ * @return RelocalizerStats
+ */
+lemlib::RelocalizerStats lemlib::Relocalizer::getStats() const { return stats; }
@@ -0,0 +1,147 @@
+/**
+ * @file src/lemlib/chassis/trackingWheel.cpp
+ * @author LemLib Team
+ * @brief tracking wheel class definitions
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <math.h>
+#include <algorithm>
+#include "pros/rtos.hpp"
+#include "lemlib/util.hpp"
+#include "lemlib/chassis/trackingWheel.hpp"
+
+/**
+ * @brief Create a new tracking wheel
+ *
+ * @param encoder the optical shaft encoder to use
+ * @param wheelDiameter the diameter of the wheel
+ * @param distance distance between the tracking wheel and the center of rotation in inches
+ * @param gearRatio gear ratio of the tracking wheel, defaults to 1
+ */
+lemlib::TrackingWheel::TrackingWheel(pros::ADIEncoder* encoder, float wheelDiameter, float distance, float gearRatio) {
+    this->encoder = encoder;
+    this->diameter = wheelDiameter;
+    this->distance = distance;
+    this->gearRatio = gearRatio;
+}
+
+/**
+ * @brief Create a new tracking wheel
+ *
+ * @param encoder the v5 rotation sensor to use
+ * @param wheelDiameter the diameter of the wheel
+ * @param distance distance between the tracking wheel and the center of rotation in inches
+ * @param gearRatio gear ratio of the tracking wheel, defaults to 1
+ */
+lemlib::TrackingWheel::TrackingWheel(pros::Rotation* encoder, float wheelDiameter, float distance, float gearRatio) {
+    this->rotation = encoder;
+    this->diameter = wheelDiameter;
+    this->distance = distance;
+    this->gearRatio = gearRatio;
+}
+
+/**
+ * @brief Create a new tracking wheel
+ *
+ * @param motors the motor group to use
+ * @param wheelDiameter the diameter of the wheel
+ * @param distance half the track width of the drivetrain in inches
+ * @param rpm theoretical maximum rpm of the drivetrain wheels
+ */
+lemlib::TrackingWheel::TrackingWheel(pros::Motor_Group* motors, float wheelDiameter, float distance, float rpm) {
+    this->motors = motors;
+    this->motors->set_encoder_units(pros::E_MOTOR_ENCODER_ROTATIONS);
+    this->diameter = wheelDiameter;
+    this->distance = distance;
+    this->rpm = rpm;
+}
+
+/**
+ * @brief Reset the tracking wheel position to 0
+ *
+ */
+void lemlib::TrackingWheel::reset() {
+    if (this->encoder != nullptr) this->encoder->reset();
+    if (this->rotation != nullptr) this->rotation->reset_position();
+    if (this->motors != nullptr) {
+        this->motors->tare_position();
+        // raw counts aren't affected by taring, so remember where they were
+        const int count = std::min<int>(this->motors->size(), MAX_MOTORS);
+        for (int i = 0; i < count; i++) this->motorZeros[i] = (*this->motors)[i].get_raw_position(nullptr);
+    }
+}
+
+/**
+ * @brief Get the distance traveled by the tracking wheel
+ *
+ * @param timestamp where to store the time the distance was measured, in ms. Ignored if nullptr
+ * @return float distance traveled in inches
+ */
+float lemlib::TrackingWheel::getDistanceTraveled(std::uint32_t* timestamp) {
+    if (this->motors == nullptr && timestamp != nullptr) *timestamp = pros::millis();
+    if (this->encoder != nullptr) {
+        return (float(this->encoder->get_value()) * this->diameter * M_PI / 360) / this->gearRatio;
+    } else if (this->rotation != nullptr) {
+        return (float(this->rotation->get_position()) * this->diameter * M_PI / 36000) / this->gearRatio;
+    } else if (this->motors != nullptr) {
+        // read the raw counts motor by motor, so each one comes with the time the motor sampled it, and nothing is
+        // allocated at the odometry rate
+        const int count = std::min<int>(this->motors->size(), MAX_MOTORS);
+        float total = 0;
+        uint64_t totalTime = 0;
+        for (int i = 0; i < count; i++) {
+            pros::Motor& motor = (*this->motors)[i];
+            std::uint32_t time = 0;
+            const std::int32_t position = motor.get_raw_position(&time);
+            float in;
+            float ticks;
+            switch (motor.get_gearing()) {
+                case pros::E_MOTOR_GEARSET_36: in = 100, ticks = 1800; break;
+                case pros::E_MOTOR_GEARSET_18: in = 200, ticks = 900; break;
+                case pros::E_MOTOR_GEARSET_06: in = 600, ticks = 300; break;
+                default: in = 200, ticks = 900; break;
+            }
+            // get distance traveled by each motor
+            total += (position - motorZeros[i]) / ticks * (diameter * M_PI) * (rpm / in);
+            totalTime += time;
+        }
+        if (count == 0) return 0;
+        // the motors on a side are sampled at slightly different times, and the average distance goes with their
+        // average time
+        if (timestamp != nullptr) *timestamp = (totalTime + count / 2) / count;
+        return total / count;
+    } else {
+        return 0;
+    }
+}
+
+/**
+ * @brief Set how often the sensor takes a new sample
+ *
+ * @param rate time between samples, in ms. The minimum is 5
+ */
+void lemlib::TrackingWheel::setDataRate(std::uint32_t rate) {
+    if (this->rotation != nullptr) this->rotation->set_data_rate(rate);
+}
+
+/**
+ * @brief Get the offset of the tracking wheel from the center of rotation
+ *
+ * @return float offset in inches
+ */
+float lemlib::TrackingWheel::getOffset() { return this->distance; }
+
+/**
+ * @brief Get the type of tracking wheel
+ *
+ * @return int - 1 if motor group, 0 otherwise
+ */
+int lemlib::TrackingWheel::getType() {
+    if (this->motors != nullptr) return 1;
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <cmath>
+#include "pros/rtos.hpp"
+#include "lemlib/exitcondition.hpp"
+
+namespace lemlib {
+/**
+ * @brief Create a new Exit Condition
+ *
+ * @param range the range where the countdown is allowed to start
+ * @param time how much time to wait while in range before exiting
+ */
+ExitCondition::ExitCondition(const float range, const int time)
+    : range(range),
+      time(time) {}
+
+/**
+ * @brief set how to tell the robot has settled, which exits before the countdown is up
+ *
+ * @param settle the settle settings. A time of 0 turns settle detection off
+ */
+void ExitCondition::setSettle(SettleSettings settle) { this->settle = settle; }
+
+/**
+ * @brief whether the exit condition has been met
+ *
+ * @return true exit condition met
+ * @return false exit condition not met
+ */
+bool ExitCondition::getExit() { return done; }
+
+/**
+ * @brief how much sooner settle detection met the exit condition than the countdown would have
+ *
+ * @return time saved in ms, 0 if the countdown met it or it hasn't been met
+ */
+int ExitCondition::getSaved() const { return saved; }
+
+/**
+ * @brief when the countdown ended, or would have if settle detection hadn't ended it first
+ *
+ * @return the time in ms, or -1 if the input is out of range and it hasn't been met
+ */
+int ExitCondition::getCountdownEnd() const {
+    if (done) return doneTime + saved;
+    return startTime == -1 ? -1 : startTime + time;
+}
+
+/**
+ * @brief update the exit condition
+ *
+ * @param input the input for the exit condition
+ * @param velocity velocity measured by odometry, for settle detection
+ * @return true exit condition met
+ * @return false exit condition not met
+ */
+bool ExitCondition::update(const float input, const float velocity) {
+    const int curTime = pros::millis();
+    if (done) return done;
+    if (std::fabs(input) > range) startTime = -1;
+    else if (startTime == -1) startTime = curTime;
+    else if (curTime >= startTime + time) {
+        done = true;
+        doneTime = curTime;
+    }
+
+    // the robot has settled once it has been in range and stopped for the settle time
+    const bool hasRate = prevTime != -1 && curTime > prevTime;
+    const float rate = hasRate ? (input - prevInput) * 1000 / (curTime - prevTime) : 0;
+    prevTime = curTime;
+    prevInput = input;
+    if (done || settle.time <= 0) return done;
+    const bool settled =
+        startTime != -1 && hasRate && std::fabs(rate) <= settle.maxRate && std::fabs(velocity) <= settle.maxVelocity;
+    if (!settled) settleStartTime = -1;
+    else if (settleStartTime == -1) settleStartTime = curTime;
+    else if (curTime >= settleStartTime + settle.time) {
+        done = true;
+        doneTime = curTime;
+        // the countdown could not have ended any sooner than this, even with the input staying in range
+        saved = startTime + time - curTime;
+    }
+    return done;
+}
+
+/**
+ * @brief reset the exit condition timer
+ *
+ */
+void ExitCondition::reset() {
+    startTime = -1;
+    settleStartTime = -1;
+    prevTime = -1;
+    saved = 0;
+    doneTime = -1;
+    done = false;
+}
+
+/**
+ * @brief when the first of two exit conditions' countdowns ended, or would have, for motions that end on either
+ *
+ * @param a the first exit condition
+ * @param b the second exit condition
+ * @return the time in ms, or -1 if neither countdown is running
+ */
+int firstCountdownEnd(const ExitCondition& a, const ExitCondition& b) {
+    const int aEnd = a.getCountdownEnd();
+    const int bEnd = b.getCountdownEnd();
+    if (aEnd == -1) return bEnd;
+    if (bEnd == -1) return aEnd;
+    return std::min(aEnd, bEnd);
+}
+} // namespace lemlib
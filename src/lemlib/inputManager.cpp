@@ -0,0 +1,102 @@
+#include <utility>
+#include "pros/rtos.hpp"
+#include "lemlib/inputManager.hpp"
+
+namespace lemlib {
+/**
+ * @brief Create a new input manager
+ *
+ * @param controller the controller to read
+ * @param settings the settings
+ */
+InputManager::InputManager(pros::Controller& controller, InputSettings settings)
+    : controller(controller),
+      settings(settings) {}
+
+/**
+ * @brief Run an action every time a button does something
+ *
+ * Actions run in update, in the task that calls it, so they shouldn't block
+ *
+ * @param button the button
+ * @param event what the button has to do
+ * @param action the action
+ * @return true the action was bound
+ * @return false there is no room for another action
+ */
+bool InputManager::bind(pros::controller_digital_e_t button, ButtonEvent event, std::function<void()> action) {
+    if (bindingCount >= MAX_BINDINGS || bit(button) == 0 || !action) return false;
+    bindings[bindingCount++] = {bit(button), event, std::move(action)};
+    return true;
+}
+
+/**
+ * @brief Read the buttons and run the actions bound to what they did since the last update
+ *
+ */
+void InputManager::update() {
+    const uint32_t now = pros::millis();
+    events.fill(0);
+    for (int i = 0; i < BUTTONS; i++) {
+        const uint16_t mask = 1 << i;
+        const bool raw = controller.get_digital(pros::controller_digital_e_t(pros::E_CONTROLLER_DIGITAL_L1 + i)) == 1;
+        // a change counts straight away, and then the button ignores the contacts bouncing for a while
+        if (raw != bool(down & mask) && now - changeTime[i] >= uint32_t(settings.debounce)) {
+            changeTime[i] = now;
+            if (raw) {
+                down |= mask;
+                events[int(ButtonEvent::PRESS)] |= mask;
+                holdDone &= ~mask;
+                if ((tapArmed & mask) && now - pressTime[i] <= uint32_t(settings.doubleTapTime)) {
+                    events[int(ButtonEvent::DOUBLE_TAP)] |= mask;
+                    tapArmed &= ~mask;
+                } else {
+                    tapArmed |= mask;
+                }
+                pressTime[i] = now;
+            } else {
+                down &= ~mask;
+                events[int(ButtonEvent::RELEASE)] |= mask;
+            }
+        }
+        if ((down & mask) && !(holdDone & mask) && now - pressTime[i] >= uint32_t(settings.holdTime)) {
+            events[int(ButtonEvent::HOLD)] |= mask;
+            holdDone |= mask;
+        }
+    }
+
+    // run the actions bound to what happened, in the order they were bound
+    for (int i = 0; i < bindingCount; i++) {
+        if (events[int(bindings[i].event)] & bindings[i].button) bindings[i].action();
+    }
+}
+
+/**
+ * @brief whether a button is down, as of the last update
+ *
+ * @param button the button
+ */
+bool InputManager::isDown(pros::controller_digital_e_t button) const { return down & bit(button); }
+
+/**
+ * @brief whether a button did something in the last update
+ *
+ * @param button the button
+ * @param event what the button has to have done
+ */
+bool InputManager::happened(pros::controller_digital_e_t button, ButtonEvent event) const {
+    return events[int(event)] & bit(button);
+}
+
+/**
+ * @brief the bit of a button in the bitsets
+ *
+ * @param button the button
+ * @return uint16_t the bit, or 0 if it isn't a digital button
+ */
+uint16_t InputManager::bit(pros::controller_digital_e_t button) {
+    const int index = button - pros::E_CONTROLLER_DIGITAL_L1;
+    if (index < 0 || index >= BUTTONS) return 0;
+    return 1 << index;
+}
+} // namespace lemlib
@@ -0,0 +1,19 @@
+#include "lemlib/logger/infoSink.hpp"
+#include "lemlib/logger/stdout.hpp"
+
+namespace lemlib {
+InfoSink::InfoSink() { setFormat("[LemLib] {level}: {message}"); }
+
+void InfoSink::sendMessage(const Message& message) {
+    std::string color;
+    switch (message.level) {
+        case Level::INFO: color = "\033[0;32m"; break; // green
+        case Level::DEBUG: color = "\033[0;36m"; break; // cyan
+        case Level::WARN: color = "\033[0;33m"; break; // yellow
+        case Level::ERROR: color = "\033[0;31m"; break; // red
+        case Level::FATAL: color = "\033[0;31;2m"; break; // dark red
+    }
+
+    bufferedStdout().print("{}{}\033[0m\n", color, message.message);
+}
+} // namespace lemlib
@@ -0,0 +1,11 @@
+#include "lemlib/logger/telemetrySink.hpp"
+#include "lemlib/logger/stdout.hpp"
+
+namespace lemlib {
+TelemetrySink::TelemetrySink() { setFormat("{message}"); }
+
+void TelemetrySink::sendMessage(const Message& message) {
+    // the escape codes hide the telemetry from the user's terminal
+    bufferedStdout().print("TELE_START{}TELE_END\033[1K\033[0G\n", message.message);
+}
+} // namespace lemlib
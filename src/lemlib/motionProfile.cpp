@@ -0,0 +1,171 @@
+/**
+ * @file src/lemlib/motionProfile.cpp
+ * @author LemLib Team
+ * @brief Trapezoidal and S-curve motion profiles
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <algorithm>
+#include <math.h>
+#include "lemlib/motionProfile.hpp"
+
+/** @brief iterations of bisection when the profile can't reach its max velocity, each halving the error */
+constexpr int SEARCH_ITERATIONS = 30;
+
+/**
+ * @brief Plan a motion
+ *
+ * @param distance distance to travel. Negative distances are travelled backwards
+ * @param constraints the limits
+ * @param startVelocity velocity at the start, in the direction of travel. 0 by default
+ * @param endVelocity velocity at the end, in the direction of travel. 0 by default
+ */
+lemlib::MotionProfile::MotionProfile(float distance, ProfileConstraints constraints, float startVelocity,
+                                     float endVelocity)
+    : constraints(constraints),
+      direction(distance < 0 ? -1 : 1),
+      distance(fabsf(distance)) {
+    const float maxVelocity = constraints.maxVelocity;
+    if (maxVelocity <= 0 || constraints.maxAcceleration <= 0 || this->distance == 0) return;
+    const float start = std::clamp(startVelocity, 0.0f, maxVelocity);
+    float end = std::clamp(endVelocity, 0.0f, maxVelocity);
+    float peak = maxVelocity;
+    float cruise = 0;
+
+    if (rampDistance(start, peak) + rampDistance(peak, end) <= this->distance) {
+        // long enough to reach max velocity
+        cruise = (this->distance - rampDistance(start, peak) - rampDistance(peak, end)) / peak;
+    } else if (rampDistance(start, std::max(start, end)) + rampDistance(std::max(start, end), end) > this->distance) {
+        // too short to even get from the start velocity to the end velocity, so get as close as possible. The
+        // distance a ramp covers grows with the change in velocity, so the end velocity can be found by bisection
+        float low = std::min(start, end);
+        float high = std::max(start, end);
+        for (int i = 0; i < SEARCH_ITERATIONS; i++) {
+            const float mid = (low + high) / 2;
+            const bool tooFar = rampDistance(start, mid) > this->distance;
+            if (start > end ? !tooFar : tooFar) high = mid;
+            else low = mid;
+        }
+        end = start > end ? high : low;
+        peak = start;
+    } else {
+        // can't reach max velocity, so find the highest peak that still stops in time
+        float low = std::max(start, end);
+        float high = maxVelocity;
+        for (int i = 0; i < SEARCH_ITERATIONS; i++) {
+            const float mid = (low + high) / 2;
+            if (rampDistance(start, mid) + rampDistance(mid, end) > this->distance) high = mid;
+            else low = mid;
+        }
+        peak = low;
+        // cruise for whatever distance the bisection left over, so the profile ends exactly at the distance
+        if (peak > 0) cruise = (this->distance - rampDistance(start, peak) - rampDistance(peak, end)) / peak;
+    }
+
+    endSpeed = start;
+    addRamp(start, peak);
+    if (cruise > 0) addSegment(cruise, 0, 0);
+    addRamp(peak, end);
+    this->endVelocity = end;
+}
+
+/**
+ * @brief Distance travelled while changing velocity, with the acceleration ramped by the jerk limit
+ *
+ * The acceleration ramps up and down symmetrically, so the average velocity is halfway between the two
+ *
+ * @param from velocity at the start
+ * @param to velocity at the end
+ * @return float
+ */
+float lemlib::MotionProfile::rampDistance(float from, float to) const {
+    const float change = fabsf(to - from);
+    const float acceleration = constraints.maxAcceleration;
+    const float jerk = constraints.maxJerk;
+    float time;
+    if (jerk <= 0) time = change / acceleration;
+    else if (change >= acceleration * acceleration / jerk) time = change / acceleration + acceleration / jerk;
+    else time = 2 * sqrtf(change / jerk);
+    return (from + to) / 2 * time;
+}
+
+/**
+ * @brief Add the segments that change velocity
+ *
+ * @param from velocity at the start
+ * @param to velocity at the end
+ */
+void lemlib::MotionProfile::addRamp(float from, float to) {
+    const float change = fabsf(to - from);
+    if (change == 0) return;
+    const float sign = to > from ? 1 : -1;
+    const float acceleration = constraints.maxAcceleration;
+    const float jerk = constraints.maxJerk;
+    if (jerk <= 0) {
+        addSegment(change / acceleration, 0, sign * acceleration);
+    } else if (change >= acceleration * acceleration / jerk) {
+        // jerk up to max acceleration, hold it, then jerk back down
+        const float rampTime = acceleration / jerk;
+        addSegment(rampTime, sign * jerk, 0);
+        addSegment(change / acceleration - rampTime, 0, sign * acceleration);
+        addSegment(rampTime, -sign * jerk, sign * acceleration);
+    } else {
+        // the velocity changes before max acceleration is reached
+        const float rampTime = sqrtf(change / jerk);
+        addSegment(rampTime, sign * jerk, 0);
+        addSegment(rampTime, -sign * jerk, sign * jerk * rampTime);
+    }
+}
+
+/**
+ * @brief Add a segment, starting where the last one ended
+ *
+ * @param duration how long the segment lasts, in seconds
+ * @param jerk jerk during the segment
+ * @param acceleration acceleration at the start of the segment
+ */
+void lemlib::MotionProfile::addSegment(float duration, float jerk, float acceleration) {
+    if (duration <= 0 || count == segments.size()) return;
+    segments[count++] = {this->duration, duration, jerk, endPosition, endSpeed, acceleration};
+    endPosition += endSpeed * duration + acceleration * duration * duration / 2 + jerk * powf(duration, 3) / 6;
+    endSpeed += acceleration * duration + jerk * duration * duration / 2;
+    this->duration += duration;
+}
+
+/**
+ * @brief Get where the profile is at a given time
+ *
+ * @param time time since the start of the profile, in seconds
+ * @return ProfileState the start before the profile starts, the end after it ends
+ */
+lemlib::ProfileState lemlib::MotionProfile::sample(float time) const {
+    if (count == 0 || time >= duration) return {direction * distance, direction * endVelocity, 0};
+    time = std::max(time, 0.0f);
+    std::size_t i = 0;
+    while (i + 1 < count && time >= segments[i + 1].start) i++;
+    const Segment& segment = segments[i];
+    const float t = time - segment.start;
+    const float position =
+        segment.position + segment.velocity * t + segment.acceleration * t * t / 2 + segment.jerk * t * t * t / 6;
+    const float velocity = segment.velocity + segment.acceleration * t + segment.jerk * t * t / 2;
+    const float acceleration = segment.acceleration + segment.jerk * t;
+    return {direction * position, direction * velocity, direction * acceleration};
+}
+
+/**
+ * @brief Get how long the profile takes
+ *
+ * @return float in seconds
+ */
+float lemlib::MotionProfile::getDuration() const { return duration; }
+
+/**
+ * @brief Get the distance the profile travels
+ *
+ * @return float
+ */
+float lemlib::MotionProfile::getDistance() const { return direction * distance; }
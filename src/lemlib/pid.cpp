@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <cmath>
+#include "lemlib/pid.hpp"
+#include "lemlib/util.hpp"
+
+namespace lemlib {
+/**
+ * @brief Construct a new PID
+ *
+ * @param kP proportional gain
+ * @param kI integral gain
+ * @param kD derivative gain
+ * @param windupRange integral anti windup range
+ * @param signFlipReset whether to reset integral when sign of error flips
+ */
+PID::PID(float kP, float kI, float kD, float windupRange, bool signFlipReset)
+    : kP(kP),
+      kI(kI),
+      kD(kD),
+      windupRange(windupRange),
+      signFlipReset(signFlipReset) {}
+
+/**
+ * @brief Update the PID
+ *
+ * @param error target minus position - AKA error
+ * @return float output
+ */
+float PID::update(const float error) {
+    // calculate integral
+    integral += error;
+    if (sgn(error) != sgn((prevError)) && signFlipReset) integral = 0;
+    if (std::fabs(error) > windupRange && windupRange != 0) integral = 0;
+
+    // calculate derivative
+    const float derivative = error - prevError;
+    prevError = error;
+
+    // calculate output
+    return error * kP + integral * kI + derivative * kD;
+}
+
+/**
+ * @brief Update the PID with the time since the last update, using the settings
+ *
+ * @param error target minus position - AKA error
+ * @param dt time since the last update, in seconds
+ * @param measurement the position, so that the error is the target minus it. Only needed for derivative on
+ * measurement
+ * @return float output, limited to the max output
+ */
+float PID::update(const float error, const float dt, const float measurement) {
+    // how many periods the gains are for have passed
+    const float steps = settings.period > 0 && dt > 0 ? dt / settings.period : 1;
+
+    // calculate integral
+    integral += error * steps;
+    if (sgn(error) != sgn((prevError)) && signFlipReset) integral = 0;
+    if (std::fabs(error) > windupRange && windupRange != 0) integral = 0;
+
+    // calculate derivative. There is nothing to differentiate against on the first update
+    float rawDerivative = 0;
+    if (!first) {
+        rawDerivative = settings.derivativeOnMeasurement ? -(measurement - prevMeasurement) : error - prevError;
+        rawDerivative /= steps;
+    }
+    if (first || settings.derivativeCutoff <= 0) {
+        derivative = rawDerivative;
+    } else {
+        // first order low-pass filter
+        const float timeConstant = 1 / (2 * M_PI * settings.derivativeCutoff);
+        derivative += (rawDerivative - derivative) * dt / (dt + timeConstant);
+    }
+    prevError = error;
+    prevMeasurement = measurement;
+    first = false;
+
+    // calculate output
+    const float output = error * kP + integral * kI + derivative * kD;
+    if (settings.maxOutput <= 0) return output;
+    const float limited = std::clamp(output, -settings.maxOutput, settings.maxOutput);
+    // back-calculation: bleed the integral off by however far the output is over the limit
+    if (kI != 0) integral -= std::fmin(settings.backCalculation * dt, 1) * (output - limited) / kI;
+    return limited;
+}
+
+/**
+ * @brief Change the settings used by the update with a time step
+ *
+ * @param settings the settings
+ */
+void PID::setSettings(PIDSettings settings) { this->settings = settings; }
+
+/**
+ * @brief Change the gains, keeping the integral and the previous error
+ *
+ * @param kP proportional gain
+ * @param kI integral gain
+ * @param kD derivative gain
+ */
+void PID::setGains(float kP, float kI, float kD) {
+    this->kP = kP;
+    this->kI = kI;
+    this->kD = kD;
+}
+
+/**
+ * @brief reset integral, derivative, and prevTime
+ *
+ */
+void PID::reset() {
+    integral = 0;
+    prevError = 0;
+    prevMeasurement = 0;
+    derivative = 0;
+    first = true;
+}
+} // namespace lemlib
@@ -0,0 +1,65 @@
+#include <cmath>
+#include "pros/rtos.hpp"
+#include "lemlib/stallDetector.hpp"
+
+/** @brief current a V5 motor draws at a standstill with full power, in mA */
+constexpr float STALL_CURRENT = 2500;
+
+namespace lemlib {
+/**
+ * @brief Create a new stall detector
+ *
+ * @param settings the settings
+ */
+StallDetector::StallDetector(StallSettings settings)
+    : settings(settings) {}
+
+/**
+ * @brief whether the robot has stalled
+ *
+ * @return true the robot has been stalled for long enough
+ * @return false it hasn't
+ */
+bool StallDetector::getExit() const { return done; }
+
+/**
+ * @brief update the stall detector
+ *
+ * @param power motor power the drivetrain is driven forwards with, out of 127
+ * @param velocity forward velocity of the robot from something that doesn't slip, in inches per second
+ * @param wheelVelocity forward velocity of the robot measured by the drive encoders, in inches per second
+ * @param freeVelocity velocity of the robot at full power with no load, in inches per second
+ * @param current average current drawn by the drivetrain motors, in mA
+ * @param acceleration horizontal acceleration measured by the IMU, in g. 0 without an IMU
+ * @return true the robot has been stalled for long enough
+ * @return false it hasn't
+ */
+bool StallDetector::update(float power, float velocity, float wheelVelocity, float freeVelocity, float current,
+                           float acceleration) {
+    if (settings.time <= 0) return false;
+    const float share = std::fabs(power) / 127;
+    const float slowest = settings.velocityRatio * share * freeVelocity;
+    // how fast the robot and the wheels go the way they are pushed
+    const float speed = power > 0 ? velocity : -velocity;
+    const float wheelSpeed = power > 0 ? wheelVelocity : -wheelVelocity;
+    // a motor at a standstill draws current in proportion to its voltage, but wheels slipping draw only what the
+    // tiles take from them
+    const bool stuck = std::fabs(current) > settings.currentRatio * share * STALL_CURRENT || wheelSpeed >= slowest;
+    const bool stalled = std::fabs(power) >= settings.minPower && speed < slowest && stuck &&
+                         std::fabs(acceleration) < settings.maxAcceleration;
+    const int curTime = pros::millis();
+    if (!stalled) startTime = -1;
+    else if (startTime == -1) startTime = curTime;
+    else if (curTime >= startTime + settings.time) done = true;
+    return done;
+}
+
+/**
+ * @brief reset the stall detector timer
+ *
+ */
+void StallDetector::reset() {
+    startTime = -1;
+    done = false;
+}
+} // namespace lemlib
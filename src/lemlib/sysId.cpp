@@ -0,0 +1,300 @@
+/**
+ * @file src/lemlib/sysId.cpp
+ * @author LemLib Team
+ * @brief Logs of drivetrain characterization tests, and fitting feedforward constants to them
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <math.h>
+#include "lemlib/sysId.hpp"
+#include "lemlib/util.hpp"
+
+/** @brief first bytes of a log file */
+constexpr char MAGIC[4] = {'L', 'S', 'I', 'D'};
+/** @brief version of the file format, bumped whenever it changes */
+constexpr std::uint16_t VERSION = 1;
+constexpr std::size_t HEADER_SIZE = 12;
+constexpr std::size_t SAMPLE_SIZE = 18;
+/** @brief wheel speed below which the robot is treated as stopped, in inches per second */
+constexpr float MIN_VELOCITY = 0.5;
+/** @brief longest gap between the samples either side of one that still gives its acceleration, in ms */
+constexpr std::uint32_t MAX_GAP = 50;
+
+namespace {
+void putU16(std::uint8_t* out, std::uint16_t value) {
+    out[0] = value & 0xFF;
+    out[1] = value >> 8;
+}
+
+void putU32(std::uint8_t* out, std::uint32_t value) {
+    for (int i = 0; i < 4; i++) out[i] = (value >> (8 * i)) & 0xFF;
+}
+
+std::uint16_t getU16(const std::uint8_t* in) { return in[0] | in[1] << 8; }
+
+std::uint32_t getU32(const std::uint8_t* in) {
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; i++) value |= std::uint32_t(in[i]) << (8 * i);
+    return value;
+}
+
+/**
+ * @brief Round a value to fixed point, saturating instead of wrapping
+ *
+ * @param value the value
+ * @param scale how many steps make a unit
+ */
+std::uint16_t fixed(float value, float scale) {
+    return std::uint16_t(std::int16_t(std::clamp(roundf(value * scale), -32768.0f, 32767.0f)));
+}
+
+float unfixed(const std::uint8_t* in, float scale) { return std::int16_t(getU16(in)) / scale; }
+
+/** @brief one sample, reduced to the quantities of the model */
+struct Point {
+        float voltage;
+        float velocity;
+        float acceleration;
+};
+
+/**
+ * @brief Fit voltage = kS * sign(velocity) + kV * velocity + kA * acceleration
+ *
+ * Solves the normal equations, which are only 3x3, with Gaussian elimination. The sums are kept in doubles since
+ * they add up thousands of squares
+ *
+ * @param points the samples
+ */
+lemlib::SysIdModel fit(const std::vector<Point>& points) {
+    lemlib::SysIdModel model;
+    if (points.size() < 3) return model;
+    std::array<std::array<double, 4>, 3> system {};
+    double sum = 0;
+    for (const Point& point : points) {
+        const double row[3] = {double(lemlib::sgn(point.velocity)), point.velocity, point.acceleration};
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) system[i][j] += row[i] * row[j];
+            system[i][3] += row[i] * point.voltage;
+        }
+        sum += point.voltage;
+    }
+
+    // eliminate with partial pivoting, then substitute back
+    for (int col = 0; col < 3; col++) {
+        int pivot = col;
+        for (int row = col + 1; row < 3; row++) {
+            if (fabs(system[row][col]) > fabs(system[pivot][col])) pivot = row;
+        }
+        // without both directions or without accelerating, some constant can't be told apart from the others
+        if (fabs(system[pivot][col]) < 1e-9) return model;
+        std::swap(system[col], system[pivot]);
+        for (int row = col + 1; row < 3; row++) {
+            const double factor = system[row][col] / system[col][col];
+            for (int k = col; k < 4; k++) system[row][k] -= factor * system[col][k];
+        }
+    }
+    double solution[3];
+    for (int row = 2; row >= 0; row--) {
+        double value = system[row][3];
+        for (int k = row + 1; k < 3; k++) value -= system[row][k] * solution[k];
+        solution[row] = value / system[row][row];
+    }
+
+    // how much of the variation in voltage the fit explains
+    const double mean = sum / points.size();
+    double residual = 0;
+    double total = 0;
+    for (const Point& point : points) {
+        const double predicted = solution[0] * lemlib::sgn(point.velocity) + solution[1] * point.velocity +
+                                 solution[2] * point.acceleration;
+        residual += (point.voltage - predicted) * (point.voltage - predicted);
+        total += (point.voltage - mean) * (point.voltage - mean);
+    }
+    model.kS = solution[0];
+    model.kV = solution[1];
+    model.kA = solution[2];
+    model.rSquared = total > 0 ? 1 - residual / total : 0;
+    model.samples = points.size();
+    return model;
+}
+
+/**
+ * @brief Reduce the samples of some tests to points, with the acceleration from the samples either side
+ *
+ * @param samples the samples of the log
+ * @param first the first test to use
+ * @param last the last test to use
+ * @param minVelocity velocity below which the robot counts as stopped
+ * @param reduce gets the voltage and velocity of a sample
+ */
+template <typename F>
+std::vector<Point> collect(const std::vector<lemlib::SysIdSample>& samples, lemlib::SysIdTest first,
+                           lemlib::SysIdTest last, float minVelocity, F reduce) {
+    std::vector<Point> points;
+    for (std::size_t i = 1; i + 1 < samples.size(); i++) {
+        const lemlib::SysIdSample& prev = samples[i - 1];
+        const lemlib::SysIdSample& sample = samples[i];
+        const lemlib::SysIdSample& next = samples[i + 1];
+        if (sample.test < first || sample.test > last) continue;
+        if (prev.test != sample.test || next.test != sample.test) continue;
+        if (next.time <= prev.time || next.time - prev.time > MAX_GAP) continue;
+        Point point = reduce(sample);
+        if (fabsf(point.velocity) < minVelocity) continue;
+        point.acceleration = (reduce(next).velocity - reduce(prev).velocity) / ((next.time - prev.time) / 1000.0f);
+        points.push_back(point);
+    }
+    return points;
+}
+} // namespace
+
+/**
+ * @brief Construct an empty log
+ *
+ * @param trackWidth distance between the left and right wheels, in inches. Needed to fit the angular model
+ */
+lemlib::SysIdLog::SysIdLog(float trackWidth)
+    : trackWidth(trackWidth) {}
+
+/**
+ * @brief Add a sample to the end of the log
+ *
+ * @param sample the sample
+ */
+void lemlib::SysIdLog::add(const SysIdSample& sample) { samples.push_back(sample); }
+
+/**
+ * @brief Save the log
+ *
+ * @param path where to save it. Files on the SD card start with /usd/
+ * @return true if the whole log was written
+ */
+bool lemlib::SysIdLog::save(const char* path) const {
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) return false;
+    std::uint8_t header[HEADER_SIZE];
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    putU16(header + 4, VERSION);
+    putU16(header + 6, SAMPLE_SIZE);
+    std::uint32_t bits;
+    std::memcpy(&bits, &trackWidth, sizeof(bits));
+    putU32(header + 8, bits);
+    bool ok = fwrite(header, 1, HEADER_SIZE, file) == HEADER_SIZE;
+
+    // encode everything first, since the SD card is much faster with one big write than thousands of small ones
+    std::vector<std::uint8_t> data(samples.size() * SAMPLE_SIZE);
+    for (std::size_t i = 0; i < samples.size(); i++) {
+        const SysIdSample& sample = samples[i];
+        std::uint8_t* out = data.data() + i * SAMPLE_SIZE;
+        putU32(out, sample.time);
+        out[4] = std::uint8_t(sample.test);
+        out[5] = 0;
+        putU16(out + 6, fixed(sample.leftVoltage, 1000));
+        putU16(out + 8, fixed(sample.rightVoltage, 1000));
+        putU16(out + 10, fixed(sample.leftVelocity, 100));
+        putU16(out + 12, fixed(sample.rightVelocity, 100));
+        putU16(out + 14, fixed(sample.leftCurrent, 1000));
+        putU16(out + 16, fixed(sample.rightCurrent, 1000));
+    }
+    if (ok && !data.empty()) ok = fwrite(data.data(), 1, data.size(), file) == data.size();
+    return fclose(file) == 0 && ok;
+}
+
+/**
+ * @brief Load a log saved with save
+ *
+ * @param path the file
+ * @return true if the file was a log and was read, false leaves this log as it was
+ */
+bool lemlib::SysIdLog::load(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) return false;
+    std::uint8_t header[HEADER_SIZE];
+    if (fread(header, 1, HEADER_SIZE, file) != HEADER_SIZE || std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0 ||
+        getU16(header + 4) != VERSION || getU16(header + 6) != SAMPLE_SIZE) {
+        fclose(file);
+        return false;
+    }
+    const std::uint32_t bits = getU32(header + 8);
+    float width;
+    std::memcpy(&width, &bits, sizeof(width));
+
+    std::vector<SysIdSample> loaded;
+    std::uint8_t in[SAMPLE_SIZE];
+    while (fread(in, 1, SAMPLE_SIZE, file) == SAMPLE_SIZE) {
+        SysIdSample sample;
+        sample.time = getU32(in);
+        sample.test = SysIdTest(in[4]);
+        sample.leftVoltage = unfixed(in + 6, 1000);
+        sample.rightVoltage = unfixed(in + 8, 1000);
+        sample.leftVelocity = unfixed(in + 10, 100);
+        sample.rightVelocity = unfixed(in + 12, 100);
+        sample.leftCurrent = unfixed(in + 14, 1000);
+        sample.rightCurrent = unfixed(in + 16, 1000);
+        loaded.push_back(sample);
+    }
+    fclose(file);
+    trackWidth = width;
+    samples = std::move(loaded);
+    return true;
+}
+
+/**
+ * @brief Get the samples
+ *
+ * @return const std::vector<SysIdSample>&
+ */
+const std::vector<lemlib::SysIdSample>& lemlib::SysIdLog::getSamples() const { return samples; }
+
+/**
+ * @brief Get the track width the log was taken with
+ *
+ * @return float in inches
+ */
+float lemlib::SysIdLog::getTrackWidth() const { return trackWidth; }
+
+/**
+ * @brief Fit the feedforward model of driving straight, with least squares
+ *
+ * Uses the average of the two sides from the forward and backward tests. Acceleration is the change in velocity
+ * between the samples either side, and samples where the robot is barely moving are skipped, since static friction
+ * holds it still there rather than following the model.
+ *
+ * @param log the log
+ * @return SysIdModel velocity in inches per second
+ */
+lemlib::SysIdModel lemlib::fitLinear(const SysIdLog& log) {
+    auto reduce = [](const SysIdSample& sample) {
+        return Point {(sample.leftVoltage + sample.rightVoltage) / 2,
+                      (sample.leftVelocity + sample.rightVelocity) / 2, 0};
+    };
+    return fit(collect(log.getSamples(), SysIdTest::QUASISTATIC_FORWARD, SysIdTest::DYNAMIC_BACKWARD, MIN_VELOCITY,
+                       reduce));
+}
+
+/**
+ * @brief Fit the feedforward model of turning in place, with least squares
+ *
+ * Uses half the difference between the two sides from the turning tests, which is the angular output of a motion.
+ *
+ * @param log the log. Its track width must be set
+ * @return SysIdModel velocity in degrees per second, clockwise positive
+ */
+lemlib::SysIdModel lemlib::fitAngular(const SysIdLog& log) {
+    const float trackWidth = log.getTrackWidth();
+    if (trackWidth <= 0) return SysIdModel();
+    // the left side driving forwards turns the robot clockwise
+    auto reduce = [trackWidth](const SysIdSample& sample) {
+        return Point {(sample.leftVoltage - sample.rightVoltage) / 2,
+                      radToDeg((sample.leftVelocity - sample.rightVelocity) / trackWidth), 0};
+    };
+    return fit(collect(log.getSamples(), SysIdTest::QUASISTATIC_CLOCKWISE, SysIdTest::DYNAMIC_COUNTERCLOCKWISE,
+                       radToDeg(2 * MIN_VELOCITY / trackWidth), reduce));
+}
@@ -0,0 +1,115 @@
+#include "pros/rtos.hpp"
+#include "lemlib/timer.hpp"
+
+namespace lemlib {
+/**
+ * @brief Construct a new Timer
+ *
+ * @param time how long to wait, in milliseconds
+ */
+Timer::Timer(uint32_t time)
+    : period(time) {
+    lastTime = pros::millis();
+}
+
+/**
+ * @brief Get the amount of time the timer was set to
+ *
+ * @return uint32_t time, in milliseconds
+ */
+uint32_t Timer::getTimeSet() {
+    const uint32_t time = pros::millis(); // get time from RTOS
+    if (!paused) timeWaited += time - lastTime; // don't update if paused
+    lastTime = time; // update last time
+    return period;
+}
+
+/**
+ * @brief Get the amount of time left on the timer
+ *
+ * @return uint32_t time in milliseconds
+ */
+uint32_t Timer::getTimeLeft() {
+    const uint32_t time = pros::millis(); // get time from RTOS
+    if (!paused) timeWaited += time - lastTime; // don't update if paused
+    lastTime = time; // update last time
+    const int delta = period - timeWaited; // calculate how much time is left
+    return (delta > 0) ? delta : 0; // return 0 if timer is done
+}
+
+/**
+ * @brief Get the amount of time passed on the timer
+ *
+ * @return uint32_t time in milliseconds
+ */
+uint32_t Timer::getTimePassed() {
+    const uint32_t time = pros::millis(); // get time from RTOS
+    if (!paused) timeWaited += time - lastTime; // don't update if paused
+    lastTime = time; // update last time;
+    return timeWaited;
+}
+
+/**
+ * @brief Get whether the timer is done or not
+ *
+ * @return true the timer is done
+ * @return false the timer is not done
+ */
+bool Timer::isDone() {
+    const uint32_t time = pros::millis(); // get time from RTOS
+    if (!paused) timeWaited += time - lastTime; // don't update if paused
+    lastTime = time; // update last time
+    const int delta = period - timeWaited; // calculate how much time is left
+    return delta <= 0;
+}
+
+/**
+ * @brief Set the amount of time the timer should count down. Resets the timer
+ *
+ * @param time time in milliseconds
+ */
+void Timer::set(uint32_t time) {
+    period = time; // set how long to wait
+    reset();
+}
+
+/**
+ * @brief reset the timer
+ *
+ */
+void Timer::reset() {
+    timeWaited = 0;
+    lastTime = pros::millis();
+}
+
+/**
+ * @brief pause the timer
+ *
+ */
+void Timer::pause() {
+    if (!paused) {
+        const uint32_t time = pros::millis(); // get time from RTOS
+        timeWaited += time - lastTime; // count the time waited before pausing
+        lastTime = time;
+    }
+    paused = true;
+}
+
+/**
+ * @brief resume the timer
+ *
+ */
+void Timer::resume() {
+    if (paused) lastTime = pros::millis();
+    paused = false;
+}
+
+/**
+ * @brief wait
+ *
+ */
+void Timer::waitUntilDone() {
+    do pros::delay(5);
+    while (!this->isDone());
+}
+} // namespace lemlib
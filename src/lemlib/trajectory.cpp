@@ -0,0 +1,158 @@
+/**
+ * @file src/lemlib/trajectory.cpp
+ * @author LemLib Team
+ * @brief Time-parameterized trajectories along a path, planned at the limits of the drivetrain
+ * @version 0.4.5
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <algorithm>
+#include <math.h>
+#include "lemlib/trajectory.hpp"
+
+/**
+ * @brief Plan a trajectory along a path
+ *
+ * @param path the points of the path. Theta is ignored
+ * @param trackWidth distance between the left and right wheels, in inches
+ * @param constraints the limits. The max velocity must be set
+ */
+lemlib::Trajectory::Trajectory(const std::vector<Pose>& path, float trackWidth, TrajectoryConstraints constraints) {
+    points.reserve(path.size());
+    for (const Pose& pose : path) points.push_back({0, 0, pose.x, pose.y, 0, 0, 0, 0});
+    const std::size_t count = points.size();
+    if (count < 2) return;
+
+    // distance along the path, heading from the neighbouring points, and curvature of the circle through them
+    for (std::size_t i = 1; i < count; i++) {
+        const TrajectoryPoint& prev = points[i - 1];
+        points[i].distance = prev.distance + hypotf(points[i].x - prev.x, points[i].y - prev.y);
+    }
+    for (std::size_t i = 0; i < count; i++) {
+        const TrajectoryPoint& prev = points[i == 0 ? 0 : i - 1];
+        const TrajectoryPoint& next = points[i + 1 == count ? i : i + 1];
+        points[i].theta = atan2f(next.y - prev.y, next.x - prev.x);
+        if (i == 0 || i + 1 == count) continue;
+        const TrajectoryPoint& point = points[i];
+        const float cross = (point.x - prev.x) * (next.y - point.y) - (point.y - prev.y) * (next.x - point.x);
+        const float chord = hypotf(next.x - prev.x, next.y - prev.y);
+        const float sides = (point.distance - prev.distance) * (next.distance - point.distance) * chord;
+        points[i].curvature = sides > 0 ? 2 * cross / sides : 0;
+    }
+    points.front().curvature = points[1].curvature;
+    points.back().curvature = points[count - 2].curvature;
+
+    // the outer wheel of a turn goes faster and accelerates harder than the middle of the robot, by this much
+    auto outerWheel = [trackWidth](float curvature) { return 1 + fabsf(curvature) * trackWidth / 2; };
+
+    // fastest velocity at each point, from how sharply the path turns there
+    for (TrajectoryPoint& point : points) {
+        point.velocity = constraints.maxVelocity / outerWheel(point.curvature);
+        if (constraints.maxCentripetal > 0 && point.curvature != 0) {
+            point.velocity = std::min(point.velocity, sqrtf(constraints.maxCentripetal / fabsf(point.curvature)));
+        }
+    }
+
+    // forward pass: start from rest and accelerate as hard as the wheels allow
+    points.front().velocity = 0;
+    for (std::size_t i = 0; i + 1 < count; i++) {
+        const float distance = points[i + 1].distance - points[i].distance;
+        const float acceleration = constraints.maxAcceleration / outerWheel(points[i].curvature);
+        const float reachable = sqrtf(points[i].velocity * points[i].velocity + 2 * acceleration * distance);
+        points[i + 1].velocity = std::min(points[i + 1].velocity, reachable);
+    }
+
+    // backward pass: end at rest, decelerating as hard as the wheels allow
+    points.back().velocity = 0;
+    for (std::size_t i = count - 1; i > 0; i--) {
+        const float distance = points[i].distance - points[i - 1].distance;
+        const float acceleration = constraints.maxAcceleration / outerWheel(points[i].curvature);
+        const float stoppable = sqrtf(points[i].velocity * points[i].velocity + 2 * acceleration * distance);
+        points[i - 1].velocity = std::min(points[i - 1].velocity, stoppable);
+    }
+
+    // the acceleration between two points is constant, so the time between them follows from the average velocity
+    for (std::size_t i = 0; i + 1 < count; i++) {
+        TrajectoryPoint& point = points[i];
+        const TrajectoryPoint& next = points[i + 1];
+        const float distance = next.distance - point.distance;
+        const float velocity = point.velocity + next.velocity;
+        if (distance == 0) {
+            // repeated point, reached at the same time
+            points[i + 1].time = point.time;
+        } else if (velocity > 0) {
+            point.acceleration = (next.velocity * next.velocity - point.velocity * point.velocity) / (2 * distance);
+            points[i + 1].time = point.time + 2 * distance / velocity;
+        } else {
+            // a path of a single segment starts and ends at rest, so it accelerates for half of it then slows down
+            points[i + 1].time = point.time + 2 * sqrtf(distance / (constraints.maxAcceleration / outerWheel(0)));
+        }
+    }
+}
+
+/**
+ * @brief Get where the trajectory is at a given time, between its points
+ *
+ * @param time time since the start of the trajectory, in seconds
+ * @return TrajectoryPoint the first point before the start, the last point after the end
+ */
+lemlib::TrajectoryPoint lemlib::Trajectory::sample(float time) const {
+    if (points.empty()) return {0, 0, 0, 0, 0, 0, 0, 0};
+    if (time <= 0) return points.front();
+    if (time >= points.back().time) return points.back();
+
+    // find the last point at or before the time
+    const auto next = std::upper_bound(points.begin(), points.end(), time,
+                                       [](float time, const TrajectoryPoint& point) { return time < point.time; });
+    const TrajectoryPoint& point = *(next - 1);
+    const float t = time - point.time;
+    const float length = next->distance - point.distance;
+    TrajectoryPoint result = point;
+    result.time = time;
+    float fraction;
+    if (point.velocity + next->velocity > 0) {
+        result.velocity = point.velocity + point.acceleration * t;
+        fraction = (point.velocity * t + point.acceleration * t * t / 2) / length;
+    } else {
+        fraction = t / (next->time - point.time);
+    }
+    fraction = std::clamp(fraction, 0.0f, 1.0f);
+    result.distance = point.distance + length * fraction;
+    result.x = point.x + (next->x - point.x) * fraction;
+    result.y = point.y + (next->y - point.y) * fraction;
+    result.theta = point.theta + remainderf(next->theta - point.theta, 2 * M_PI) * fraction;
+    result.curvature = point.curvature + (next->curvature - point.curvature) * fraction;
+    return result;
+}
+
+/**
+ * @brief Get one of the points of the trajectory
+ *
+ * @param index the index, which matches the index of the point in the path
+ * @return const TrajectoryPoint&
+ */
+const lemlib::TrajectoryPoint& lemlib::Trajectory::at(std::size_t index) const { return points.at(index); }
+
+/**
+ * @brief Get the number of points
+ *
+ * @return std::size_t
+ */
+std::size_t lemlib::Trajectory::size() const { return points.size(); }
+
+/**
+ * @brief Get how long the trajectory takes
+ *
+ * @return float in seconds
+ */
+float lemlib::Trajectory::getDuration() const { return points.empty() ? 0 : points.back().time; }
+
+/**
+ * @brief Get the length of the path
+ *
+ * @return float in inches
+ */
+float lemlib::Trajectory::getLength() const { return points.empty() ? 0 : points.back().distance; }
@@ -1,5 +1,6 @@
 #include "main.h"
 #include "lemlib/api.hpp"
+#include "lemlib/chassis/odom.hpp"
 
 // controller
 pros::Controller controller(pros::E_CONTROLLER_MASTER); // controller, name: controller
@@ -49,7 +50,7 @@ lemlib::Omniwheel::NEW_325, // using new 3.25" omnis
 8 // chase power is 2. If we had traction wheels, it would have been 8
 );
 
-// just remember kP + 2, then kD + 5 until its accurate then repeat
+// kS, kV and kA can be measured with SysIdAuton, then tune kP and kD on top with PIDTune
 // lateral motion controller
 // lateral motion controller
 lemlib::ControllerSettings linearController(16, // proportional gain (kP) 24
@@ -60,7 +61,10 @@ lemlib::ControllerSettings linearController(16, // proportional gain (kP) 24
                                              75, // small error range timeout, in milliseconds
                                              3, // large error range, in degrees
                                              200, // large error range timeout, in milliseconds
-                                             0 // maximum acceleration (slew)
+                                             0, // maximum acceleration (slew)
+                                             2.5, // velocity feedforward (kV), 127 / 51 in/s free speed
+                                             0.27, // acceleration feedforward (kA)
+                                             1.5 // static feedforward (kS), to overcome rolling resistance
 );
 
 // angular motion controller
@@ -72,10 +76,28 @@ lemlib::ControllerSettings angularController(4, // proportional gain (kP)
                                              75, // small error range timeout, in milliseconds
                                              3, // large error range, in degrees
                                              200, // large error range timeout, in milliseconds
-                                             0 // maximum acceleration (slew)
-
+                                             0, // maximum acceleration (slew)
+                                             0, // velocity feedforward (kV), unused by turns
+                                             0, // acceleration feedforward (kA), unused by turns
+                                             8 // static feedforward (kS), to overcome the wheels scrubbing
 );
 
+// example gain schedules, looked up by how far off the robot is. Small corrections get more kP and kD than the big
+// moves can take without overshooting. These were only tuned in the sim, so initialize doesn't use them. To try them,
+// call chassis.setGainSchedules(lateralSchedule, angularSchedule) in simSettings
+constexpr lemlib::GainPoint lateralSchedule[] = {
+    // error (in), kP, kI, kD, kS
+    {3, 24, 0, 20, 1.5},
+    {12, 16, 0, 15, 1.5},
+};
+constexpr lemlib::GainPoint angularSchedule[] = {
+    // error (deg), kP, kI, kD, kS
+    {5, 8, 0, 40, 7},
+    {30, 4, 0, 35, 7},
+};
+static_assert(lemlib::GainSchedule(lateralSchedule).isSorted() && lemlib::GainSchedule(angularSchedule).isSorted(),
+              "gain schedule keys have to go up");
+
 // sensors for odometry
 // note that in this example we use internal motor encoders (IMEs), so we don't pass vertical tracking wheels
 lemlib::OdomSensors sensors(
@@ -86,6 +108,12 @@ nullptr, // horizontal tracking wheel 2, set to nullptr as we don't have a secon
 &imu // inertial sensor
 );
 
+// example drive curve for driver control, baked into a table at compile time. The stick ignores the first 5 of drift,
+// and just past that drives at 10, so a nudge already moves the robot. The rest stays linear. This changes how the
+// robot feels to drive, so initialize doesn't use it. To try it, call chassis.setDriveCurve(driverCurve)
+constexpr lemlib::DriveCurveTable driverCurve(lemlib::ExpoCurve {0}, {5, 10});
+static_assert(driverCurve.at(5) == 0 && driverCurve.at(127) == 127, "the drive curve has to stop and reach full power");
+
 // create the chassis
 lemlib::Chassis chassis(drivetrain, linearController, angularController, sensors);
 
@@ -97,6 +125,34 @@ lemlib::Chassis chassis(drivetrain, linearController, angularController, sensors
  * once per time.
  */
 
+ // characterize the drivetrain for the feedforward constants. Needs about 4 feet clear in front of the robot.
+ // Fit the log on a computer with: sim/bin/sysid-fit sysid.bin
+ void SysIdAuton(const char* path = "/usd/sysid.bin"){
+    controller.set_text(0, 0, chassis.characterize(path) ? "sysid saved" : "sysid failed");
+ }
+
+ // tune the PIDs with relay feedback, then check them with a 90 degree turn and a 24 inch drive. Needs about 4 feet
+ // clear in front of the robot. The gains are saved, and initialize loads them on the next run
+ void AutotuneAuton(const char* path = "/usd/gains.txt"){
+    lemlib::AutotuneSettings angular;
+    angular.relayPower = 40;
+    angular.hysteresis = 2;
+    angular.testDistance = 90;
+    const lemlib::AutotuneResult turn = chassis.autotuneAngular(angular);
+    lemlib::AutotuneSettings lateral;
+    lateral.relayPower = 40;
+    lateral.hysteresis = 1;
+    lateral.testDistance = 24;
+    const lemlib::AutotuneResult drive = turn.success ? chassis.autotuneLateral(lateral) : lemlib::AutotuneResult();
+    for (const lemlib::AutotuneResult* result : {&turn, &drive}) {
+        printf("%s: Ku %.3f Tu %.3fs kP %.3f kI %.4f kD %.3f, settled in %.0fms, overshoot %.2f\n",
+               result == &turn ? "angular" : "lateral", result->ultimateGain, result->ultimatePeriod,
+               result->gains.kP, result->gains.kI, result->gains.kD, result->settleTime, result->overshoot);
+    }
+    const bool saved = turn.success && drive.success && chassis.saveGains(path);
+    controller.set_text(0, 0, saved ? "gains saved" : "autotune failed");
+ }
+
  void PIDTune(){
     // first cycle
     chassis.setPose(0, 0, 0);
@@ -121,8 +177,7 @@ lemlib::Chassis chassis(drivetrain, linearController, angularController, sensors
     chassis.moveToPose(6, -3, 305, 3000);
 
     // front wings in
-    chassis.waitUntil(10);
-    frontWingsR.set_value(false);
+    chassis.atDistance(10, [] { frontWingsR.set_value(false); });
 
     // stop intake
     chassis.waitUntilDone();
@@ -150,8 +205,7 @@ lemlib::Chassis chassis(drivetrain, linearController, angularController, sensors
     chassis.moveToPose(42, -42, 135, 3000);
 
     // intake out the triball in middle
-    chassis.waitUntil(8);
-    intake.move(-127);
+    chassis.atDistance(8, [] { intake.move(-127); });
 
     // intake in the bottom triball from the bottom, but not under bar.
     chassis.waitUntilDone();
@@ -176,7 +230,7 @@ lemlib::Chassis chassis(drivetrain, linearController, angularController, sensors
 
     // get matchload out
     chassis.turnTo(63, -30, 9000);
-    backWingsR.set_value(true);
+    chassis.atDistance(0, [] { backWingsR.set_value(true); });
 
     // turn back to get the triballs in range to score
     chassis.turnTo(68, -35, 9000, false);
@@ -266,6 +320,8 @@ void SkillsAuton(){
     cata.brake();
     chassis.moveToPose(-60, -30, 65, 300);
     chassis.moveToPose(-35, -37, 90, 800, {.forwards = false});
+    // motions queue without blocking, so wait for this one to start
+    chassis.waitUntil(0);
 
     //disable the cata arm from holding
     pros::millis();
@@ -279,14 +335,18 @@ void SkillsAuton(){
 
     //move across middle bar
     chassis.moveToPose(-7.4, 49, 0, 2800, {.forwards = false});
-    cata.brake();
-    backWingsL.set_value(true);
-    backWingsR.set_value(true);
+    chassis.atDistance(0, [] {
+        cata.brake();
+        backWingsL.set_value(true);
+        backWingsR.set_value(true);
+    });
 
     //chassis go to in front of the blue hang, at matchload side
     chassis.moveToPose(-50, 49, 90, 1800);
-    backWingsL.set_value(false);
-    backWingsR.set_value(false);
+    chassis.atDistance(0, [] {
+        backWingsL.set_value(false);
+        backWingsR.set_value(false);
+    });
 
     //chassis go right before blue hang
     chassis.waitUntilDone();
@@ -310,10 +370,11 @@ void SkillsAuton(){
 
     //chassis turn to corner triballs at red side blue hang
     chassis.moveToPose(-8.5, 33, -90, 2000);
-    chassis.waitUntil(10);
-    intake.move(127);
-    frontWingsR.set_value(true);
-    intake.brake();
+    chassis.atDistance(10, [] {
+        intake.move(127);
+        frontWingsR.set_value(true);
+        intake.brake();
+    });
 
     //chassis sweep some middle balls (in order not to get stuck when going back)
     chassis.moveToPose(-8.5, 16, 0, 3000);
@@ -333,7 +394,7 @@ void SkillsAuton(){
 
     //chassis to down from score side
     chassis.moveToPose(-9, -12, 180, 1000, {.forwards = false});
-    backWingsR.set_value(true);
+    chassis.atDistance(0, [] { backWingsR.set_value(true); });
 
     //chassis swing turn (at least as close as i cam get it) to push all the triballs (tommy skills)
     chassis.waitUntilDone();
@@ -367,6 +428,8 @@ void initialize() {
     imu.tare();
     chassis.calibrate(); // calibrate sensors
     chassis.setPose(0,0,0);
+    // use the gains AutotuneAuton found, if it has been run. Otherwise keep the ones in the controller settings
+    chassis.loadGains("/usd/gains.txt");
 
     cata.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
     leftMotors.set_brake_modes(pros::E_MOTOR_BRAKE_COAST);
@@ -387,18 +450,43 @@ void initialize() {
     pros::Task screenTask([&]() {
         lemlib::Pose pose(0, 0, 0);
         while (true) {
+            // read the pose once, so x, y and theta are from the same update
+            const lemlib::ChassisState state = chassis.getState();
+            pose = lemlib::Pose(state.pose.x, state.pose.y, lemlib::radToDeg(state.pose.theta));
             // print robot location to the brain screen
-            pros::lcd::print(0, "X: %f", chassis.getPose().x); // x
-            pros::lcd::print(1, "Y: %f", chassis.getPose().y); // y
-            pros::lcd::print(2, "Theta: %f", chassis.getPose().theta); // heading
+            pros::lcd::print(0, "X: %f", pose.x); // x
+            pros::lcd::print(1, "Y: %f", pose.y); // y
+            pros::lcd::print(2, "Theta: %f", pose.theta); // heading
             // log position telemetry
-            lemlib::telemetrySink()->info("Chassis pose: {}", chassis.getPose());
+            lemlib::telemetrySink()->info("Chassis pose: {}", pose);
             // delay to save resources
             pros::delay(50);
         }
     });
 }
 
+/**
+ * Settings that have only been tuned in the sim, so initialize leaves the robot on the defaults. The sim calls this
+ * after initialize. To try them on the robot, call it at the end of initialize
+ */
+void simSettings() {
+    lemlib::setUpdatePeriod(5); // run odometry at 200 Hz
+    // profile lateral motions: 50 in/s, 250 in/s^2, 2500 in/s^3
+    chassis.setLateralProfile({50, 250, 2500});
+    // plan paths at 45 in/s and 250 in/s^2 per wheel, 200 in/s^2 sideways, leaving RAMSETE room to correct
+    chassis.setPathConstraints({45, 250, 200});
+    chassis.setRamseteSettings({0.003, 0.7, 5});
+    // carry speed through the corners between queued moveToPose and moveToPoint calls
+    chassis.setChainSettings({6, 90});
+    // end a motion once the robot has been pushing against a wall or a goal for 60 ms
+    chassis.setStallSettings({60});
+    // end turns and moves once the robot has stopped on target: 20 ms below 3 in/s or 15 deg/s
+    chassis.setSettleSettings({20, 3, 3}, {20, 15, 15});
+    // time the PIDs by the measured loop period, low-pass their derivatives at 25 Hz and limit them to what the motors
+    // take. Derivative on measurement is left off, since moves need the derivative of the moving carrot
+    chassis.setPIDSettings({0.01, 25, false, 127}, {0.01, 25, false, 127});
+}
+
 /**
  * Runs while the robot is disabled
  */
@@ -420,6 +508,8 @@ void competition_initialize() {}
  */
 void autonomous() {
     // PIDTune();
+    // SysIdAuton();
+    // AutotuneAuton();
     // FarSideAuton(); //this is the one that scores in the net, the 5 ball
     // CloseSideAuton(); //this is the one that doesn't score, the winpoint.
     SkillsAuton();
@@ -434,67 +524,60 @@ void opcontrol() {
     bool toggleBackWings = false;
     bool togglePTO = false;
     bool toggleRatchet = false;
-    // controller
+    // read the controller once a loop, and toggle the pneumatics as their buttons are pressed, without holding up the
+    // drive until the button is let go
+    lemlib::InputManager input(controller);
+    // shift back wings
+    input.bind(pros::E_CONTROLLER_DIGITAL_A, lemlib::ButtonEvent::PRESS, [&] {
+        toggleBackWings = !toggleBackWings;
+        backWingsL.set_value(toggleBackWings);
+        backWingsR.set_value(toggleBackWings);
+    });
+    // shift wings
+    input.bind(pros::E_CONTROLLER_DIGITAL_B, lemlib::ButtonEvent::PRESS, [&] {
+        toggleFrontWings = !toggleFrontWings;
+        frontWingsL.set_value(toggleFrontWings);
+        frontWingsR.set_value(toggleFrontWings);
+    });
+    // shift pto
+    input.bind(pros::E_CONTROLLER_DIGITAL_X, lemlib::ButtonEvent::PRESS, [&] {
+        togglePTO = !togglePTO;
+        pto.set_value(togglePTO);
+    });
+    // shift ratchet
+    input.bind(pros::E_CONTROLLER_DIGITAL_Y, lemlib::ButtonEvent::PRESS, [&] {
+        toggleRatchet = !toggleRatchet;
+        ratchet.set_value(toggleRatchet);
+    });
     // loop to continuously update motors
     while (true) {
+        // read the buttons and run the toggles
+        input.update();
+
         // get joystick positions
         int leftY = controller.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y);
         int rightX = controller.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y);
         // move the chassis with curvature drive
         chassis.tank(leftY, rightX);
 
-		// move the catapult/lift
-		if(controller.get_digital(pros::E_CONTROLLER_DIGITAL_L1)){
-			cata.move(127);
-		}
-		else if(controller.get_digital(pros::E_CONTROLLER_DIGITAL_L2)){
-			cata.move(-127);
-		}
-		else{
-			cata.brake();
-		}
-
-		// move the intake
-		if(controller.get_digital(pros::E_CONTROLLER_DIGITAL_R1)){
-			intake.move(127);
-		}
-		else if(controller.get_digital(pros::E_CONTROLLER_DIGITAL_R2)){
-			intake.move(-127);
-        }
-		else{
-			intake.brake();
-		}   
-
-        //shift back wings
-        if(controller.get_digital(pros::E_CONTROLLER_DIGITAL_A)){
-            toggleBackWings = !toggleBackWings;
-            backWingsL.set_value(toggleBackWings);
-            backWingsR.set_value(toggleBackWings);
-            pros::delay(500);
-        }
-
-        //shift wings
-        if(controller.get_digital(pros::E_CONTROLLER_DIGITAL_B)){
-            toggleFrontWings = !toggleFrontWings;
-            frontWingsL.set_value(toggleFrontWings);
-            frontWingsR.set_value(toggleFrontWings);
-            pros::delay(500);
+        // move the catapult/lift
+        if (input.isDown(pros::E_CONTROLLER_DIGITAL_L1)) {
+            cata.move(127);
+        } else if (input.isDown(pros::E_CONTROLLER_DIGITAL_L2)) {
+            cata.move(-127);
+        } else {
+            cata.brake();
         }
 
-        //shift pto
-        if(controller.get_digital(pros::E_CONTROLLER_DIGITAL_X)){
-            togglePTO = !togglePTO;
-            pto.set_value(togglePTO);
-            pros::delay(500);
+        // move the intake
+        if (input.isDown(pros::E_CONTROLLER_DIGITAL_R1)) {
+            intake.move(127);
+        } else if (input.isDown(pros::E_CONTROLLER_DIGITAL_R2)) {
+            intake.move(-127);
+        } else {
+            intake.brake();
         }
 
-        //shift ratchet
-        if(controller.get_digital(pros::E_CONTROLLER_DIGITAL_Y)){
-            toggleRatchet = !toggleRatchet;
-            ratchet.set_value(toggleRatchet);
-            pros::delay(500);
-        }
-        
         // delay to save resources
         pros::delay(10);
     }